@@ -138,7 +138,7 @@ float3 CAICheats::GetUnitVelocity(int unitId) const
 }
 
 
-static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int unitIds_max, bool (*includeUnit)(CUnit*) = NULL)
+static int FilterUnitsVector(const CQuadField::UnitVector& units, int* unitIds, int unitIds_max, bool (*includeUnit)(CUnit*) = NULL)
 {
 	int a = 0;
 
@@ -147,7 +147,7 @@ static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int
 		unitIds_max = MAX_UNITS;
 	}
 
-	std::vector<CUnit*>::const_iterator ui;
+	CQuadField::UnitVector::const_iterator ui;
 	for (ui = units.begin(); (ui != units.end()) && (a < unitIds_max); ++ui) {
 		CUnit* u = *ui;
 
@@ -206,7 +206,7 @@ int CAICheats::GetEnemyUnits(int* unitIds, int unitIds_max)
 
 int CAICheats::GetEnemyUnits(int* unitIds, const float3& pos, float radius, int unitIds_max)
 {
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
+	const CQuadField::UnitVector& units = quadField->GetUnitsExact(pos, radius);
 	myAllyTeamId = teamHandler->AllyTeam(ai->GetTeamId());
 	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsEnemy);
 }
@@ -218,7 +218,7 @@ int CAICheats::GetNeutralUnits(int* unitIds, int unitIds_max)
 
 int CAICheats::GetNeutralUnits(int* unitIds, const float3& pos, float radius, int unitIds_max)
 {
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
+	const CQuadField::UnitVector& units = quadField->GetUnitsExact(pos, radius);
 	return FilterUnitsVector(units, unitIds, unitIds_max, &unit_IsNeutral);
 }
 
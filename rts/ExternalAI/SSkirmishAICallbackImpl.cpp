@@ -4061,14 +4061,14 @@ EXPORT(int) skirmishAiCallback_getFeaturesIn(int skirmishAIId, float* pos_posF3,
 
 	if (skirmishAiCallback_Cheats_isEnabled(skirmishAIId)) {
 		// cheating
-		const std::vector<CFeature*>& fset = quadField->GetFeaturesExact(pos_posF3, radius);
+		const CQuadField::FeatureVector& fset = quadField->GetFeaturesExact(pos_posF3, radius);
 		const int featureIds_sizeReal = fset.size();
 
 		int featureIds_size = featureIds_sizeReal;
 
 		if (featureIds != NULL) {
 			featureIds_size = min(featureIds_sizeReal, featureIds_sizeMax);
-			std::vector<CFeature*>::const_iterator it;
+			CQuadField::FeatureVector::const_iterator it;
 			size_t f = 0;
 			for (it = fset.begin(); it != fset.end() && f < featureIds_size; ++it) {
 				CFeature* feature = *it;
@@ -17,10 +17,11 @@ CSkirmishAI::CSkirmishAI(int skirmishAIId, int teamId, const SkirmishAIKey& key,
 		timerName("AI t:" + IntToString(teamId) +
 		          " id:" + IntToString(skirmishAIId) +
 		          " " + key.GetShortName() + " " + key.GetVersion()),
+		timerScopeID(CTimeProfiler::GetScopeID(timerName)),
 		initOk(false),
 		dieing(false)
 {
-	SCOPED_TIMER(timerName.c_str());
+	ScopedTimer timer(timerName.c_str(), timerScopeID);
 	library = IAILibraryManager::GetInstance()->FetchSkirmishAILibrary(key);
 	if (library == NULL) {
 		dieing = true;
@@ -31,7 +32,7 @@ CSkirmishAI::CSkirmishAI(int skirmishAIId, int teamId, const SkirmishAIKey& key,
 
 CSkirmishAI::~CSkirmishAI() {
 
-	SCOPED_TIMER(timerName.c_str());
+	ScopedTimer timer(timerName.c_str(), timerScopeID);
 	if (initOk) {
 		library->Release(skirmishAIId);
 	}
@@ -52,7 +53,7 @@ void CSkirmishAI::Dieing() {
 
 int CSkirmishAI::HandleEvent(int topic, const void* data) const {
 
-	SCOPED_TIMER(timerName.c_str());
+	ScopedTimer timer(timerName.c_str(), timerScopeID);
 	if (!dieing || (topic == EVENT_RELEASE)) {
 		return library->HandleEvent(skirmishAIId, topic, data);
 	} else {
@@ -48,6 +48,8 @@ private:
 	const CSkirmishAILibrary* library;
 	const SSkirmishAICallback* callback;
 	const std::string timerName;
+	/// trace scope-ID of timerName, interned once instead of per event
+	const unsigned timerScopeID;
 	bool initOk;
 	bool dieing;
 };
@@ -0,0 +1,171 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "AssetPreloader.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Lua/LuaParser.h"
+#include "Rendering/Models/IModelParser.h"
+#include "Rendering/Models/s3o.h"
+#include "System/ThreadPool.h"
+#include "System/Util.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/VFSHandler.h"
+#include "System/FileSystem/Archives/FileView.h"
+#include "System/Log/ILog.h"
+
+
+CAssetPreloader::CAssetPreloader()
+	: numTasks(0)
+	, numFiles(0)
+	, numBytes(0)
+	, startTime(spring_notime)
+{
+}
+
+CAssetPreloader::~CAssetPreloader()
+{
+	// the tasks read through vfsHandler, which must outlive them
+	Wait();
+}
+
+
+void CAssetPreloader::Start(LuaParser* defsParser)
+{
+#ifdef THREADPOOL
+	// nothing to overlap with if the load thread would have to do it all itself
+	if (!ThreadPool::HasThreads())
+		return;
+
+	// Lua is not thread-safe, collect the names up front
+	std::set<std::string> names;
+	std::vector<std::string> defNames;
+
+	const LuaTable unitDefsTable = defsParser->GetRoot().SubTable("UnitDefs");
+	const LuaTable featureDefsTable = defsParser->GetRoot().SubTable("FeatureDefs");
+
+	unitDefsTable.GetKeys(defNames);
+
+	for (unsigned int n = 0; n < defNames.size(); n++) {
+		names.insert(StringToLower(unitDefsTable.SubTable(defNames[n]).GetString("objectName", "")));
+	}
+
+	defNames.clear();
+	featureDefsTable.GetKeys(defNames);
+
+	for (unsigned int n = 0; n < defNames.size(); n++) {
+		names.insert(StringToLower(featureDefsTable.SubTable(defNames[n]).GetString("object", "")));
+	}
+
+	names.erase("");
+
+	if (names.empty())
+		return;
+
+	modelNames.assign(names.begin(), names.end());
+	C3DModelLoader::GetFormats(modelFormats);
+
+	// leave half of the workers to the loading stages that use for_mt
+	numTasks = std::max(1, ThreadPool::GetNumThreads() / 2);
+	numTasks = std::min(numTasks, modelNames.size());
+	startTime = spring_gettime();
+
+	tasks = std::make_shared<PreloadTaskGroup>(numTasks);
+
+	for (size_t n = 0; n < numTasks; n++) {
+		const std::function<void()> task = std::bind(&CAssetPreloader::PreloadModels, this, n);
+		tasks->enqueue(task);
+	}
+
+	ThreadPool::PushTaskGroup(tasks);
+	ThreadPool::NotifyWorkerThreads();
+#endif
+}
+
+void CAssetPreloader::Wait()
+{
+#ifdef THREADPOOL
+	if (tasks == NULL)
+		return;
+
+	ThreadPool::WaitForFinished(tasks);
+	tasks.reset();
+
+	LOG("[AssetPreloader::%s] read %u files (%.1fMB) for %u models in %ims", __FUNCTION__,
+		numFiles.load(), numBytes.load() / (1024.0f * 1024.0f), (unsigned int) modelNames.size(),
+		int(spring_tomsecs(spring_gettime() - startTime)));
+#endif
+}
+
+
+void CAssetPreloader::PreloadModels(size_t firstModel)
+{
+	for (size_t n = firstModel; n < modelNames.size(); n += numTasks) {
+		PreloadModel(modelNames[n]);
+	}
+}
+
+void CAssetPreloader::PreloadModel(const std::string& modelName)
+{
+	// same search as the model loader, which does not exist yet at this point
+	const std::string& modelPath = C3DModelLoader::FindModelPath(modelName, modelFormats);
+
+	CFileView view;
+
+	if (modelPath.empty() || !ReadFile(modelPath, view))
+		return;
+
+	if (FileSystem::GetExtension(modelPath) != "s3o")
+		return;
+	if (view.GetSize() < sizeof(S3OHeader))
+		return;
+
+	// the textures depend on the model, their names are in its header
+	S3OHeader header;
+	memcpy(&header, view.GetData(), sizeof(header));
+	header.swap();
+
+	const int texOffsets[2] = {header.texture1, header.texture2};
+
+	for (int i = 0; i < 2; i++) {
+		if (texOffsets[i] <= 0 || size_t(texOffsets[i]) >= view.GetSize())
+			continue;
+
+		const char* texName = reinterpret_cast<const char*>(view.GetData() + texOffsets[i]);
+		const size_t maxLength = view.GetSize() - texOffsets[i];
+
+		PreloadTexture(std::string(texName, strnlen(texName, maxLength)));
+	}
+}
+
+void CAssetPreloader::PreloadTexture(const std::string& textureName)
+{
+	if (textureName.empty())
+		return;
+
+	{
+		// most textures are shared by several models
+		boost::mutex::scoped_lock lock(textureMutex);
+
+		if (!textureNames.insert(StringToLower(textureName)).second)
+			return;
+	}
+
+	// same lookup order as CS3OTextureHandler::LoadS3OTexture
+	CFileView view;
+
+	if (!ReadFile(textureName, view))
+		ReadFile("unittextures/" + textureName, view);
+}
+
+
+bool CAssetPreloader::ReadFile(const std::string& filePath, CFileView& view)
+{
+	if (!vfsHandler->LoadFile(filePath, view))
+		return false;
+
+	numFiles += 1;
+	numBytes += view.GetSize();
+	return true;
+}
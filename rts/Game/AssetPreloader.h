@@ -0,0 +1,70 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _ASSET_PRELOADER_H
+#define _ASSET_PRELOADER_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "System/Misc/SpringTime.h"
+
+class LuaParser;
+class CFileView;
+template<class F, class... Args> class TaskGroup;
+
+/**
+ * Reads the model files named by the unit- and feature-defs on the thread
+ * pool while the load thread works through the other loading stages; the
+ * S3O textures referenced by a model header are read right after the model
+ * itself. Archives keep what they decompressed cached, so the model parsers
+ * and texture handlers later find the data ready.
+ *
+ * Only file I/O and decompression are moved off the load thread, parsing
+ * and GL uploads still happen there (the parsers are neither thread-safe
+ * nor GL-free).
+ */
+class CAssetPreloader : boost::noncopyable
+{
+public:
+	CAssetPreloader();
+	~CAssetPreloader();
+
+	/// collects the model names from <defsParser> and starts reading them
+	void Start(LuaParser* defsParser);
+	/// blocks until every queued file has been read, helping out meanwhile
+	void Wait();
+
+private:
+	void PreloadModels(size_t firstModel);
+	void PreloadModel(const std::string& modelName);
+	void PreloadTexture(const std::string& textureName);
+
+	bool ReadFile(const std::string& filePath, CFileView& view);
+
+private:
+	typedef TaskGroup<const std::function<void()> > PreloadTaskGroup;
+
+	std::shared_ptr<PreloadTaskGroup> tasks;
+
+	std::vector<std::string> modelNames;
+	/// same as C3DModelLoader::FormatMap, "3do" --> MODELTYPE_3DO
+	std::map<std::string, unsigned int> modelFormats;
+	std::set<std::string> textureNames;
+	boost::mutex textureMutex;
+
+	size_t numTasks;
+
+	std::atomic<unsigned int> numFiles;
+	std::atomic<size_t> numBytes;
+
+	spring_time startTime;
+};
+
+#endif // _ASSET_PRELOADER_H
@@ -1,8 +1,10 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
 #include <map>
 #include <stdio.h>
 #include "Benchmark.h"
+#include "BenchmarkScenario.h"
 
 #include "Game.h"
 #include "GlobalUnsynced.h"
@@ -10,6 +12,8 @@
 #include "Rendering/GlobalRendering.h"
 #include "Sim/Units/UnitHandler.h"
 #include "Sim/Features/FeatureHandler.h"
+#include "Sim/Misc/GlobalSynced.h"
+#include "System/Log/ILog.h"
 #include "System/TimeProfiler.h"
 
 static std::map<float, float> realFPS;
@@ -20,20 +24,49 @@ static std::map<int, size_t>  features;
 static std::map<int, float>   gameSpeed;
 static std::map<int, float>   luaUsage;
 
+// per-frame sim times and per-timer totals over [startFrame, endFrame]
+static std::vector<float> simFrameTimes;
+static std::map<std::string, spring_time> profileStart;
+static std::map<std::string, float> profileTimes;
+static spring_time startTime;
+static spring_time endTime;
+static spring_time lastSimTime;
+
 bool CBenchmark::enabled = false;
 int CBenchmark::startFrame = 0;
 int CBenchmark::endFrame = 5 * 60 * GAME_SPEED;
+std::string CBenchmark::scenarioName;
 
 
 CBenchmark::CBenchmark()
 	: CEventClient("[CBenchmark]", 271990, false)
+	, scenario(NULL)
 {
+	if (!scenarioName.empty()) {
+		if ((scenario = CBenchmarkScenario::GetScenario(scenarioName)) == NULL) {
+			LOG_L(L_ERROR, "[Benchmark::%s] unknown scenario \"%s\"", __FUNCTION__, scenarioName.c_str());
+		}
+	}
+
 	eventHandler.AddClient(this);
 }
 
 CBenchmark::~CBenchmark()
 {
-	FILE* pFile = fopen("benchmark.data", "w");
+	WriteData("benchmark.data");
+	WriteJSON("benchmark.json");
+
+	delete scenario;
+}
+
+
+void CBenchmark::WriteData(const char* fileName) const
+{
+	FILE* pFile = fopen(fileName, "w");
+
+	if (pFile == NULL)
+		return;
+
 	std::map<float, float>::const_iterator rit = realFPS.begin();
 	std::map<float, float>::const_iterator dit = drawFPS.begin();
 	std::map<int, float>::const_iterator   sit = simFPS.begin();
@@ -61,22 +94,111 @@ CBenchmark::~CBenchmark()
 	fclose(pFile);
 }
 
+
+void CBenchmark::WriteJSON(const char* fileName) const
+{
+	FILE* pFile = fopen(fileName, "w");
+
+	if (pFile == NULL)
+		return;
+
+	std::vector<float> sortedTimes = simFrameTimes;
+	std::sort(sortedTimes.begin(), sortedTimes.end());
+
+	float meanTime = 0.0f;
+	float wallTime = (endTime - startTime).toSecsf();
+	size_t maxUnits = 0;
+	size_t maxFeatures = 0;
+
+	for (unsigned int n = 0; n < sortedTimes.size(); n++) {
+		meanTime += sortedTimes[n];
+	}
+	for (std::map<int, size_t>::const_iterator it = units.begin(); it != units.end(); ++it) {
+		maxUnits = std::max(maxUnits, it->second);
+	}
+	for (std::map<int, size_t>::const_iterator it = features.begin(); it != features.end(); ++it) {
+		maxFeatures = std::max(maxFeatures, it->second);
+	}
+
+	if (!sortedTimes.empty())
+		meanTime /= sortedTimes.size();
+
+	#define PERCENTILE(p) (sortedTimes.empty()? 0.0f: sortedTimes[(sortedTimes.size() - 1) * (p) / 100])
+
+	fprintf(pFile, "{\n");
+	fprintf(pFile, "\t\"scenario\": \"%s\",\n", (scenario != NULL)? scenario->GetName().c_str(): "");
+	fprintf(pFile, "\t\"seed\": %u,\n", (scenario != NULL)? CBenchmarkScenario::RAND_SEED: gs->GetInitRandSeed());
+	fprintf(pFile, "\t\"startFrame\": %d,\n", startFrame);
+	fprintf(pFile, "\t\"endFrame\": %d,\n", endFrame);
+	fprintf(pFile, "\t\"frames\": " _STPF_ ",\n", simFrameTimes.size());
+	fprintf(pFile, "\t\"wallTime\": %f,\n", wallTime);
+	fprintf(pFile, "\t\"simFPS\": %f,\n", (wallTime > 0.0f)? (simFrameTimes.size() / wallTime): 0.0f);
+	fprintf(pFile, "\t\"maxUnits\": " _STPF_ ",\n", maxUnits);
+	fprintf(pFile, "\t\"maxFeatures\": " _STPF_ ",\n", maxFeatures);
+	fprintf(pFile, "\t\"simFrameTime\": {\n");
+	fprintf(pFile, "\t\t\"mean\": %f,\n", meanTime);
+	fprintf(pFile, "\t\t\"median\": %f,\n", PERCENTILE(50));
+	fprintf(pFile, "\t\t\"p95\": %f,\n", PERCENTILE(95));
+	fprintf(pFile, "\t\t\"p99\": %f,\n", PERCENTILE(99));
+	fprintf(pFile, "\t\t\"max\": %f\n", PERCENTILE(100));
+	fprintf(pFile, "\t},\n");
+	fprintf(pFile, "\t\"profile\": {");
+
+	// total milliseconds spent in each CTimeProfiler timer during the run
+	for (std::map<std::string, float>::const_iterator it = profileTimes.begin(); it != profileTimes.end(); ++it) {
+		fprintf(pFile, "%s\n\t\t\"%s\": %f", (it == profileTimes.begin())? "": ",", it->first.c_str(), it->second);
+	}
+
+	fprintf(pFile, "\n\t}\n");
+	fprintf(pFile, "}\n");
+	fclose(pFile);
+
+	#undef PERCENTILE
+}
+
+
 void CBenchmark::GameFrame(int gameFrame)
 {
-	if (gameFrame == 0 && (startFrame - 45 * GAME_SPEED > 0)) {
+	if (scenario != NULL) {
+		scenario->GameFrame(gameFrame);
+
+		// scenarios measure throughput, so run as fast as possible all the way
+		if (gameFrame == 0) {
+			std::vector<string> cmds;
+			cmds.push_back("@@setmaxspeed 100");
+			cmds.push_back("@@setminspeed 100");
+			guihandler->RunCustomCommands(cmds, false);
+		}
+	} else if (gameFrame == 0 && (startFrame - 45 * GAME_SPEED > 0)) {
 		std::vector<string> cmds;
 		cmds.push_back("@@setmaxspeed 100");
 		cmds.push_back("@@setminspeed 100");
 		guihandler->RunCustomCommands(cmds, false);
 	}
 
-	if (gameFrame == (startFrame - 45 * GAME_SPEED)) {
+	if (scenario == NULL && gameFrame == (startFrame - 45 * GAME_SPEED)) {
 		std::vector<string> cmds;
 		cmds.push_back("@@setminspeed 1");
 		cmds.push_back("@@setmaxspeed 1");
 		guihandler->RunCustomCommands(cmds, false);
 	}
 
+	if (gameFrame == startFrame) {
+		profiler.GetTimeRecordTotals(profileStart);
+
+		startTime = spring_gettime();
+		lastSimTime = profiler.GetTimeRecordTotal("SimFrame");
+	}
+
+	if (gameFrame > startFrame && gameFrame <= endFrame) {
+		// GameFrame is called before the SimFrame timer starts, so
+		// this measures the sim time of the previous frame
+		const spring_time simTime = profiler.GetTimeRecordTotal("SimFrame");
+
+		simFrameTimes.push_back((simTime - lastSimTime).toMilliSecsf());
+		lastSimTime = simTime;
+	}
+
 	if (gameFrame >= startFrame) {
 		simFPS[gameFrame] = (gu->avgSimFrameTime == 0.0f)? 0.0f: 1000.0f / gu->avgSimFrameTime;
 		units[gameFrame] = unitHandler->units.size();
@@ -86,6 +208,19 @@ void CBenchmark::GameFrame(int gameFrame)
 	}
 
 	if (gameFrame == endFrame) {
+		std::map<std::string, spring_time> profileEnd;
+		std::map<std::string, spring_time>::const_iterator it;
+
+		profiler.GetTimeRecordTotals(profileEnd);
+
+		for (it = profileEnd.begin(); it != profileEnd.end(); ++it) {
+			const std::map<std::string, spring_time>::const_iterator sit = profileStart.find(it->first);
+			const spring_time start = (sit != profileStart.end())? sit->second: spring_notime;
+
+			profileTimes[it->first] = (it->second - start).toMilliSecsf();
+		}
+
+		endTime = spring_gettime();
 		gu->globalQuit = true;
 	}
 }
@@ -4,8 +4,10 @@
 #define _ROAM_MESH_DRAWER_H_
 
 #include "System/EventHandler.h"
+#include <string>
 #include <vector>
 
+class CBenchmarkScenario;
 
 class CBenchmark : public CEventClient
 {
@@ -13,6 +15,8 @@ public:
 	static bool enabled;
 	static int startFrame;
 	static int endFrame;
+	/// name of a built-in CBenchmarkScenario, empty if none
+	static std::string scenarioName;
 
 public:
 	// CEventClient interface
@@ -28,6 +32,13 @@ public:
 public:
 	CBenchmark();
 	~CBenchmark();
+
+private:
+	void WriteData(const char* fileName) const;
+	void WriteJSON(const char* fileName) const;
+
+private:
+	CBenchmarkScenario* scenario;
 };
 
 #endif // _ROAM_MESH_DRAWER_H_
@@ -0,0 +1,366 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "BenchmarkScenario.h"
+
+#include "Map/Ground.h"
+#include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Misc/Team.h"
+#include "Sim/Misc/TeamHandler.h"
+#include "Sim/Units/CommandAI/Command.h"
+#include "Sim/Units/CommandAI/CommandAI.h"
+#include "Sim/Units/Unit.h"
+#include "Sim/Units/UnitDef.h"
+#include "Sim/Units/UnitDefHandler.h"
+#include "Sim/Units/UnitHandler.h"
+#include "Sim/Units/UnitLoader.h"
+#include "Sim/Weapons/WeaponDef.h"
+#include "System/Log/ILog.h"
+#include "System/myMath.h"
+
+
+
+static float GetMaxWeaponRange(const UnitDef* ud)
+{
+	float maxRange = 0.0f;
+
+	for (unsigned int n = 0; n < ud->weapons.size(); n++) {
+		maxRange = std::max(maxRange, ud->weapons[n].def->range);
+	}
+
+	return maxRange;
+}
+
+static bool IsGroundMobile(const UnitDef* ud) { return (ud->IsGroundUnit() && ud->RequireMoveDef()); }
+static bool IsGroundArmed(const UnitDef* ud) { return (IsGroundMobile(ud) && !ud->weapons.empty()); }
+static bool IsFactory(const UnitDef* ud) { return (ud->IsFactoryUnit() && !ud->buildOptions.empty()); }
+
+static float NegMetalCost(const UnitDef* ud) { return -ud->metal; }
+static float LosRadius(const UnitDef* ud) { return ud->losRadius; }
+static float NumBuildOptions(const UnitDef* ud) { return ud->buildOptions.size(); }
+
+
+
+/**
+ * Two groups of cheap ground units at opposite corners of the map,
+ * ordered to swap places over and over (PathManager, MoveTypes).
+ */
+class CMassPathingScenario: public CBenchmarkScenario
+{
+public:
+	CMassPathingScenario(): CBenchmarkScenario("masspathing", 60 * GAME_SPEED), swapped(false) {}
+
+	bool Setup() {
+		const UnitDef* ud = FindUnitDef(IsGroundMobile, NegMetalCost);
+
+		if (ud == NULL)
+			return false;
+
+		for (int n = 0; n < NUM_UNITS; n++) {
+			const float fx = 0.05f + (n % 10) * 0.01f;
+			const float fz = 0.05f + ((n / 10) % 10) * 0.01f;
+
+			SpawnUnit(ud, GetMapPos(fx, fz), 0);
+			SpawnUnit(ud, GetMapPos(1.0f - fx, 1.0f - fz), 0);
+		}
+
+		return true;
+	}
+
+	void GiveOrders(int frameNum) {
+		const std::vector<CUnit*>& units = GetUnits();
+
+		for (unsigned int n = 0; n < units.size(); n++) {
+			// even and odd units started in opposite corners
+			const bool toFarCorner = (((n & 1) == 0) != swapped);
+			const float3 goal = toFarCorner? GetMapPos(0.9f, 0.9f): GetMapPos(0.1f, 0.1f);
+
+			units[n]->commandAI->GiveCommand(Command(CMD_MOVE, 0, goal + gs->randVector() * 256.0f));
+		}
+
+		swapped = !swapped;
+	}
+
+private:
+	static const int NUM_UNITS = 200;
+
+	bool swapped;
+};
+
+
+/**
+ * Long-ranged ground units firing at random spots around the center of
+ * the map (ProjectileHandler, weapons, damage and explosions).
+ */
+class CArtilleryScenario: public CBenchmarkScenario
+{
+public:
+	CArtilleryScenario(): CBenchmarkScenario("artillery", 10 * GAME_SPEED) {}
+
+	bool Setup() {
+		const UnitDef* ud = FindUnitDef(IsGroundArmed, GetMaxWeaponRange);
+
+		if (ud == NULL)
+			return false;
+
+		range = GetMaxWeaponRange(ud);
+
+		for (int n = 0; n < NUM_UNITS; n++) {
+			const float angle = (n * TWOPI) / NUM_UNITS;
+			const float3 center = GetMapPos(0.5f, 0.5f);
+			const float3 offset(math::cos(angle) * range * 0.9f, 0.0f, math::sin(angle) * range * 0.9f);
+
+			SpawnUnit(ud, center + offset, 0);
+		}
+
+		return true;
+	}
+
+	void GiveOrders(int frameNum) {
+		const std::vector<CUnit*>& units = GetUnits();
+		const float3 center = GetMapPos(0.5f, 0.5f);
+
+		for (unsigned int n = 0; n < units.size(); n++) {
+			float3 target = center + gs->randVector() * range * 0.5f;
+			target.y = CGround::GetHeightReal(target.x, target.z);
+
+			units[n]->commandAI->GiveCommand(Command(CMD_ATTACK, 0, target));
+		}
+	}
+
+private:
+	static const int NUM_UNITS = 100;
+
+	float range;
+};
+
+
+/**
+ * Units with the largest LOS radius of the game spread over the map for
+ * two teams, wandering around at random (LosHandler, RadarHandler).
+ */
+class CLosStressScenario: public CBenchmarkScenario
+{
+public:
+	CLosStressScenario(): CBenchmarkScenario("losstress", 20 * GAME_SPEED) {}
+
+	bool Setup() {
+		const UnitDef* ud = FindUnitDef(IsGroundMobile, LosRadius);
+
+		if (ud == NULL)
+			return false;
+
+		const int numTeams = std::min(2, teamHandler->ActiveTeams());
+
+		for (int n = 0; n < NUM_UNITS; n++) {
+			SpawnUnit(ud, GetRandomMapPos(), n % numTeams);
+		}
+
+		return true;
+	}
+
+	void GiveOrders(int frameNum) {
+		const std::vector<CUnit*>& units = GetUnits();
+
+		for (unsigned int n = 0; n < units.size(); n++) {
+			units[n]->commandAI->GiveCommand(Command(CMD_MOVE, 0, GetRandomMapPos()));
+		}
+	}
+
+private:
+	static const int NUM_UNITS = 400;
+};
+
+
+/**
+ * A grid of factories building units on repeat, with resources topped
+ * up so production never stalls (unit scripts, construction, unit and
+ * wreck creation).
+ */
+class CFactoriesScenario: public CBenchmarkScenario
+{
+public:
+	CFactoriesScenario(): CBenchmarkScenario("factories", 2 * GAME_SPEED), factoryDef(NULL) {}
+
+	bool Setup() {
+		if ((factoryDef = FindUnitDef(IsFactory, NumBuildOptions)) == NULL)
+			return false;
+
+		for (int n = 0; n < NUM_FACTORIES; n++) {
+			const float fx = 0.2f + (n % 6) * 0.12f;
+			const float fz = 0.2f + (n / 6) * 0.12f;
+
+			SpawnUnit(factoryDef, GetMapPos(fx, fz), 0, FACING_SOUTH);
+		}
+
+		const std::vector<CUnit*>& units = GetUnits();
+
+		for (unsigned int n = 0; n < units.size(); n++) {
+			CCommandAI* cai = units[n]->commandAI;
+			std::map<int, std::string>::const_iterator it;
+
+			cai->GiveCommand(Command(CMD_REPEAT, 0, 1.0f));
+
+			for (it = factoryDef->buildOptions.begin(); it != factoryDef->buildOptions.end(); ++it) {
+				const UnitDef* ud = unitDefHandler->GetUnitDefByName(it->second);
+
+				if (ud == NULL)
+					continue;
+
+				cai->GiveCommand(Command(-ud->id, SHIFT_KEY));
+			}
+		}
+
+		return true;
+	}
+
+	void GiveOrders(int frameNum) {
+		CTeam* team = teamHandler->Team(0);
+
+		team->resStorage.metal = std::max(team->resStorage.metal, 1000000.0f);
+		team->resStorage.energy = std::max(team->resStorage.energy, 1000000.0f);
+		team->res = team->resStorage;
+	}
+
+private:
+	static const int NUM_FACTORIES = 36;
+
+	const UnitDef* factoryDef;
+};
+
+
+
+CBenchmarkScenario* CBenchmarkScenario::GetScenario(const std::string& name)
+{
+	if (name == "masspathing") return (new CMassPathingScenario());
+	if (name == "artillery") return (new CArtilleryScenario());
+	if (name == "losstress") return (new CLosStressScenario());
+	if (name == "factories") return (new CFactoriesScenario());
+
+	return NULL;
+}
+
+std::vector<std::string> CBenchmarkScenario::GetScenarioNames()
+{
+	std::vector<std::string> names;
+	names.push_back("masspathing");
+	names.push_back("artillery");
+	names.push_back("losstress");
+	names.push_back("factories");
+	return names;
+}
+
+
+
+CBenchmarkScenario::CBenchmarkScenario(const std::string& scenarioName, int interval)
+	: name(scenarioName)
+	, orderInterval(interval)
+	, initialized(false)
+{
+}
+
+
+void CBenchmarkScenario::GameFrame(int frameNum)
+{
+	if (!initialized) {
+		initialized = true;
+
+		gs->SetRandSeed(RAND_SEED, true);
+
+		if (!Setup()) {
+			LOG_L(L_ERROR, "[BenchmarkScenario::%s] game has no units suitable for scenario \"%s\"", __FUNCTION__, name.c_str());
+			orderInterval = 0;
+			return;
+		}
+
+		LOG("[BenchmarkScenario::%s] scenario \"%s\" spawned " _STPF_ " units", __FUNCTION__, name.c_str(), unitIDs.size());
+	}
+
+	if (orderInterval <= 0)
+		return;
+	if ((frameNum % orderInterval) != 0)
+		return;
+
+	GiveOrders(frameNum);
+}
+
+
+bool CBenchmarkScenario::SpawnUnit(const UnitDef* ud, const float3& pos, int teamID, int facing)
+{
+	if (!unitHandler->CanBuildUnit(ud, teamID))
+		return false;
+
+	UnitLoadParams params;
+	params.unitDef = ud;
+	params.builder = NULL;
+	params.pos = pos;
+	params.speed = ZeroVector;
+	params.unitID = -1;
+	params.teamID = teamID;
+	params.facing = facing;
+	params.beingBuilt = false;
+	params.flattenGround = true;
+
+	const CUnit* unit = unitLoader->LoadUnit(params);
+
+	if (unit == NULL)
+		return false;
+
+	unitIDs.push_back(unit->id);
+	return true;
+}
+
+
+std::vector<CUnit*> CBenchmarkScenario::GetUnits() const
+{
+	std::vector<CUnit*> units;
+	units.reserve(unitIDs.size());
+
+	// units may have died (or been reused by another unit) in the meantime
+	for (unsigned int n = 0; n < unitIDs.size(); n++) {
+		CUnit* unit = unitHandler->GetUnit(unitIDs[n]);
+
+		if (unit == NULL || unit->isDead || unit->beingBuilt)
+			continue;
+
+		units.push_back(unit);
+	}
+
+	return units;
+}
+
+
+float3 CBenchmarkScenario::GetMapPos(float fx, float fz) const
+{
+	float3 pos(fx * gs->mapx * SQUARE_SIZE, 0.0f, fz * gs->mapy * SQUARE_SIZE);
+	pos.ClampInBounds();
+	pos.y = CGround::GetHeightReal(pos.x, pos.z);
+	return pos;
+}
+
+float3 CBenchmarkScenario::GetRandomMapPos() const
+{
+	return (GetMapPos(0.05f + gs->randFloat() * 0.9f, 0.05f + gs->randFloat() * 0.9f));
+}
+
+
+const UnitDef* CBenchmarkScenario::FindUnitDef(bool (*filter)(const UnitDef*), float (*key)(const UnitDef*))
+{
+	const UnitDef* bestDef = NULL;
+	float bestKey = 0.0f;
+
+	// ties go to the lowest ID
+	for (unsigned int n = 1; n < unitDefHandler->unitDefs.size(); n++) {
+		const UnitDef* ud = unitDefHandler->unitDefs[n];
+
+		if (ud == NULL || !filter(ud))
+			continue;
+
+		if (bestDef != NULL && key(ud) <= bestKey)
+			continue;
+
+		bestDef = ud;
+		bestKey = key(ud);
+	}
+
+	return bestDef;
+}
@@ -0,0 +1,66 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef BENCHMARK_SCENARIO_H
+#define BENCHMARK_SCENARIO_H
+
+#include <string>
+#include <vector>
+
+#include "System/float3.h"
+
+struct UnitDef;
+class CUnit;
+
+/**
+ * Synthetic load for CBenchmark, so a game and a map are all that is
+ * needed to measure sim throughput (no demo, no AI).
+ *
+ * A scenario reseeds the synced RNG, spawns its units on the first frame
+ * and re-issues their orders at a fixed interval after that. Units are
+ * picked from the loaded game by their properties, so results are only
+ * comparable between runs on the same game, map and seed.
+ *
+ * NOTE: this modifies the synced state on the local client only, which
+ *   is why the scenarios are meant for single-client (spring-headless)
+ *   runs and would desync a multiplayer game.
+ */
+class CBenchmarkScenario
+{
+public:
+	static CBenchmarkScenario* GetScenario(const std::string& name);
+	static std::vector<std::string> GetScenarioNames();
+
+	static const unsigned int RAND_SEED = 0x5EED;
+
+public:
+	CBenchmarkScenario(const std::string& scenarioName, int interval);
+	virtual ~CBenchmarkScenario() {}
+
+	void GameFrame(int frameNum);
+
+	const std::string& GetName() const { return name; }
+
+protected:
+	/// spawn the units, returns false if the game lacks suitable unitdefs
+	virtual bool Setup() = 0;
+	/// (re-)issue the orders, called every orderInterval frames
+	virtual void GiveOrders(int frameNum) = 0;
+
+	bool SpawnUnit(const UnitDef* ud, const float3& pos, int teamID, int facing = 0);
+	std::vector<CUnit*> GetUnits() const;
+
+	float3 GetMapPos(float fx, float fz) const;
+	float3 GetRandomMapPos() const;
+
+	/// the unitdef with the highest <key>, among those passing <filter>
+	static const UnitDef* FindUnitDef(bool (*filter)(const UnitDef*), float (*key)(const UnitDef*));
+
+protected:
+	std::string name;
+	std::vector<int> unitIDs;
+
+	int orderInterval;
+	bool initialized;
+};
+
+#endif // BENCHMARK_SCENARIO_H
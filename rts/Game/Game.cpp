@@ -13,6 +13,7 @@
 #include <SDL_keyboard.h>
 
 #include "Game.h"
+#include "AssetPreloader.h"
 #include "Benchmark.h"
 #include "Camera.h"
 #include "CameraHandler.h"
@@ -25,6 +26,7 @@
 #include "GlobalUnsynced.h"
 #include "LoadScreen.h"
 #include "SelectedUnitsHandler.h"
+#include "SimTelemetry.h"
 #include "WaitCommandsAI.h"
 #include "WordCompletion.h"
 #include "IVideoCapturing.h"
@@ -102,6 +104,7 @@
 #include "Sim/Misc/ResourceHandler.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/MoveTypes/ClassicGroundMoveType.h"
+#include "Sim/MoveTypes/UnitCollisionBroadPhase.h"
 #include "Sim/Path/IPathManager.h"
 #include "Sim/Projectiles/ExplosionGenerator.h"
 #include "Sim/Projectiles/Projectile.h"
@@ -133,6 +136,8 @@
 #include "System/Config/ConfigHandler.h"
 #include "System/EventHandler.h"
 #include "System/Exceptions.h"
+#include "System/FrameArena.h"
+#include "System/MemPool.h"
 #include "System/Sync/FPUCheck.h"
 #include "System/GlobalConfig.h"
 #include "System/myMath.h"
@@ -233,6 +238,8 @@ CR_REG_METADATA(CGame, (
 	CR_IGNORED(infoConsole),
 	CR_IGNORED(consoleHistory),
 	CR_IGNORED(worldDrawer),
+	CR_IGNORED(simTelemetry),
+	CR_IGNORED(frameArena),
 	CR_IGNORED(defsParser),
 	CR_IGNORED(saveFile),
 
@@ -373,6 +380,8 @@ CGame::CGame(const std::string& mapName, const std::string& modName, ILoadSaveHa
 	, infoConsole(NULL)
 	, consoleHistory(NULL)
 	, worldDrawer(NULL)
+	, simTelemetry(NULL)
+	, frameArena(NULL)
 	, defsParser(NULL)
 	, saveFile(saveFile)
 	, finishedLoading(false)
@@ -382,6 +391,9 @@ CGame::CGame(const std::string& mapName, const std::string& modName, ILoadSaveHa
 
 	memset(gameID, 0, sizeof(gameID));
 
+	frameArena = new CFrameArena();
+	CFrameArena::SetThreadArena(frameArena);
+
 	// set "Headless" in config overlay (not persisted)
 	configHandler->Set("Headless", (SpringVersion::IsHeadless()) ? 1 : 0, true);
 
@@ -464,6 +476,7 @@ CGame::~CGame()
 	LOG("[%s][6]", __FUNCTION__);
 	SafeDelete(infoTextureHandler);
 	SafeDelete(worldDrawer);
+	SafeDelete(simTelemetry);
 	SafeDelete(guihandler); // frees LuaUI
 	SafeDelete(minimap);
 	SafeDelete(resourceBar);
@@ -492,6 +505,7 @@ CGame::~CGame()
 	LOG("[%s][8]", __FUNCTION__);
 	SafeDelete(featureHandler); // depends on unitHandler (via ~CFeature)
 	SafeDelete(unitHandler); // depends on modelParser (via ~CUnit)
+	SafeDelete(unitCollisionBroadPhase);
 	SafeDelete(projectileHandler);
 
 	LOG("[%s][9]", __FUNCTION__);
@@ -536,6 +550,9 @@ CGame::~CGame()
 	LOG("[%s][16]", __FUNCTION__);
 	ISound::Shutdown();
 
+	CFrameArena::SetThreadArena(NULL);
+	SafeDelete(frameArena);
+
 	LOG("[%s][17]", __FUNCTION__);
 	LEAVE_SYNCED_CODE();
 }
@@ -550,13 +567,19 @@ void CGame::LoadGame(const std::string& mapName, bool threaded)
 	Threading::SetGameLoadThread();
 	Watchdog::RegisterThread(WDT_LOAD);
 
+	// reads model and texture files on the thread pool, overlapping
+	// the stages up to LoadLua (which may map new archives into the VFS)
+	CAssetPreloader assetPreloader;
+
 	if (!gu->globalQuit) LoadMap(mapName);
 	if (!gu->globalQuit) LoadDefs();
+	if (!gu->globalQuit) assetPreloader.Start(defsParser);
 	if (!gu->globalQuit) PreLoadSimulation();
 	if (!gu->globalQuit) PreLoadRendering();
 	if (!gu->globalQuit) PostLoadSimulation();
 	if (!gu->globalQuit) PostLoadRendering();
 	if (!gu->globalQuit) LoadInterface();
+	assetPreloader.Wait();
 	if (!gu->globalQuit) LoadLua();
 	if (!gu->globalQuit) LoadFinalize();
 	if (!gu->globalQuit) InitSkirmishAIs();
@@ -677,6 +700,7 @@ void CGame::PostLoadSimulation()
 	CClassicGroundMoveType::CreateLineTable();
 
 	unitHandler = new CUnitHandler();
+	unitCollisionBroadPhase = new CUnitCollisionBroadPhase();
 	projectileHandler = new CProjectileHandler();
 
 	loadscreen->SetLoadMessage("Loading Feature Definitions");
@@ -892,6 +916,8 @@ void CGame::LoadFinalize()
 		static CBenchmark benchmark;
 	}
 
+	simTelemetry = new CSimTelemetry();
+
 	lastReadNetTime = spring_gettime();
 	lastSimFrameTime = lastReadNetTime;
 	lastDrawFrameTime = lastReadNetTime;
@@ -1220,6 +1246,8 @@ bool CGame::UpdateUnsynced(const spring_time currentTime)
 bool CGame::Draw() {
 	const spring_time currentTimePreUpdate = spring_gettime();
 
+	frameArena->Reset();
+
 	if (UpdateUnsynced(currentTimePreUpdate))
 		return true;
 
@@ -1549,6 +1577,13 @@ void CGame::SimFrame() {
 	// stats are reliable when paused) but see LuaUser
 	spring_lua_alloc_update_stats(((++gs->frameNum) % GAME_SPEED) == 0);
 
+	// no quadfield query results et al. survive across frames
+	frameArena->Reset();
+
+	// hand unused pool slabs back once per minute
+	if ((gs->frameNum % (GAME_SPEED * 60)) == 0)
+		mempool.Trim();
+
 #ifdef TRACE_SYNC
 	tracefile << "New frame:" << gs->frameNum << " " << gs->GetRandSeed() << "\n";
 #endif
@@ -1594,6 +1629,7 @@ void CGame::SimFrame() {
 	gu->avgSimFrameTime = std::max(gu->avgSimFrameTime, 0.001f);
 
 	eventHandler.DbgTimingInfo(TIMING_SIM, lastFrameTime, lastSimFrameTime);
+	simTelemetry->SimFrame(gs->frameNum, lastSimFrameTime - lastFrameTime);
 
 	#ifdef HEADLESS
 	{
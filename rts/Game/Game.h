@@ -23,6 +23,8 @@ class IUnsyncedActionExecutor;
 class ChatMessage;
 class SkirmishAIData;
 class CWorldDrawer;
+class CSimTelemetry;
+class CFrameArena;
 
 
 class CGame : public CGameController
@@ -214,6 +216,9 @@ public:
 
 private:
 	CWorldDrawer* worldDrawer;
+	CSimTelemetry* simTelemetry;
+	/// scratch memory for per-frame temporaries of the main thread
+	CFrameArena* frameArena;
 
 	LuaParser* defsParser;
 
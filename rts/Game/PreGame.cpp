@@ -482,6 +482,9 @@ void CPreGame::GameDataReceived(boost::shared_ptr<const netcode::RawPacket> pack
 		vfsHandler->AddArchiveWithDeps(gameSetup->modName, false);
 		modArchive = archiveScanner->ArchiveFromName(gameSetup->modName);
 		LOG("Using game archive: %s", modArchive.c_str());
+
+		// solid archives are much faster to unpack as a whole, in parallel
+		vfsHandler->DecompressArchivesAhead();
 	}
 
 	// Check checksums of map & game
@@ -589,7 +589,7 @@ void CSelectedUnitsHandlerAI::SelectCircleUnits(
 	if (p == NULL)
 		return;
 
-	const vector<CUnit*>& tmpUnits = quadField->GetUnits(pos, radius);
+	const CQuadField::UnitVector& tmpUnits = quadField->GetUnits(pos, radius);
 
 	const float radiusSqr = radius * radius;
 	const unsigned int count = tmpUnits.size();
@@ -637,7 +637,7 @@ void CSelectedUnitsHandlerAI::SelectRectangleUnits(
 	const float3 mins(std::min(pos0.x, pos1.x), 0.0f, std::min(pos0.z, pos1.z));
 	const float3 maxs(std::max(pos0.x, pos1.x), 0.0f, std::max(pos0.z, pos1.z));
 
-	const vector<CUnit*>& tmpUnits = quadField->GetUnitsExact(mins, maxs);
+	const CQuadField::UnitVector& tmpUnits = quadField->GetUnitsExact(mins, maxs);
 
 	const unsigned int count = tmpUnits.size();
 	const int allyTeam = teamHandler->AllyTeam(p->team);
@@ -0,0 +1,153 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "SimTelemetry.h"
+
+#include "GlobalUnsynced.h"
+#include "Net/Protocol/BaseNetProtocol.h"
+#include "Net/Protocol/NetProtocol.h"
+#include "Sim/Features/FeatureHandler.h"
+#include "Sim/Projectiles/ProjectileHandler.h"
+#include "Sim/Units/UnitHandler.h"
+#include "System/Config/ConfigHandler.h"
+#include "System/Log/ILog.h"
+#include "System/Platform/Misc.h"
+#include "System/TimeProfiler.h"
+#include "lib/lua/include/LuaUser.h"
+
+#include <algorithm>
+#include <cstring>
+
+CONFIG(int, SimTelemetryInterval).defaultValue(0).minimumValue(0).description("Every how many sim-frames to send a record of sim time per phase, object counts and memory usage to the server (which passes it on to the autohost), 0 disables.");
+CONFIG(std::string, SimTelemetryFile).defaultValue("").description("If set, each SimTelemetryInterval record is also appended to this file as one line of JSON.");
+
+
+// CTimeProfiler timers summed into each phase
+static const char* PHASE_TIMERS[SimTelemetry::NUM_PHASES][4] = {
+	{"Unit::Update", "Unit::SlowUpdate", "Unit::UpdatePieceMatrices", NULL},
+	{"Unit::MoveType::Update", NULL, NULL, NULL},
+	{"PathManager::Update", "PathManager::RequestPath", "PathManager::NextWayPoint", NULL},
+	{"ProjectileHandler::Update", NULL, NULL, NULL},
+	{"FeatureHandler::Update", NULL, NULL, NULL},
+	{"LOSHandler::Update", "LOSHandler::MoveUnit", NULL, NULL},
+	{"CobEngine::Tick", "UnitScriptEngine::Tick", NULL, NULL},
+	{"Lua", NULL, NULL, NULL},
+};
+
+static const char* PHASE_NAMES[SimTelemetry::NUM_PHASES] = {
+	"units", "movetypes", "pathing", "projectiles", "features", "los", "scripts", "lua",
+};
+
+
+static spring_time GetPhaseTotal(int phase)
+{
+	spring_time total = spring_notime;
+
+	for (unsigned int n = 0; PHASE_TIMERS[phase][n] != NULL; n++) {
+		total += profiler.GetTimeRecordTotal(PHASE_TIMERS[phase][n]);
+	}
+
+	return total;
+}
+
+
+
+SimTelemetry::SimTelemetry()
+{
+	memset(this, 0, sizeof(SimTelemetry));
+}
+
+
+
+CSimTelemetry::CSimTelemetry()
+	: interval(configHandler->GetInt("SimTelemetryInterval"))
+	, file(NULL)
+{
+	if (interval <= 0)
+		return;
+
+	const std::string fileName = configHandler->GetString("SimTelemetryFile");
+
+	if (!fileName.empty() && (file = fopen(fileName.c_str(), "a")) == NULL) {
+		LOG_L(L_WARNING, "[SimTelemetry::%s] could not open \"%s\"", __FUNCTION__, fileName.c_str());
+	}
+
+	StartInterval();
+}
+
+CSimTelemetry::~CSimTelemetry()
+{
+	if (file != NULL) {
+		fclose(file);
+	}
+}
+
+
+void CSimTelemetry::SimFrame(int frameNum, spring_time simFrameTime)
+{
+	if (interval <= 0)
+		return;
+
+	const float simTime = simFrameTime.toMilliSecsf();
+
+	record.numFrames += 1;
+	record.simTimeAvg += simTime;
+	record.simTimeMax = std::max(record.simTimeMax, simTime);
+
+	if (record.numFrames < interval)
+		return;
+
+	FinishInterval(frameNum);
+	StartInterval();
+}
+
+
+void CSimTelemetry::StartInterval()
+{
+	record = SimTelemetry();
+	startTime = spring_gettime();
+
+	for (int n = 0; n < SimTelemetry::NUM_PHASES; n++) {
+		phaseStartTimes[n] = GetPhaseTotal(n);
+	}
+}
+
+void CSimTelemetry::FinishInterval(int frameNum)
+{
+	SLuaInfo luaInfo;
+	spring_lua_alloc_get_stats(&luaInfo);
+
+	record.frame = frameNum;
+	record.wallTime = (spring_gettime() - startTime).toMilliSecsf();
+	record.simTimeAvg /= record.numFrames;
+
+	for (int n = 0; n < SimTelemetry::NUM_PHASES; n++) {
+		record.phaseTimes[n] = (GetPhaseTotal(n) - phaseStartTimes[n]).toMilliSecsf() / record.numFrames;
+	}
+
+	record.numUnits = unitHandler->activeUnits.size();
+	record.numFeatures = featureHandler->GetActiveFeatures().size();
+	record.numProjectiles = projectileHandler->syncedProjectiles.size() + projectileHandler->unsyncedProjectiles.size();
+	record.luaMemory = luaInfo.allocedBytes / 1024;
+	record.processMemory = Platform::GetProcessMemoryUsage() / 1024;
+
+	net->Send(CBaseNetProtocol::Get().SendSimTelemetry(gu->myPlayerNum, record));
+
+	if (file != NULL) {
+		WriteJSON(record);
+	}
+}
+
+
+void CSimTelemetry::WriteJSON(const SimTelemetry& record)
+{
+	fprintf(file, "{\"frame\":%d,\"numFrames\":%d,\"wallTime\":%.3f,", record.frame, record.numFrames, record.wallTime);
+	fprintf(file, "\"simTimeAvg\":%.3f,\"simTimeMax\":%.3f,\"phases\":{", record.simTimeAvg, record.simTimeMax);
+
+	for (int n = 0; n < SimTelemetry::NUM_PHASES; n++) {
+		fprintf(file, "%s\"%s\":%.3f", (n == 0)? "": ",", PHASE_NAMES[n], record.phaseTimes[n]);
+	}
+
+	fprintf(file, "},\"numUnits\":%d,\"numFeatures\":%d,\"numProjectiles\":%d,", record.numUnits, record.numFeatures, record.numProjectiles);
+	fprintf(file, "\"luaMemory\":%d,\"processMemory\":%d}\n", record.luaMemory, record.processMemory);
+	fflush(file);
+}
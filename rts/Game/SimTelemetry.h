@@ -0,0 +1,94 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SIM_TELEMETRY_H
+#define SIM_TELEMETRY_H
+
+#include "System/Misc/SpringTime.h"
+
+#include <cstdio>
+
+#pragma pack(push, 1)
+
+/**
+ * @brief Sim load of one client over the last SimTelemetryInterval frames
+ *
+ * Sent to the server as NETMSG_SIM_TELEMETRY, which passes it on to the
+ * autohost unchanged, so this layout is part of the autohost protocol.
+ */
+struct SimTelemetry
+{
+	enum Phase {
+		PHASE_UNITS       = 0, ///< Unit::Update, Unit::SlowUpdate, piece matrices
+		PHASE_MOVETYPES   = 1,
+		PHASE_PATHING     = 2, ///< includes requests made from within PHASE_MOVETYPES
+		PHASE_PROJECTILES = 3,
+		PHASE_FEATURES    = 4,
+		PHASE_LOS         = 5,
+		PHASE_SCRIPTS     = 6, ///< COB and LUS
+		PHASE_LUA         = 7, ///< all Lua call-ins, synced and unsynced
+		NUM_PHASES        = 8,
+	};
+
+	SimTelemetry();
+
+	/// last frame of the interval
+	int frame;
+	int numFrames;
+
+	/// real time the interval took, in milliseconds
+	float wallTime;
+	/// milliseconds per sim frame
+	float simTimeAvg;
+	float simTimeMax;
+	/// milliseconds per sim frame spent in each phase
+	float phaseTimes[NUM_PHASES];
+
+	int numUnits;
+	int numFeatures;
+	int numProjectiles;
+
+	/// kilobytes
+	int luaMemory;
+	int processMemory;
+};
+
+#pragma pack(pop)
+
+
+
+/**
+ * @brief Collects SimTelemetry records while the game runs
+ *
+ * Every SimTelemetryInterval frames, the record is sent to the server
+ * (for the autohost) and appended as one line of JSON to SimTelemetryFile
+ * if set, so headless clients can be monitored without an autohost.
+ */
+class CSimTelemetry
+{
+public:
+	CSimTelemetry();
+	~CSimTelemetry();
+
+	/// call at the end of every SimFrame
+	void SimFrame(int frameNum, spring_time simFrameTime);
+
+	bool IsEnabled() const { return (interval > 0); }
+
+private:
+	void StartInterval();
+	void FinishInterval(int frameNum);
+
+	void WriteJSON(const SimTelemetry& record);
+
+private:
+	int interval;
+
+	FILE* file;
+
+	SimTelemetry record;
+
+	spring_time startTime;
+	spring_time phaseStartTimes[SimTelemetry::NUM_PHASES];
+};
+
+#endif // SIM_TELEMETRY_H
@@ -2989,6 +2989,36 @@ public:
 
 
 
+/// /profiletrace [0|1]
+class ProfileTraceActionExecutor : public IUnsyncedActionExecutor {
+public:
+	ProfileTraceActionExecutor() : IUnsyncedActionExecutor("ProfileTrace",
+			"Start or stop recording profiler scopes on all threads, stopping"
+			" writes them to profile_trace.json (chrome://tracing format)") {}
+
+	bool Execute(const UnsyncedAction& action) const {
+		bool enable = profiler.IsTracing();
+		InverseOrSetBool(enable, action.GetArgs());
+
+		if (enable == profiler.IsTracing())
+			return true;
+
+		profiler.SetTracing(enable);
+
+		if (enable) {
+			LOG("Profile trace started");
+		} else if (profiler.WriteTrace("profile_trace.json")) {
+			LOG("Profile trace written to profile_trace.json");
+		} else {
+			LOG_L(L_WARNING, "Could not write profile_trace.json");
+		}
+
+		return true;
+	}
+};
+
+
+
 /// /save [-y ]<savename>
 class SaveActionExecutor : public IUnsyncedActionExecutor {
 public:
@@ -3377,6 +3407,7 @@ void UnsyncedGameCommands::AddDefaultActionExecutors() {
 	AddActionExecutor(new ReloadGameActionExecutor());
 	AddActionExecutor(new ReloadShadersActionExecutor());
 	AddActionExecutor(new DebugInfoActionExecutor());
+	AddActionExecutor(new ProfileTraceActionExecutor());
 
 	// XXX are these redirects really required?
 	AddActionExecutor(new RedirectToSyncedActionExecutor("ATM"));
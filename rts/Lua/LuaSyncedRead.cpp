@@ -2062,7 +2062,7 @@ int LuaSyncedRead::GetUnitsInRectangle(lua_State* L)
 
 #define RECTANGLE_TEST ; // no test, GetUnitsExact is sufficient
 
-	const vector<CUnit*>& units = quadField->GetUnitsExact(mins, maxs);
+	const CQuadField::UnitVector& units = quadField->GetUnitsExact(mins, maxs);
 
 	if (allegiance >= 0) {
 		if (IsAlliedTeam(L, allegiance)) {
@@ -2109,7 +2109,7 @@ int LuaSyncedRead::GetUnitsInBox(lua_State* L)
 		continue;                     \
 	}
 
-	const vector<CUnit*>& units = quadField->GetUnitsExact(mins, maxs);
+	const CQuadField::UnitVector& units = quadField->GetUnitsExact(mins, maxs);
 
 	if (allegiance >= 0) {
 		if (IsAlliedTeam(L, allegiance)) {
@@ -2157,7 +2157,7 @@ int LuaSyncedRead::GetUnitsInCylinder(lua_State* L)
 		continue;                                 \
 	}                                           \
 
-	const vector<CUnit*>& units = quadField->GetUnitsExact(mins, maxs);
+	const CQuadField::UnitVector& units = quadField->GetUnitsExact(mins, maxs);
 
 	if (allegiance >= 0) {
 		if (IsAlliedTeam(L, allegiance)) {
@@ -2209,7 +2209,7 @@ int LuaSyncedRead::GetUnitsInSphere(lua_State* L)
 		continue;                                 \
 	}                                           \
 
-	const vector<CUnit*>& units = quadField->GetUnitsExact(mins, maxs);
+	const CQuadField::UnitVector& units = quadField->GetUnitsExact(mins, maxs);
 
 	if (allegiance >= 0) {
 		if (IsAlliedTeam(L, allegiance)) {
@@ -2388,7 +2388,7 @@ int LuaSyncedRead::GetUnitNearestEnemy(lua_State* L)
 
 /******************************************************************************/
 
-inline void ProcessFeatures(lua_State* L, const vector<CFeature*>& features) {
+inline void ProcessFeatures(lua_State* L, const CQuadField::FeatureVector& features) {
 	const unsigned int featureCount = features.size();
 	unsigned int arrayIndex = 1;
 
@@ -2427,7 +2427,7 @@ int LuaSyncedRead::GetFeaturesInRectangle(lua_State* L)
 	const float3 mins(xmin, 0.0f, zmin);
 	const float3 maxs(xmax, 0.0f, zmax);
 
-	const vector<CFeature*>& rectFeatures = quadField->GetFeaturesExact(mins, maxs);
+	const CQuadField::FeatureVector& rectFeatures = quadField->GetFeaturesExact(mins, maxs);
 	ProcessFeatures(L, rectFeatures);
 	return 1;
 }
@@ -2441,7 +2441,7 @@ int LuaSyncedRead::GetFeaturesInSphere(lua_State* L)
 
 	const float3 pos(x, y, z);
 
-	const vector<CFeature*>& sphFeatures = quadField->GetFeaturesExact(pos, rad, true);
+	const CQuadField::FeatureVector& sphFeatures = quadField->GetFeaturesExact(pos, rad, true);
 	ProcessFeatures(L, sphFeatures);
 	return 1;
 }
@@ -2454,7 +2454,7 @@ int LuaSyncedRead::GetFeaturesInCylinder(lua_State* L)
 
 	const float3 pos(x, 0, z);
 
-	const vector<CFeature*>& cylFeatures = quadField->GetFeaturesExact(pos, rad, false);
+	const CQuadField::FeatureVector& cylFeatures = quadField->GetFeaturesExact(pos, rad, false);
 	ProcessFeatures(L, cylFeatures);
 	return 1;
 }
@@ -2474,7 +2474,7 @@ int LuaSyncedRead::GetProjectilesInRectangle(lua_State* L)
 
 	const bool renderAccess = !Threading::IsSimThread();
 
-	const vector<CProjectile*>& rectProjectiles = quadField->GetProjectilesExact(mins, maxs);
+	const CQuadField::ProjectileVector& rectProjectiles = quadField->GetProjectilesExact(mins, maxs);
 	const unsigned int rectProjectileCount = rectProjectiles.size();
 	unsigned int arrayIndex = 1;
 
@@ -117,7 +117,7 @@ void CBasicMapDamage::Explosion(const float3& pos, float strength, float radius)
 
 	// calculate how much to offset the buildings in the explosion radius with
 	// (while still keeping the ground below them flat)
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
+	const CQuadField::UnitVector& units = quadField->GetUnitsExact(pos, radius);
 	for (const CUnit* unit: units) {
 		if (!unit->blockHeightChanges) { continue; }
 		if (!unit->IsBlocking()) { continue; }
@@ -202,10 +202,46 @@ void CBasicMapDamage::RecalcArea(int x1, int x2, int y1, int y2)
 }
 
 
+/// merges areas whose bounding box costs no more to update than both separately
+static void MergeRecalcAreas(std::vector<SRectangle>& areas)
+{
+	bool merged = true;
+
+	while (merged) {
+		merged = false;
+
+		for (size_t i = 0; i < areas.size() && !merged; i++) {
+			for (size_t j = i + 1; j < areas.size() && !merged; j++) {
+				const SRectangle& a = areas[i];
+				const SRectangle& b = areas[j];
+				const SRectangle u(std::min(a.x1, b.x1), std::min(a.z1, b.z1), std::max(a.x2, b.x2), std::max(a.z2, b.z2));
+
+				// bounds are inclusive
+				const int areaA = (a.GetWidth() + 1) * (a.GetHeight() + 1);
+				const int areaB = (b.GetWidth() + 1) * (b.GetHeight() + 1);
+				const int areaU = (u.GetWidth() + 1) * (u.GetHeight() + 1);
+
+				if (areaU > (areaA + areaB))
+					continue;
+
+				areas[i] = u;
+				areas[j] = areas.back();
+				areas.pop_back();
+				merged = true;
+			}
+		}
+	}
+}
+
 void CBasicMapDamage::Update()
 {
 	SCOPED_TIMER("BasicMapDamage::Update");
 
+	// craters finishing in the same frame (eg. from artillery salvos) tend
+	// to overlap, recalculating their merged areas saves redundant updates
+	// of the derived heightmap data, pathing and features
+	recalcAreas.clear();
+
 	for (Explo* e: explosions) {
 		if (e->ttl <= 0) {
 			continue;
@@ -234,10 +270,16 @@ void CBasicMapDamage::Update()
 		}
 
 		if (e->ttl == 0) {
-			RecalcArea(e->x1 - 1, e->x2 + 1, e->y1 - 1, e->y2 + 1);
+			recalcAreas.push_back(SRectangle(e->x1 - 1, e->y1 - 1, e->x2 + 1, e->y2 + 1));
 		}
 	}
 
+	MergeRecalcAreas(recalcAreas);
+
+	for (const SRectangle& r: recalcAreas) {
+		RecalcArea(r.x1, r.x2, r.z1, r.z2);
+	}
+
 	while (!explosions.empty() && explosions.front()->ttl == 0) {
 		delete explosions.front();
 		explosions.pop_front();
@@ -4,6 +4,7 @@
 #define _BASIC_MAP_DAMAGE_H
 
 #include "MapDamage.h"
+#include "System/Rectangle.h"
 
 #include <deque>
 #include <vector>
@@ -45,6 +46,8 @@ private:
 	};
 
 	std::deque<Explo*> explosions;
+	/// areas of the explosions that finished in the current frame
+	std::vector<SRectangle> recalcAreas;
 
 	struct RelosSquare {
 		int x;
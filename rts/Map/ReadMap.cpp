@@ -20,12 +20,24 @@
 #include "System/FileSystem/FileHandler.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/Misc/RectangleOptimizer.h"
+#include "Sim/MoveTypes/MoveMath/MoveMath.h"
 
 #ifdef USE_UNSYNCED_HEIGHTMAP
 #include "Game/GlobalUnsynced.h"
 #include "Sim/Misc/LosHandler.h"
 #endif
 
+// the SSE paths perform exactly the same float operations as the scalar
+// ones (which remain in use on SSE1-only builds), so results stay synced
+#if defined(__SSE2__) && !defined(DEDICATED_NOSSE)
+	#include <emmintrin.h>
+	#define READMAP_USE_SSE2
+#endif
+
+// edge-length (in heightmap squares) of the tiles synced heightmap
+// updates are split into, each tile is processed by one thread
+static const int HEIGHTMAP_UPDATE_TILE_SIZE = 64;
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -345,6 +357,34 @@ void CReadMap::UpdateDraw()
 }
 
 
+static void GetHeightMapUpdateTiles(const SRectangle& rect, int tileSize, std::vector<SRectangle>& tiles)
+{
+	tiles.clear();
+
+	for (int z = rect.z1; z <= rect.z2; z += tileSize) {
+		for (int x = rect.x1; x <= rect.x2; x += tileSize) {
+			tiles.push_back(SRectangle(x, z, std::min(x + tileSize - 1, rect.x2), std::min(z + tileSize - 1, rect.z2)));
+		}
+	}
+}
+
+static void ForEachHeightMapUpdateTask(int numTasks, const std::function<void(const int)>& task)
+{
+	// most updates (single craters) are too small to be worth a for_mt
+	if (numTasks <= 2) {
+		for (int i = 0; i < numTasks; i++) {
+			task(i);
+		}
+
+		return;
+	}
+
+	for_mt(0, numTasks, [&](const int i) {
+		task(i);
+	});
+}
+
+
 void CReadMap::UpdateHeightMapSynced(SRectangle rect, bool initialize)
 {
 	if (rect.GetArea() <= 0) {
@@ -357,10 +397,55 @@ void CReadMap::UpdateHeightMapSynced(SRectangle rect, bool initialize)
 	rect.x2 = std::min(gs->mapxm1, rect.x2 + 1);
 	rect.z2 = std::min(gs->mapym1, rect.z2 + 1);
 
-	UpdateCenterHeightmap(rect, initialize);
-	UpdateMipHeightmaps(rect, initialize);
-	UpdateFaceNormals(rect, initialize);
-	UpdateSlopemap(rect, initialize); // must happen after UpdateFaceNormals()!
+	// face normals are needed one square beyond the changed heights, and
+	// the slopes (per 2x2 squares) read all normals around each of them
+	const SRectangle normalsRect(
+		std::max(         0, rect.x1 - 1),
+		std::max(         0, rect.z1 - 1),
+		std::min(gs->mapxm1, rect.x2 + 1),
+		std::min(gs->mapym1, rect.z2 + 1)
+	);
+	const SRectangle slopesRect(
+		std::max(            0, (rect.x1 / 2) - 1),
+		std::max(            0, (rect.z1 / 2) - 1),
+		std::min(gs->hmapx - 1, (rect.x2 / 2) + 1),
+		std::min(gs->hmapy - 1, (rect.z2 / 2) + 1)
+	);
+
+	std::vector<SRectangle> tiles;
+
+	// stage 1: center heights and face normals only depend on the corner
+	// heightmap, so every tile can be processed independently
+	GetHeightMapUpdateTiles(normalsRect, HEIGHTMAP_UPDATE_TILE_SIZE, tiles);
+	ForEachHeightMapUpdateTask(tiles.size(), [&](const int i) {
+		const SRectangle& tile = tiles[i];
+		const SRectangle centerTile(
+			std::max(tile.x1, rect.x1),
+			std::max(tile.z1, rect.z1),
+			std::min(tile.x2, rect.x2),
+			std::min(tile.z2, rect.z2)
+		);
+
+		if (centerTile.x1 <= centerTile.x2 && centerTile.z1 <= centerTile.z2)
+			UpdateCenterHeightmap(centerTile, initialize);
+
+		UpdateFaceNormals(tile, initialize);
+	});
+
+	// stage 2: slopes need the face normals of neighboring tiles and the
+	// mipmaps need all center heights, but both are independent otherwise
+	// (the mipmaps are handled as one extra task next to the slope tiles)
+	GetHeightMapUpdateTiles(slopesRect, HEIGHTMAP_UPDATE_TILE_SIZE / 2, tiles);
+	ForEachHeightMapUpdateTask(tiles.size() + 1, [&](const int i) {
+		if (i == int(tiles.size())) {
+			UpdateMipHeightmaps(rect, initialize);
+		} else {
+			UpdateSlopemap(tiles[i], initialize);
+		}
+	});
+
+	// no-op while initializing, MoveDefHandler builds the grids later
+	CMoveMath::UpdateSpeedModGrids(rect); // must happen after UpdateSlopemap()!
 
 #ifdef USE_UNSYNCED_HEIGHTMAP
 	// push the unsynced update
@@ -436,20 +521,86 @@ void CReadMap::UpdateMipHeightmaps(const SRectangle& rect, bool initialize)
 }
 
 
+#ifdef READMAP_USE_SSE2
+// lane-wise fastmath::isqrt2_nosse (aka math::isqrt), bit-identical to it
+static inline __m128 isqrt2_sse2(__m128 x)
+{
+	const __m128 xh = _mm_mul_ps(_mm_set1_ps(0.5f), x);
+	const __m128i i = _mm_sub_epi32(_mm_set1_epi32(0x5f375a86), _mm_srai_epi32(_mm_castps_si128(x), 1));
+
+	x = _mm_castsi128_ps(i);
+	x = _mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(xh, _mm_mul_ps(x, x))));
+	x = _mm_mul_ps(x, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(xh, _mm_mul_ps(x, x))));
+	return x;
+}
+
+// lane-wise float3::SafeNormalize
+static inline void SafeNormalizeSSE(__m128& x, __m128& y, __m128& z)
+{
+	const __m128 sql = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+	const __m128 msk = _mm_cmpgt_ps(sql, _mm_set1_ps(float3::NORMALIZE_EPS));
+	// feed 1 to isqrt for skipped lanes so they can not raise FP exceptions
+	const __m128 inv = isqrt2_sse2(_mm_or_ps(_mm_and_ps(msk, sql), _mm_andnot_ps(msk, _mm_set1_ps(1.0f))));
+
+	x = _mm_or_ps(_mm_and_ps(msk, _mm_mul_ps(x, inv)), _mm_andnot_ps(msk, x));
+	y = _mm_or_ps(_mm_and_ps(msk, _mm_mul_ps(y, inv)), _mm_andnot_ps(msk, y));
+	z = _mm_or_ps(_mm_and_ps(msk, _mm_mul_ps(z, inv)), _mm_andnot_ps(msk, z));
+}
+#endif
+
+
 void CReadMap::UpdateFaceNormals(const SRectangle& rect, bool initialize)
 {
 	const float* heightmapSynced = GetCornerHeightMapSynced();
 
-	const int z1 = std::max(         0, rect.z1 - 1);
-	const int x1 = std::max(         0, rect.x1 - 1);
-	const int z2 = std::min(gs->mapym1, rect.z2 + 1);
-	const int x2 = std::min(gs->mapxm1, rect.x2 + 1);
+	for (int y = rect.z1; y <= rect.z2; y++) {
+		int x = rect.x1;
+
+	#ifdef READMAP_USE_SSE2
+		// four squares at a time, see the scalar loop below for the math
+		for (; (x + 3) <= rect.x2; x += 4) {
+			const int idxTL = (y    ) * gs->mapxp1 + x; // TL
+			const int idxBL = (y + 1) * gs->mapxp1 + x; // BL
+
+			const __m128 hTL = _mm_loadu_ps(&heightmapSynced[idxTL    ]);
+			const __m128 hTR = _mm_loadu_ps(&heightmapSynced[idxTL + 1]);
+			const __m128 hBL = _mm_loadu_ps(&heightmapSynced[idxBL    ]);
+			const __m128 hBR = _mm_loadu_ps(&heightmapSynced[idxBL + 1]);
+			const __m128 sign = _mm_set1_ps(-0.0f);
+
+			__m128 fnTLx = _mm_xor_ps(_mm_sub_ps(hTR, hTL), sign);
+			__m128 fnTLy = _mm_set1_ps(SQUARE_SIZE);
+			__m128 fnTLz = _mm_xor_ps(_mm_sub_ps(hBL, hTL), sign);
+			__m128 fnBRx = _mm_sub_ps(hBL, hBR);
+			__m128 fnBRy = _mm_set1_ps(SQUARE_SIZE);
+			__m128 fnBRz = _mm_sub_ps(hTR, hBR);
+
+			SafeNormalizeSSE(fnTLx, fnTLy, fnTLz);
+			SafeNormalizeSSE(fnBRx, fnBRy, fnBRz);
+
+			__m128 cnx = _mm_add_ps(fnTLx, fnBRx);
+			__m128 cny = _mm_add_ps(fnTLy, fnBRy);
+			__m128 cnz = _mm_add_ps(fnTLz, fnBRz);
+
+			SafeNormalizeSSE(cnx, cny, cnz);
+
+			float v[9][4];
+			_mm_storeu_ps(v[0], fnTLx); _mm_storeu_ps(v[1], fnTLy); _mm_storeu_ps(v[2], fnTLz);
+			_mm_storeu_ps(v[3], fnBRx); _mm_storeu_ps(v[4], fnBRy); _mm_storeu_ps(v[5], fnBRz);
+			_mm_storeu_ps(v[6], cnx  ); _mm_storeu_ps(v[7], cny  ); _mm_storeu_ps(v[8], cnz  );
+
+			for (int n = 0; n < 4; n++) {
+				faceNormalsSynced[(y * gs->mapx + x + n) * 2    ] = float3(v[0][n], v[1][n], v[2][n]);
+				faceNormalsSynced[(y * gs->mapx + x + n) * 2 + 1] = float3(v[3][n], v[4][n], v[5][n]);
+				centerNormalsSynced[y * gs->mapx + x + n] = float3(v[6][n], v[7][n], v[8][n]);
+			}
+		}
+	#endif
 
-	for_mt(z1, z2+1, [&](const int y) {
 		float3 fnTL;
 		float3 fnBR;
 
-		for (int x = x1; x <= x2; x++) {
+		for (; x <= rect.x2; x++) {
 			const int idxTL = (y    ) * gs->mapxp1 + x; // TL
 			const int idxBL = (y + 1) * gs->mapxp1 + x; // BL
 
@@ -492,28 +643,66 @@ void CReadMap::UpdateFaceNormals(const SRectangle& rect, bool initialize)
 			faceNormalsSynced[(y * gs->mapx + x) * 2 + 1] = fnBR;
 			// square-normal
 			centerNormalsSynced[y * gs->mapx + x] = (fnTL + fnBR).Normalize();
+		}
 
-			#ifdef USE_UNSYNCED_HEIGHTMAP
-			if (initialize) {
+		#ifdef USE_UNSYNCED_HEIGHTMAP
+		if (initialize) {
+			for (x = rect.x1; x <= rect.x2; x++) {
 				faceNormalsUnsynced[(y * gs->mapx + x) * 2    ] = faceNormalsSynced[(y * gs->mapx + x) * 2    ];
 				faceNormalsUnsynced[(y * gs->mapx + x) * 2 + 1] = faceNormalsSynced[(y * gs->mapx + x) * 2 + 1];
 				centerNormalsUnsynced[y * gs->mapx + x] = centerNormalsSynced[y * gs->mapx + x];
 			}
-			#endif
 		}
-	});
+		#endif
+	}
 }
 
 
 void CReadMap::UpdateSlopemap(const SRectangle& rect, bool initialize)
 {
-	const int sx = std::max(0, (rect.x1 / 2) - 1);
-	const int ex = std::min(gs->hmapx - 1, (rect.x2 / 2) + 1);
-	const int sy = std::max(0, (rect.z1 / 2) - 1);
-	const int ey = std::min(gs->hmapy - 1, (rect.z2 / 2) + 1);
+	for (int y = rect.z1; y <= rect.z2; y++) {
+		int x = rect.x1;
+
+	#ifdef READMAP_USE_SSE2
+		// four slope-squares at a time, see the scalar loop below for the math
+		for (; (x + 3) <= rect.x2; x += 4) {
+			// the eight face normals of slope-square x are fn0[4x .. 4x+3] and fn1[4x .. 4x+3]
+			const float3* fn0 = &faceNormalsSynced[((y*2    ) * (gs->mapx) + x*2) * 2];
+			const float3* fn1 = &faceNormalsSynced[((y*2 + 1) * (gs->mapx) + x*2) * 2];
+
+			#define FACE_NORMALS_Y(fn, i) _mm_set_ps(fn[12 + (i)].y, fn[8 + (i)].y, fn[4 + (i)].y, fn[(i)].y)
+
+			__m128 avgslope = _mm_setzero_ps();
+			avgslope = _mm_add_ps(avgslope, FACE_NORMALS_Y(fn0, 0));
+			avgslope = _mm_add_ps(avgslope, FACE_NORMALS_Y(fn0, 1));
+			avgslope = _mm_add_ps(avgslope, FACE_NORMALS_Y(fn0, 2));
+			avgslope = _mm_add_ps(avgslope, FACE_NORMALS_Y(fn0, 3));
+			avgslope = _mm_add_ps(avgslope, FACE_NORMALS_Y(fn1, 0));
+			avgslope = _mm_add_ps(avgslope, FACE_NORMALS_Y(fn1, 1));
+			avgslope = _mm_add_ps(avgslope, FACE_NORMALS_Y(fn1, 2));
+			avgslope = _mm_add_ps(avgslope, FACE_NORMALS_Y(fn1, 3));
+			avgslope = _mm_mul_ps(avgslope, _mm_set1_ps(0.125f));
+
+			// _mm_min_ps(a, b) is (a < b)? a: b, ie. std::min(b, a)
+			__m128 maxslope =          FACE_NORMALS_Y(fn0, 0);
+			maxslope = _mm_min_ps(FACE_NORMALS_Y(fn0, 1), maxslope);
+			maxslope = _mm_min_ps(FACE_NORMALS_Y(fn0, 2), maxslope);
+			maxslope = _mm_min_ps(FACE_NORMALS_Y(fn0, 3), maxslope);
+			maxslope = _mm_min_ps(FACE_NORMALS_Y(fn1, 0), maxslope);
+			maxslope = _mm_min_ps(FACE_NORMALS_Y(fn1, 1), maxslope);
+			maxslope = _mm_min_ps(FACE_NORMALS_Y(fn1, 2), maxslope);
+			maxslope = _mm_min_ps(FACE_NORMALS_Y(fn1, 3), maxslope);
+
+			#undef FACE_NORMALS_Y
+
+			const __m128 lerp = _mm_div_ps(maxslope, avgslope);
+			const __m128 slope = _mm_add_ps(maxslope, _mm_mul_ps(_mm_sub_ps(avgslope, maxslope), lerp));
+
+			_mm_storeu_ps(&slopeMap[y * gs->hmapx + x], _mm_sub_ps(_mm_set1_ps(1.0f), slope));
+		}
+	#endif
 
-	for (int y = sy; y <= ey; y++) {
-		for (int x = sx; x <= ex; x++) {
+		for (; x <= rect.x2; x++) {
 			const int idx0 = (y*2    ) * (gs->mapx) + x*2;
 			const int idx1 = (y*2 + 1) * (gs->mapx) + x*2;
 
@@ -167,6 +167,8 @@ public:
 	unsigned int GetMapChecksum() const { return mapChecksum; }
 
 private:
+	// these update exactly the (inclusive) given rectangle, which is
+	// one tile of the full update for all but UpdateMipHeightmaps
 	void UpdateCenterHeightmap(const SRectangle& rect, bool initialize);
 	void UpdateMipHeightmaps(const SRectangle& rect, bool initialize);
 	void UpdateFaceNormals(const SRectangle& rect, bool initialize);
@@ -93,6 +93,13 @@ enum EVENT
 	 * (uchar teamnumber), CTeam::Statistics(in binary form)
 	 */
 	GAME_TEAMSTAT = NETMSG_TEAMSTAT, // should be 60
+
+	/**
+	 * @brief sim load of a client over its last SimTelemetryInterval frames
+	 * @see SimTelemetry for the layout
+	 * (uchar playernumber), SimTelemetry(in binary form)
+	 */
+	GAME_SIMTELEMETRY = NETMSG_SIM_TELEMETRY, // should be 78
 };
 }
 
@@ -14,6 +14,8 @@ GameParticipant::GameParticipant()
 , isLocal(false)
 , isReconn(false)
 , isMidgameJoin(false)
+, isCatchingUp(false)
+, packetCacheSegment(0)
 {
 	linkData[MAX_AIS] = PlayerLinkData(false);
 }
@@ -44,6 +46,7 @@ void GameParticipant::Kill(const std::string& reason, const bool flush)
 		link.reset();
 	}
 	linkData[MAX_AIS].link.reset();
+	isCatchingUp = false;
 #ifdef SYNCCHECK
 	syncResponse.clear();
 #endif
@@ -41,6 +41,10 @@ public:
 	bool isLocal;
 	bool isReconn;
 	bool isMidgameJoin;
+	/// true while the packet-cache is still being sent, see CGameServer::SendPacketCache
+	bool isCatchingUp;
+	/// next packet-cache segment to send while catching up
+	unsigned int packetCacheSegment;
 	boost::shared_ptr<netcode::CConnection> link;
 	PlayerStatistics lastStats;
 
@@ -65,6 +65,8 @@
 
 #define ALLOW_DEMO_GODMODE
 #define PKTCACHE_VECSIZE 1000
+// segments sent to each catching-up client per server update
+#define PKTCACHE_SEGMENTS_PER_UPDATE 4
 
 using netcode::RawPacket;
 using boost::format;
@@ -79,6 +81,8 @@ CONFIG(bool, ServerRecordDemos).defaultValue(false).dedicatedValue(true);
 CONFIG(bool, ServerLogInfoMessages).defaultValue(false);
 CONFIG(bool, ServerLogDebugMessages).defaultValue(false);
 CONFIG(std::string, AutohostIP).defaultValue("127.0.0.1");
+CONFIG(bool, ServerIOThreads).defaultValue(false).dedicatedValue(true)
+	.description("Receive and send network packets on dedicated threads, so socket I/O does not stall the server's frame generation.");
 
 
 // use the specific section for all LOG*() calls in this source file
@@ -161,6 +165,7 @@ CGameServer::CGameServer(const std::string& hostIP, int hostPort, const GameData
 , canReconnect(false)
 , allowSpecDraw(true)
 
+, packetCache(PKTCACHE_VECSIZE)
 , syncErrorFrame(0)
 , syncWarningFrame(0)
 
@@ -181,6 +186,9 @@ CGameServer::CGameServer(const std::string& hostIP, int hostPort, const GameData
 
 	if (!setup->onlyLocal) {
 		UDPNet.reset(new netcode::UDPListener(hostPort, hostIP));
+
+		if (configHandler->GetBool("ServerIOThreads"))
+			UDPNet->StartIOThreads();
 	}
 
 	AddAutohostInterface(StringToLower(configHandler->GetString("AutohostIP")), configHandler->GetInt("AutohostPort"));
@@ -622,10 +630,17 @@ bool CGameServer::SendDemoData(int targetFrameNum)
 
 void CGameServer::Broadcast(boost::shared_ptr<const netcode::RawPacket> packet)
 {
-	for (size_t p = 0; p < players.size(); ++p)
+	const bool cachePacket = (canReconnect || allowSpecJoin || !gameHasStarted);
+
+	for (size_t p = 0; p < players.size(); ++p) {
+		// players still catching up receive it in order from the cache
+		if (cachePacket && players[p].isCatchingUp)
+			continue;
+
 		players[p].SendData(packet);
+	}
 
-	if (canReconnect || allowSpecJoin || !gameHasStarted)
+	if (cachePacket)
 		AddToPacketCache(packet);
 
 	if (demoRecorder != NULL)
@@ -814,6 +829,8 @@ void CGameServer::Update()
 	gameTime += tdif;
 	lastUpdate = spring_gettime();
 
+	SendPacketCache(false);
+
 	if (!isPaused && gameHasStarted) {
 		// if we are not playing a demo, or have no local client, or the
 		// local client is less than <GAME_SPEED> frames behind, advance
@@ -1703,6 +1720,16 @@ void CGameServer::ProcessPacket(const unsigned playerNum, boost::shared_ptr<cons
 			break;
 		}
 
+		case NETMSG_SIM_TELEMETRY: {
+			if (inbuf[1] != a) {
+				Message(str(format(WrongPlayer) %msgCode %a %(unsigned)inbuf[1]));
+				break;
+			}
+			if (hostif)
+				hostif->Send(packet->data, packet->length);
+			break;
+		}
+
 		case NETMSG_GAMEOVER: {
 			try {
 				// msgCode + msgSize + playerNum (all uchar's)
@@ -1984,8 +2011,10 @@ void CGameServer::StartGame(bool forced)
 	assert(!gameHasStarted);
 	gameHasStarted = true;
 	startTime = gameTime;
-	if (!canReconnect && !allowSpecJoin)
-		packetCache.clear(); // free memory
+	if (!canReconnect && !allowSpecJoin) {
+		SendPacketCache(true);
+		packetCache.Clear(); // free memory
+	}
 
 	if (UDPNet && !canReconnect && !allowSpecJoin)
 		UDPNet->SetAcceptingConnections(false); // do not accept new connections
@@ -2456,14 +2485,21 @@ void CGameServer::UpdateLoop()
 		Threading::SetThreadName("netcode");
 		Threading::SetAffinity(~0);
 
-		//FIXME use async callback funcs in boost udp sockets and so get rid of any latency & remove netcode thread
 		while (!quitServer) {
-			spring_sleep(spring_msecs(5));
+			// with I/O threads this wakes up as soon as packets arrive
+			if (UDPNet) {
+				UDPNet->WaitForData(spring_msecs(5));
+			} else {
+				spring_sleep(spring_msecs(5));
+			}
+
+			Threading::RecursiveScopedLock scoped_lock(gameServerMutex);
 
+			// only dispatches queued datagrams when using I/O threads,
+			// keep it inside the lock since it also flushes connections
 			if (UDPNet)
 				UDPNet->Update();
 
-			Threading::RecursiveScopedLock scoped_lock(gameServerMutex);
 			ServerReadNet();
 			Update();
 		}
@@ -2483,6 +2519,9 @@ void CGameServer::UpdateLoop()
 
 		// now let clients close their connections
 		spring_sleep(spring_msecs(3000));
+
+		if (UDPNet)
+			UDPNet->StopIOThreads();
 	} CATCH_SPRING_ERRORS
 }
 
@@ -2700,9 +2739,11 @@ unsigned CGameServer::BindConnection(std::string name, const std::string& passwd
 	newPlayer.SendData(CBaseNetProtocol::Get().SendSetPlayerNum((unsigned char)newPlayerNumber));
 
 	// after gamedata and playerNum, the player can start loading
-	for (std::list< std::vector<boost::shared_ptr<const netcode::RawPacket> > >::const_iterator lit = packetCache.begin(); lit != packetCache.end(); ++lit)
-		for (std::vector<boost::shared_ptr<const netcode::RawPacket> >::const_iterator vit = lit->begin(); vit != lit->end(); ++vit)
-			newPlayer.SendData(*vit); // throw at him all stuff he missed until now
+	// throw at him all stuff he missed until now, a few segments
+	// per update so a late-game join does not stall the server
+	newPlayer.isCatchingUp = true;
+	newPlayer.packetCacheSegment = 0;
+	SendPacketCache(false);
 
 	if (demoReader == NULL || setup->demoName.empty()) { // gamesetup from demo?
 		if (!newPlayer.spectator) {
@@ -2786,9 +2827,38 @@ void CGameServer::FreeSkirmishAIId(const unsigned char skirmishAIId)
 
 void CGameServer::AddToPacketCache(boost::shared_ptr<const netcode::RawPacket> &pckt)
 {
-	if (packetCache.empty() || packetCache.back().size() >= PKTCACHE_VECSIZE) {
-		packetCache.push_back(std::vector<boost::shared_ptr<const netcode::RawPacket> >());
-		packetCache.back().reserve(PKTCACHE_VECSIZE);
+	packetCache.Add(pckt);
+}
+
+void CGameServer::SendPacketCache(bool finish)
+{
+	for (size_t p = 0; p < players.size(); ++p) {
+		GameParticipant& player = players[p];
+
+		if (!player.isCatchingUp)
+			continue;
+
+		const CPacketCache::PacketFunc sendFunc = std::bind(&GameParticipant::SendData, &player, std::placeholders::_1);
+
+		CPacketCache::SendResult result = CPacketCache::SEND_MORE;
+
+		for (unsigned int n = 0; (finish || n < PKTCACHE_SEGMENTS_PER_UPDATE) && result == CPacketCache::SEND_MORE; n++) {
+			result = packetCache.SendSegment(player.packetCacheSegment, sendFunc);
+		}
+
+		if (result == CPacketCache::SEND_MORE)
+			continue;
+
+		player.isCatchingUp = false;
+
+		if (result == CPacketCache::SEND_DONE)
+			continue;
+
+		// skipping the segment would leave the client with a stream it desyncs on
+		Message(str(format(PlayerLeft) %player.GetType() %player.name %" missing game data"));
+		Broadcast(CBaseNetProtocol::Get().SendPlayerLeft(p, 0));
+		player.Kill("Server failed to send the game history");
+		if (hostif)
+			hostif->SendPlayerLeft(p, 0);
 	}
-	packetCache.back().push_back(pckt);
 }
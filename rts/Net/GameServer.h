@@ -13,6 +13,7 @@
 #include <list>
 
 #include "Game/GameData.h"
+#include "Net/PacketCache.h"
 #include "Sim/Misc/TeamBase.h"
 #include "System/UnsyncedRNG.h"
 #include "System/float3.h"
@@ -161,6 +162,8 @@ private:
 	void PrivateMessage(int playerNum, const std::string& message);
 
 	void AddToPacketCache(boost::shared_ptr<const netcode::RawPacket>& pckt);
+	/// sends the next few packet-cache segments (or all of them) to catching-up players
+	void SendPacketCache(bool finish);
 
 	bool AdjustPlayerNumber(netcode::RawPacket* buf, int pos, int val = -1);
 	void UpdatePlayerNumberMap();
@@ -227,7 +230,7 @@ private:
 	bool logInfoMessages;
 	bool logDebugMessages;
 
-	std::list< std::vector<boost::shared_ptr<const netcode::RawPacket> > > packetCache;
+	CPacketCache packetCache;
 
 	/////////////////// sync stuff ///////////////////
 #ifdef SYNCCHECK
@@ -0,0 +1,131 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "PacketCache.h"
+
+#include <zlib.h>
+#include <cstring>
+
+#include "System/Net/RawPacket.h"
+#include "System/Log/ILog.h"
+
+using netcode::RawPacket;
+
+
+CPacketCache::CPacketCache(unsigned int segmentSize)
+	: segmentSize(segmentSize)
+	, numPackets(0)
+	, openSegmentBytes(0)
+{
+	openSegment.reserve(segmentSize);
+}
+
+
+void CPacketCache::Add(boost::shared_ptr<const RawPacket> packet)
+{
+	openSegment.push_back(packet);
+	openSegmentBytes += (packet->length + sizeof(boost::uint32_t));
+	numPackets += 1;
+
+	if (openSegment.size() >= segmentSize)
+		Compact();
+}
+
+void CPacketCache::Clear()
+{
+	segments.clear();
+	openSegment.clear();
+	numPackets = 0;
+	openSegmentBytes = 0;
+}
+
+
+void CPacketCache::Compact()
+{
+	std::vector<boost::uint8_t> raw(openSegmentBytes);
+	boost::uint8_t* pos = &raw[0];
+
+	for (size_t n = 0; n < openSegment.size(); ++n) {
+		const boost::uint32_t length = openSegment[n]->length;
+
+		memcpy(pos, &length, sizeof(length)); pos += sizeof(length);
+		memcpy(pos, openSegment[n]->data, length); pos += length;
+	}
+
+	segments.push_back(Segment());
+	Segment& segment = segments.back();
+
+	uLongf compressedSize = compressBound(raw.size());
+	segment.data.resize(compressedSize);
+	segment.rawSize = raw.size();
+
+	// favour speed, this runs on the server thread
+	if (compress2(&segment.data[0], &compressedSize, &raw[0], raw.size(), Z_BEST_SPEED) == Z_OK) {
+		segment.data.resize(compressedSize);
+		// shrink_to_fit
+		std::vector<boost::uint8_t>(segment.data).swap(segment.data);
+	} else {
+		// keep the packets uncompressed rather than losing them
+		LOG_L(L_WARNING, "[PacketCache::%s] failed to compress %u bytes", __FUNCTION__, segment.rawSize);
+		segment.data.swap(raw);
+		segment.rawSize = 0;
+	}
+
+	openSegment.clear();
+	openSegmentBytes = 0;
+}
+
+
+CPacketCache::SendResult CPacketCache::SendSegment(unsigned int& segmentIdx, const PacketFunc& f) const
+{
+	if (segmentIdx >= segments.size()) {
+		for (size_t n = 0; n < openSegment.size(); ++n) {
+			f(openSegment[n]);
+		}
+
+		segmentIdx = segments.size();
+		return SEND_DONE;
+	}
+
+	const Segment& segment = segments[segmentIdx];
+
+	const boost::uint8_t* pos = &segment.data[0];
+	const boost::uint8_t* end = pos + segment.data.size();
+
+	std::vector<boost::uint8_t> raw;
+
+	if (segment.rawSize != 0) {
+		uLongf rawSize = segment.rawSize;
+		raw.resize(rawSize);
+
+		if (uncompress(&raw[0], &rawSize, &segment.data[0], segment.data.size()) != Z_OK || rawSize != segment.rawSize) {
+			LOG_L(L_ERROR, "[PacketCache::%s] corrupt segment %u (%u bytes)", __FUNCTION__, segmentIdx, segment.rawSize);
+			return SEND_FAIL;
+		}
+
+		pos = &raw[0];
+		end = pos + rawSize;
+	}
+
+	while (pos < end) {
+		boost::uint32_t length;
+		memcpy(&length, pos, sizeof(length)); pos += sizeof(length);
+
+		f(boost::shared_ptr<const RawPacket>(new RawPacket(pos, length)));
+		pos += length;
+	}
+
+	segmentIdx += 1;
+	return SEND_MORE;
+}
+
+
+size_t CPacketCache::GetMemoryUsage() const
+{
+	size_t bytes = openSegmentBytes;
+
+	for (std::deque<Segment>::const_iterator sit = segments.begin(); sit != segments.end(); ++sit) {
+		bytes += sit->data.size();
+	}
+
+	return bytes;
+}
@@ -0,0 +1,76 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _PACKET_CACHE_H
+#define _PACKET_CACHE_H
+
+#include <boost/shared_ptr.hpp>
+#include <boost/cstdint.hpp>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace netcode
+{
+	class RawPacket;
+}
+
+/**
+ * @brief Every packet the server broadcast since the game started
+ * Needed to bring reconnecting and mid-game joining clients up to date.
+ * Only the most recent segment keeps the packets as they were sent, full
+ * segments are compacted into a single zlib-compressed buffer. The cache
+ * still grows with the length of the game (nothing can be dropped without
+ * breaking late joins), compression only lowers the cost per packet.
+ *
+ * Clients catch up one segment at a time through SendSegment, so only a
+ * single segment is ever decompressed at once.
+ */
+class CPacketCache
+{
+public:
+	typedef std::function<void(boost::shared_ptr<const netcode::RawPacket>)> PacketFunc;
+
+	CPacketCache(unsigned int segmentSize = 1000);
+
+	void Add(boost::shared_ptr<const netcode::RawPacket> packet);
+	void Clear();
+
+	enum SendResult {
+		SEND_MORE, ///< more segments follow
+		SEND_DONE, ///< the open segment was sent, the client is caught up
+		SEND_FAIL, ///< the segment could not be decompressed, nothing was sent
+	};
+
+	/**
+	 * calls <f> for every packet of the segment at <segmentIdx> and advances
+	 * it to the next one; once past the compacted segments this sends the
+	 * open segment. <segmentIdx> is left unchanged on failure, since a client
+	 * missing any packet would desync.
+	 */
+	SendResult SendSegment(unsigned int& segmentIdx, const PacketFunc& f) const;
+
+	bool Empty() const { return (numPackets == 0); }
+	unsigned int GetNumPackets() const { return numPackets; }
+	/// bytes held by the cache, not counting container overhead
+	size_t GetMemoryUsage() const;
+
+private:
+	/// moves the open segment into a compressed one
+	void Compact();
+
+private:
+	struct Segment {
+		/// zlib-compressed sequence of [uint32 length][data]
+		std::vector<boost::uint8_t> data;
+		unsigned int rawSize;
+	};
+
+	std::deque<Segment> segments;
+	std::vector< boost::shared_ptr<const netcode::RawPacket> > openSegment;
+
+	unsigned int segmentSize;
+	unsigned int numPackets;
+	size_t openSegmentBytes;
+};
+
+#endif // _PACKET_CACHE_H
@@ -3,6 +3,7 @@
 #include "BaseNetProtocol.h"
 
 #include "Game/Players/PlayerStatistics.h"
+#include "Game/SimTelemetry.h"
 #include "Sim/Misc/TeamStatistics.h"
 #include "System/Net/RawPacket.h"
 #include "System/Net/PackPacket.h"
@@ -25,6 +26,13 @@ PacketType CBaseNetProtocol::SendKeyFrame(int frameNum)
 	return PacketType(packet);
 }
 
+PacketType CBaseNetProtocol::SendSimTelemetry(uchar myPlayerNum, const SimTelemetry& record)
+{
+	PackPacket* packet = new PackPacket(2 + sizeof(SimTelemetry), NETMSG_SIM_TELEMETRY);
+	*packet << myPlayerNum << record;
+	return PacketType(packet);
+}
+
 PacketType CBaseNetProtocol::SendNewFrame()
 {
 	return PacketType(new PackPacket(1, NETMSG_NEWFRAME));
@@ -487,6 +495,7 @@ CBaseNetProtocol::CBaseNetProtocol()
 	proto->AddType(NETMSG_AI_CREATED, -1);
 	proto->AddType(NETMSG_AI_STATE_CHANGED, 4);
 	proto->AddType(NETMSG_GAME_FRAME_PROGRESS,5);
+	proto->AddType(NETMSG_SIM_TELEMETRY, 2 + sizeof(SimTelemetry));
 
 #ifdef SYNCDEBUG
 	proto->AddType(NETMSG_SD_CHKREQUEST, 5);
@@ -16,6 +16,7 @@ namespace netcode
 	class RawPacket;
 }
 struct PlayerStatistics;
+struct SimTelemetry;
 
 
 static const unsigned short NETWORK_VERSION = atoi(SpringVersion::GetMajor().c_str());
@@ -105,6 +106,8 @@ enum NETMSG {
 
 	NETMSG_GAME_FRAME_PROGRESS= 77, // int frameNum # this special packet skips queue & cache entirely, indicates current game progress for clients fast-forwarding to current point the game #
 
+	NETMSG_SIM_TELEMETRY    = 78, // uchar myPlayerNum, struct SimTelemetry record   # passed on to the autohost #
+
 
 	NETMSG_LAST //max types of netmessages, internal only
 };
@@ -181,6 +184,7 @@ public:
 	PacketType SendPlayerLeft(uchar myPlayerNum, uchar bIntended);
 	PacketType SendLuaMsg(uchar myPlayerNum, unsigned short script, uchar mode, const std::vector<boost::uint8_t>& msg);
 	PacketType SendCurrentFrameProgress(int frameNum);
+	PacketType SendSimTelemetry(uchar myPlayerNum, const SimTelemetry& record);
 
 	PacketType SendGiveAwayEverything(uchar myPlayerNum, uchar giveToTeam);
 	/**
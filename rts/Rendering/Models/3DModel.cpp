@@ -22,8 +22,7 @@ CR_REG_METADATA(LocalModelPiece, (
 	CR_MEMBER(pieceSpaceMat),
 	CR_MEMBER(modelSpaceMat),
 	CR_MEMBER(colvol),
-	CR_MEMBER(numUpdatesSynced),
-	CR_MEMBER(lastMatrixUpdate),
+	CR_MEMBER(dirty),
 	CR_MEMBER(scriptSetVisible),
 	CR_MEMBER(identityTransform),
 	CR_MEMBER(lmodelPieceIndex),
@@ -40,9 +39,10 @@ CR_REG_METADATA(LocalModelPiece, (
 
 CR_BIND(LocalModel, (NULL))
 CR_REG_METADATA(LocalModel, (
-	CR_IGNORED(dirtyPieces),
+	CR_IGNORED(firstDirtyPiece),
 	CR_IGNORED(lodCount), //FIXME?
-	CR_MEMBER(pieces)
+	CR_MEMBER(pieces),
+	CR_IGNORED(updatedPieces)
 ))
 
 
@@ -142,6 +142,26 @@ void LocalModel::DrawPiecesLOD(unsigned int lod) const
 	}
 }
 
+void LocalModel::UpdatePieceMatrices()
+{
+	// pieces are in depth-first order, so one forward pass
+	// sees every parent before its children and only has to
+	// visit the pieces after the first dirty one
+	if (firstDirtyPiece >= pieces.size())
+		return;
+
+	for (unsigned int n = firstDirtyPiece; n < pieces.size(); n++) {
+		LocalModelPiece* lmp = pieces[n];
+
+		const bool parentUpdated = (lmp->parent != NULL && updatedPieces[lmp->parent->GetLModelPieceIndex()] != 0);
+
+		updatedPieces[n] = lmp->UpdateModelSpaceMatrix(parentUpdated);
+	}
+
+	std::fill(updatedPieces.begin() + firstDirtyPiece, updatedPieces.end(), 0);
+	firstDirtyPiece = pieces.size();
+}
+
 void LocalModel::SetLODCount(unsigned int count)
 {
 	pieces[0]->SetLODCount(lodCount = count);
@@ -188,8 +208,7 @@ LocalModelPiece* LocalModel::CreateLocalModelPieces(const S3DModelPiece* mpParen
 LocalModelPiece::LocalModelPiece(const S3DModelPiece* piece)
 	: colvol(new CollisionVolume(piece->GetCollisionVolume()))
 
-	, numUpdatesSynced(1)
-	, lastMatrixUpdate(0)
+	, dirty(true)
 
 	, scriptSetVisible(piece->HasGeometryData())
 	, identityTransform(true)
@@ -223,23 +242,35 @@ bool LocalModelPiece::UpdateMatrix()
 
 void LocalModelPiece::UpdateMatricesRec(bool updateChildMatrices)
 {
-	if (lastMatrixUpdate != numUpdatesSynced) {
-		lastMatrixUpdate = numUpdatesSynced;
+	updateChildMatrices = UpdateModelSpaceMatrix(updateChildMatrices);
+
+	for (unsigned int i = 0; i < children.size(); i++) {
+		children[i]->UpdateMatricesRec(updateChildMatrices);
+	}
+}
+
+/**
+ * Recomposes pieceSpaceMat if the piece is dirty and modelSpaceMat if
+ * either it or its parent's modelSpaceMat changed; the parent has to be
+ * up-to-date already. Returns whether modelSpaceMat was updated.
+ */
+bool LocalModelPiece::UpdateModelSpaceMatrix(bool parentUpdated)
+{
+	if (dirty) {
+		dirty = false;
 		identityTransform = UpdateMatrix();
-		updateChildMatrices = true;
+	} else if (!parentUpdated) {
+		return false;
 	}
 
-	if (updateChildMatrices) {
+	if (parent != NULL) {
+		// SSE matrix-matrix product, same as copying and applying >>=
+		modelSpaceMat = parent->modelSpaceMat * pieceSpaceMat;
+	} else {
 		modelSpaceMat = pieceSpaceMat;
-
-		if (parent != NULL) {
-			modelSpaceMat >>= parent->modelSpaceMat;
-		}
 	}
 
-	for (unsigned int i = 0; i < children.size(); i++) {
-		children[i]->UpdateMatricesRec(updateChildMatrices);
-	}
+	return true;
 }
 
 
@@ -3,6 +3,7 @@
 #ifndef _3DMODEL_H
 #define _3DMODEL_H
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <set>
@@ -240,12 +241,13 @@ struct LocalModelPiece
 
 	bool UpdateMatrix();
 	void UpdateMatricesRec(bool updateChildMatrices);
+	bool UpdateModelSpaceMatrix(bool parentUpdated);
 
 	bool GetEmitDirPos(float3& pos, float3& dir) const;
 	float3 GetAbsolutePos() const;
 
-	void SetPosition(const float3& p) { pos = p; ++numUpdatesSynced; }
-	void SetRotation(const float3& r) { rot = r; ++numUpdatesSynced; }
+	void SetPosition(const float3& p) { pos = p; dirty = true; }
+	void SetRotation(const float3& r) { rot = r; dirty = true; }
 	void SetDirection(const float3& d) { dir = d; } // unused
 
 	const float3& GetPosition() const { return pos; }
@@ -268,8 +270,7 @@ private:
 
 	CollisionVolume* colvol;
 
-	unsigned numUpdatesSynced; // triggers UpdateMatrix (via UpdateMatricesRec) if != lastMatrixUpdate
-	unsigned lastMatrixUpdate;
+	bool dirty; // true IFF pos or rot changed since pieceSpaceMat was last composed
 
 public:
 	bool scriptSetVisible;  // TODO: add (visibility) maxradius!
@@ -292,13 +293,14 @@ struct LocalModel
 	CR_DECLARE_STRUCT(LocalModel)
 
 	LocalModel(const S3DModel* model)
-		: dirtyPieces(model->numPieces)
+		: firstDirtyPiece(0)
 		, lodCount(0)
 	{
 		assert(model->numPieces >= 1);
 		pieces.reserve(model->numPieces);
 		CreateLocalModelPieces(model->GetRootPiece());
 		assert(pieces.size() == model->numPieces);
+		updatedPieces.resize(pieces.size(), 0);
 	}
 
 	~LocalModel()
@@ -322,20 +324,14 @@ struct LocalModel
 		DrawPiecesLOD(lod);
 	}
 
-	void UpdatePieceMatrices() {
-		if (dirtyPieces > 0) {
-			pieces[0]->UpdateMatricesRec(false);
-		}
-		dirtyPieces = 0;
-	}
-
+	void UpdatePieceMatrices();
 
 
 	void DrawPieces() const;
 	void DrawPiecesLOD(unsigned int lod) const;
 
 	void SetLODCount(unsigned int count);
-	void PieceUpdated(unsigned int pieceIdx) { dirtyPieces += 1; }
+	void PieceUpdated(const LocalModelPiece* lmp) { firstDirtyPiece = std::min(firstDirtyPiece, lmp->GetLModelPieceIndex()); }
 
 	void ReloadDisplayLists();
 
@@ -354,11 +350,15 @@ private:
 	LocalModelPiece* CreateLocalModelPieces(const S3DModelPiece* mpParent);
 
 public:
-	// increased by UnitScript whenever a piece is transformed
-	unsigned int dirtyPieces;
+	// lowest index of a piece transformed by UnitScript since the
+	// last update, pieces.size() if none; since <pieces> is stored
+	// in depth-first order no piece before it needs to be updated
+	unsigned int firstDirtyPiece;
 	unsigned int lodCount;
 
 	std::vector<LocalModelPiece*> pieces;
+	// per-piece scratch flags for UpdatePieceMatrices
+	std::vector<unsigned char> updatedPieces;
 };
 
 #endif /* _3DMODEL_H */
@@ -35,7 +35,6 @@ static void RegisterAssimpModelFormats(C3DModelLoader::FormatMap& formats) {
 	std::set<std::string> whitelist;
 	std::string extension;
 	std::string extensions;
-	std::string enabledExtensions;
 
 	whitelist.insert("3ds"  ); // 3DSMax
 	whitelist.insert("dae"  ); // Collada
@@ -66,29 +65,30 @@ static void RegisterAssimpModelFormats(C3DModelLoader::FormatMap& formats) {
 			continue;
 
 		formats[extension] = MODELTYPE_ASS;
-		enabledExtensions += "*." + extension + ";";
 	}
-
-	LOG("[%s] supported Assimp model formats: %s", __FUNCTION__, enabledExtensions.c_str());
 }
 
 
 
 C3DModelLoader::C3DModelLoader()
 {
-	// file-extension should be lowercase
-	formats["3do"] = MODELTYPE_3DO;
-	formats["s3o"] = MODELTYPE_S3O;
-	formats["obj"] = MODELTYPE_OBJ;
+	GetFormats(formats);
+
+	std::string assimpExtensions;
+
+	for (FormatMap::const_iterator it = formats.begin(); it != formats.end(); ++it) {
+		if (it->second == MODELTYPE_ASS) {
+			assimpExtensions += "*." + it->first + ";";
+		}
+	}
+
+	LOG("[%s] supported Assimp model formats: %s", __FUNCTION__, assimpExtensions.c_str());
 
 	parsers[MODELTYPE_3DO] = new C3DOParser();
 	parsers[MODELTYPE_S3O] = new CS3OParser();
 	parsers[MODELTYPE_OBJ] = new COBJParser();
 	parsers[MODELTYPE_ASS] = new CAssParser();
 
-	// FIXME: unify the metadata formats of CAssParser and COBJParser
-	RegisterAssimpModelFormats(formats);
-
 	// dummy first model, model IDs start at 1
 	models.reserve(32);
 	models.push_back(NULL);
@@ -149,7 +149,18 @@ void CheckModelNormals(const S3DModel* model) {
 }
 
 
-std::string C3DModelLoader::FindModelPath(std::string name) const
+void C3DModelLoader::GetFormats(FormatMap& formats)
+{
+	// file-extension should be lowercase
+	formats["3do"] = MODELTYPE_3DO;
+	formats["s3o"] = MODELTYPE_S3O;
+	formats["obj"] = MODELTYPE_OBJ;
+
+	// FIXME: unify the metadata formats of CAssParser and COBJParser
+	RegisterAssimpModelFormats(formats);
+}
+
+std::string C3DModelLoader::FindModelPath(std::string name, const FormatMap& formats)
 {
 	// check for empty string because we can be called
 	// from Lua*Defs and certain features have no models
@@ -168,7 +179,7 @@ std::string C3DModelLoader::FindModelPath(std::string name) const
 
 		if (!CFileHandler::FileExists(name, SPRING_VFS_ZIP)) {
 			if (name.find("objects3d/") == std::string::npos) {
-				return FindModelPath("objects3d/" + name);
+				return FindModelPath("objects3d/" + name, formats);
 			}
 		}
 	}
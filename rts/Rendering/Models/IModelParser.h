@@ -28,13 +28,22 @@ public:
 	void CreateLocalModel(LocalModel* model);
 	void DeleteLocalModel(LocalModel* model);
 
-	std::string FindModelPath(std::string name) const;
-	S3DModel* Load3DModel(std::string modelName);
-
 	typedef std::map<std::string, unsigned int> ModelMap; // "armflash.3do" --> id
 	typedef std::map<std::string, unsigned int> FormatMap; // "3do" --> MODELTYPE_3DO
 	typedef std::map<unsigned int, IModelParser*> ParserMap; // MODELTYPE_3DO --> parser
 
+	std::string FindModelPath(std::string name) const { return FindModelPath(name, formats); }
+	S3DModel* Load3DModel(std::string modelName);
+
+	/// fills <formats> with every model format the loader supports
+	static void GetFormats(FormatMap& formats);
+	/**
+	 * Returns the VFS path of model <name>, trying the extensions in <formats>
+	 * in order if it has none and "objects3d/" if it is not found as given.
+	 * Safe to call from any thread.
+	 */
+	static std::string FindModelPath(std::string name, const FormatMap& formats);
+
 private:
 	void AddModelToCache(S3DModel* model, const std::string& modelName, const std::string& modelPath);
 	void CreateLists(S3DModelPiece* o);
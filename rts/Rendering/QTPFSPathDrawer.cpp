@@ -52,13 +52,14 @@ void QTPFSPathDrawer::DrawAll() const {
 }
 
 void QTPFSPathDrawer::DrawNodeTree(const MoveDef* md) const {
-	QTPFS::QTNode* nt = pm->nodeTrees[md->pathType];
+	const QTPFS::QTNode* nt = pm->nodeTrees[md->pathType];
+	const QTPFS::NodeLayer& nl = pm->nodeLayers[md->pathType];
 	CVertexArray* va = GetVertexArray();
 
 	std::list<const QTPFS::QTNode*> nodes;
 	std::list<const QTPFS::QTNode*>::const_iterator nodesIt;
 
-	GetVisibleNodes(nt, nodes);
+	GetVisibleNodes(nt, nl, nodes);
 
 	va->Initialize();
 	va->EnlargeArrays(nodes.size() * 4, 0, VA_SIZE_C);
@@ -76,38 +77,39 @@ void QTPFSPathDrawer::DrawNodeTree(const MoveDef* md) const {
 
 void QTPFSPathDrawer::DrawNodeTreeRec(
 	const QTPFS::QTNode* nt,
+	const QTPFS::NodeLayer& nl,
 	const MoveDef* md,
 	CVertexArray* va
 ) const {
 	if (nt->IsLeaf()) {
 		DrawNode(nt, md, va, false, true, false);
 	} else {
-		for (unsigned int i = 0; i < nt->children.size(); i++) {
-			const QTPFS::QTNode* n = nt->children[i];
+		for (unsigned int i = 0; i < 4; i++) {
+			const QTPFS::QTNode* n = nl.GetPoolNode(nt->GetChildIndex(i));
 			const float3 mins = float3(n->xmin() * SQUARE_SIZE, 0.0f, n->zmin() * SQUARE_SIZE);
 			const float3 maxs = float3(n->xmax() * SQUARE_SIZE, 0.0f, n->zmax() * SQUARE_SIZE);
 
 			if (!camera->InView(mins, maxs))
 				continue;
 
-			DrawNodeTreeRec(nt->children[i], md, va);
+			DrawNodeTreeRec(n, nl, md, va);
 		}
 	}
 }
 
-void QTPFSPathDrawer::GetVisibleNodes(const QTPFS::QTNode* nt, std::list<const QTPFS::QTNode*>& nodes) const {
+void QTPFSPathDrawer::GetVisibleNodes(const QTPFS::QTNode* nt, const QTPFS::NodeLayer& nl, std::list<const QTPFS::QTNode*>& nodes) const {
 	if (nt->IsLeaf()) {
 		nodes.push_back(nt);
 	} else {
-		for (unsigned int i = 0; i < nt->children.size(); i++) {
-			const QTPFS::QTNode* n = nt->children[i];
+		for (unsigned int i = 0; i < 4; i++) {
+			const QTPFS::QTNode* n = nl.GetPoolNode(nt->GetChildIndex(i));
 			const float3 mins = float3(n->xmin() * SQUARE_SIZE, 0.0f, n->zmin() * SQUARE_SIZE);
 			const float3 maxs = float3(n->xmax() * SQUARE_SIZE, 0.0f, n->zmax() * SQUARE_SIZE);
 
 			if (!camera->InView(mins, maxs))
 				continue;
 
-			GetVisibleNodes(nt->children[i], nodes);
+			GetVisibleNodes(n, nl, nodes);
 		}
 	}
 }
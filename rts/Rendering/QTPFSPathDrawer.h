@@ -13,6 +13,7 @@ namespace QTPFS {
 	class PathManager;
 
 	struct QTNode;
+	struct NodeLayer;
 	struct IPath;
 	struct PathSearch;
 
@@ -38,11 +39,12 @@ private:
 	void DrawNodeTree(const MoveDef* md) const;
 	void DrawNodeTreeRec(
 		const QTPFS::QTNode* nt,
+		const QTPFS::NodeLayer& nl,
 		const MoveDef* md,
 		CVertexArray* va
 	) const;
 
-	void GetVisibleNodes(const QTPFS::QTNode* nt, std::list<const QTPFS::QTNode*>& nodes) const;
+	void GetVisibleNodes(const QTPFS::QTNode* nt, const QTPFS::NodeLayer& nl, std::list<const QTPFS::QTNode*>& nodes) const;
 
 	void DrawPaths(const MoveDef* md) const;
 	void DrawPath(const QTPFS::IPath* path, CVertexArray* va) const;
@@ -1,6 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 #include <assert.h>
+#include <algorithm>
 
 #include "GroundBlockingObjectMap.h"
 
@@ -9,17 +10,187 @@
 #include "Sim/Objects/SolidObject.h"
 #include "Sim/Objects/SolidObjectDef.h"
 #include "Sim/Path/IPathManager.h"
-#include "System/creg/STL_Map.h"
 
 CGroundBlockingObjectMap* groundBlockingObjectMap;
 
 CR_BIND(CGroundBlockingObjectMap, (1))
 CR_REG_METADATA(CGroundBlockingObjectMap, (
-	CR_MEMBER(groundBlockingMap)
+	CR_IGNORED(groundBlockingMap),
+	CR_IGNORED(occupiedSquares),
+	CR_IGNORED(loadedEntries),
+	CR_POSTLOAD(PostLoad),
+	CR_SERIALIZER(Serialize)
 ))
 
 
 
+BlockingMapCell::BlockingMapCell(const BlockingMapCell& cell)
+	: inlineEntry(cell.inlineEntry)
+	, heapEntries(NULL)
+	, numEntries(cell.numEntries)
+	, maxEntries(cell.maxEntries)
+{
+	if (cell.heapEntries == NULL)
+		return;
+
+	heapEntries = new value_type[maxEntries];
+	std::copy(cell.begin(), cell.end(), heapEntries);
+}
+
+BlockingMapCell& BlockingMapCell::operator = (const BlockingMapCell& cell)
+{
+	if (this == &cell)
+		return *this;
+
+	BlockingMapCell copy(cell);
+
+	std::swap(inlineEntry, copy.inlineEntry);
+	std::swap(heapEntries, copy.heapEntries);
+	std::swap(numEntries, copy.numEntries);
+	std::swap(maxEntries, copy.maxEntries);
+	return *this;
+}
+
+
+unsigned int BlockingMapCell::LowerBound(int objID) const
+{
+	const value_type* entries = GetEntries();
+	unsigned int i = 0;
+
+	// cells rarely hold more than a handful of objects
+	while (i < numEntries && entries[i].first < objID)
+		i++;
+
+	return i;
+}
+
+BlockingMapCell::const_iterator BlockingMapCell::find(int objID) const
+{
+	const unsigned int i = LowerBound(objID);
+
+	if (i < numEntries && GetEntries()[i].first == objID)
+		return (begin() + i);
+
+	return end();
+}
+
+
+void BlockingMapCell::insert(int objID, CSolidObject* obj)
+{
+	const unsigned int i = LowerBound(objID);
+
+	if (i < numEntries && GetEntries()[i].first == objID) {
+		GetEntries()[i].second = obj;
+		return;
+	}
+
+	if (numEntries == maxEntries) {
+		value_type* entries = new value_type[maxEntries * 2];
+
+		std::copy(begin(), end(), entries);
+		delete[] heapEntries;
+
+		heapEntries = entries;
+		maxEntries *= 2;
+	}
+
+	value_type* entries = GetEntries();
+
+	std::copy_backward(entries + i, entries + numEntries, entries + numEntries + 1);
+	entries[i] = value_type(objID, obj);
+	numEntries += 1;
+}
+
+void BlockingMapCell::erase(int objID)
+{
+	const unsigned int i = LowerBound(objID);
+
+	if (i >= numEntries || GetEntries()[i].first != objID)
+		return;
+
+	value_type* entries = GetEntries();
+
+	std::copy(entries + i + 1, entries + numEntries, entries + i);
+	numEntries -= 1;
+
+	if (heapEntries == NULL || numEntries > 1)
+		return;
+
+	// back to inline storage, most objects leave one at a time
+	if (numEntries == 1)
+		inlineEntry = heapEntries[0];
+
+	delete[] heapEntries;
+	heapEntries = NULL;
+	maxEntries = 1;
+}
+
+void BlockingMapCell::clear()
+{
+	delete[] heapEntries;
+
+	heapEntries = NULL;
+	numEntries = 0;
+	maxEntries = 1;
+}
+
+
+
+void CGroundBlockingObjectMap::Serialize(creg::ISerializer* s)
+{
+	int numSquares = groundBlockingMap.size();
+	s->Serialize(&numSquares, sizeof(int));
+
+	if (!s->IsWriting()) {
+		groundBlockingMap.clear();
+		groundBlockingMap.resize(numSquares);
+		occupiedSquares.clear();
+		occupiedSquares.resize(numSquares, false);
+	}
+
+	for (int mapSquare = 0; mapSquare < numSquares; mapSquare++) {
+		BlockingMapCell& cell = groundBlockingMap[mapSquare];
+		int numObjects = cell.size();
+
+		s->Serialize(&numObjects, sizeof(int));
+
+		if (s->IsWriting()) {
+			for (BlockingMapCellIt it = cell.begin(); it != cell.end(); ++it) {
+				int objID = it->first;
+				void* obj = it->second;
+
+				s->Serialize(&objID, sizeof(int));
+				s->SerializeObjectPtr(&obj, it->second->GetClass());
+			}
+		} else {
+			for (int n = 0; n < numObjects; n++) {
+				loadedEntries.push_back(LoadedEntry());
+				LoadedEntry& entry = loadedEntries.back();
+
+				entry.mapSquare = mapSquare;
+				entry.objID = -1;
+				entry.obj = NULL;
+
+				// the pointer may only be fixed up after all objects have
+				// been loaded, so it has to be read into stable storage
+				s->Serialize(&entry.objID, sizeof(int));
+				s->SerializeObjectPtr(&entry.obj, NULL);
+			}
+		}
+	}
+}
+
+void CGroundBlockingObjectMap::PostLoad()
+{
+	for (std::deque<LoadedEntry>::const_iterator it = loadedEntries.begin(); it != loadedEntries.end(); ++it) {
+		InsertObject(it->mapSquare, it->objID, static_cast<CSolidObject*>(it->obj));
+	}
+
+	loadedEntries.clear();
+}
+
+
+
 inline static const int GetObjectID(CSolidObject* obj)
 {
 	const int id = obj->GetBlockingMapID();
@@ -51,8 +222,7 @@ void CGroundBlockingObjectMap::AddGroundBlockingObject(CSolidObject* object)
 
 	for (int zSqr = minZSqr; zSqr < maxZSqr; zSqr++) {
 		for (int xSqr = minXSqr; xSqr < maxXSqr; xSqr++) {
-			BlockingMapCell& cell = groundBlockingMap[xSqr + zSqr * gs->mapx];
-			cell[objID] = object;
+			InsertObject(xSqr + zSqr * gs->mapx, objID, object);
 		}
 	}
 
@@ -82,8 +252,7 @@ void CGroundBlockingObjectMap::AddGroundBlockingObject(CSolidObject* object, con
 			const float3 testPos = float3(x, 0.0f, z) * SQUARE_SIZE;
 
 			if (object->GetGroundBlockingMaskAtPos(testPos) & mask) {
-				BlockingMapCell& cell = groundBlockingMap[x + (z) * gs->mapx];
-				cell[objID] = object;
+				InsertObject(x + z * gs->mapx, objID, object);
 			}
 		}
 	}
@@ -108,10 +277,7 @@ void CGroundBlockingObjectMap::RemoveGroundBlockingObject(CSolidObject* object)
 
 	for (int z = bz; z < bz + sz; ++z) {
 		for (int x = bx; x < bx + sx; ++x) {
-			const int idx = x + z * gs->mapx;
-
-			BlockingMapCell& cell = groundBlockingMap[idx];
-			cell.erase(objID);
+			EraseObject(x + z * gs->mapx, objID);
 		}
 	}
 
@@ -122,18 +288,31 @@ void CGroundBlockingObjectMap::RemoveGroundBlockingObject(CSolidObject* object)
 }
 
 
+void CGroundBlockingObjectMap::InsertObject(int mapSquare, int objID, CSolidObject* obj)
+{
+	groundBlockingMap[mapSquare].insert(objID, obj);
+	occupiedSquares[mapSquare] = true;
+}
+
+void CGroundBlockingObjectMap::EraseObject(int mapSquare, int objID)
+{
+	BlockingMapCell& cell = groundBlockingMap[mapSquare];
+
+	cell.erase(objID);
+	occupiedSquares[mapSquare] = !cell.empty();
+}
+
+
 /**
   * Checks if a ground-square is blocked.
   * If it's not blocked (empty), then NULL is returned. Otherwise, a
   * pointer to the top-most / bottom-most blocking object is returned.
   */
 CSolidObject* CGroundBlockingObjectMap::GroundBlockedUnsafe(int mapSquare) const {
-	const BlockingMapCell& cell = groundBlockingMap[mapSquare];
-
-	if (cell.empty())
+	if (CellEmpty(mapSquare))
 		return NULL;
 
-	return ((cell.begin())->second);
+	return ((groundBlockingMap[mapSquare].begin())->second);
 }
 
 
@@ -158,11 +337,12 @@ bool CGroundBlockingObjectMap::GroundBlocked(int x, int z, CSolidObject* ignoreO
 		return false;
 
 	const int mapSquare = z * gs->mapx + x;
-	const BlockingMapCell& cell = groundBlockingMap[mapSquare];
 
-	if (cell.empty())
+	if (CellEmpty(mapSquare))
 		return false;
 
+	const BlockingMapCell& cell = groundBlockingMap[mapSquare];
+
 	const int objID = GetObjectID(ignoreObj);
 	BlockingMapCellIt it = cell.begin();
 
@@ -3,14 +3,65 @@
 #ifndef GROUNDBLOCKINGOBJECTMAP_H
 #define GROUNDBLOCKINGOBJECTMAP_H
 
-#include <map>
+#include <deque>
+#include <utility>
+#include <vector>
 #include "System/creg/creg_cond.h"
 
 #include "Sim/Objects/SolidObject.h"
 #include "System/float3.h"
 
 
-typedef std::map<int, CSolidObject*> BlockingMapCell;
+/**
+ * The objects blocking one map square, sorted by blocking-map ID (the
+ * same order std::map used to give). Almost every square holds at most
+ * one object, which is stored inline; squares with more objects keep
+ * them in a heap array.
+ */
+class BlockingMapCell
+{
+public:
+	typedef std::pair<int, CSolidObject*> value_type;
+	typedef const value_type* const_iterator;
+
+	BlockingMapCell()
+		: inlineEntry(-1, NULL)
+		, heapEntries(NULL)
+		, numEntries(0)
+		, maxEntries(1)
+	{}
+	BlockingMapCell(const BlockingMapCell& cell);
+	~BlockingMapCell() { delete[] heapEntries; }
+
+	BlockingMapCell& operator = (const BlockingMapCell& cell);
+
+	bool empty() const { return (numEntries == 0); }
+	size_t size() const { return numEntries; }
+
+	const_iterator begin() const { return (GetEntries()); }
+	const_iterator end() const { return (GetEntries() + numEntries); }
+	const_iterator find(int objID) const;
+
+	/// replaces the object if <objID> is already present
+	void insert(int objID, CSolidObject* obj);
+	void erase(int objID);
+	void clear();
+
+private:
+	const value_type* GetEntries() const { return ((heapEntries != NULL)? heapEntries: &inlineEntry); }
+	      value_type* GetEntries()       { return ((heapEntries != NULL)? heapEntries: &inlineEntry); }
+
+	/// index of the first entry with an ID not less than <objID>
+	unsigned int LowerBound(int objID) const;
+
+private:
+	value_type inlineEntry;
+	value_type* heapEntries;
+
+	unsigned int numEntries;
+	unsigned int maxEntries;
+};
+
 typedef BlockingMapCell::const_iterator BlockingMapCellIt;
 typedef std::vector<BlockingMapCell> BlockingMap;
 
@@ -22,6 +73,7 @@ class CGroundBlockingObjectMap
 public:
 	CGroundBlockingObjectMap(int numSquares) {
 		groundBlockingMap.resize(numSquares);
+		occupiedSquares.resize(numSquares, false);
 	}
 
 	void AddGroundBlockingObject(CSolidObject* object);
@@ -49,11 +101,36 @@ public:
 		return groundBlockingMap[mapSquare];
 	}
 
+	// same as GetCell(mapSquare).empty(), but does not touch the cell
+	bool CellEmpty(int mapSquare) const {
+		return !occupiedSquares[mapSquare];
+	}
+
+	void Serialize(creg::ISerializer* s);
+	void PostLoad();
+
 private:
 	bool CheckYard(CSolidObject* yardUnit, const YardMapStatus& mask) const;
 
+	void InsertObject(int mapSquare, int objID, CSolidObject* obj);
+	void EraseObject(int mapSquare, int objID);
+
 private:
 	BlockingMap groundBlockingMap;
+
+	// one bit per square, set if its cell is not empty; small enough
+	// to stay cached when scanning large areas that are mostly empty
+	std::vector<bool> occupiedSquares;
+
+	/// cell contents read by Serialize, inserted by PostLoad once all
+	/// object pointers have been fixed up; a deque so they do not move
+	struct LoadedEntry {
+		int mapSquare;
+		int objID;
+		void* obj;
+	};
+
+	std::deque<LoadedEntry> loadedEntries;
 };
 
 extern CGroundBlockingObjectMap* groundBlockingObjectMap;
@@ -288,6 +288,8 @@ void CLosHandler::CleanupInstance(LosInstance* instance)
 
 void CLosHandler::Update()
 {
+	SCOPED_TIMER("LOSHandler::Update");
+
 	while (!delayQue.empty() && delayQue.front().timeoutTime < gs->frameNum) {
 		FreeInstance(delayQue.front().instance);
 		delayQue.pop_front();
@@ -52,6 +52,7 @@ void CModInfo::Init(const char* modArchive)
 		pathFinderSystem = system.GetInt("pathFinderSystem", PFS_TYPE_DEFAULT) % PFS_NUM_TYPES;
 
 		pfUpdateRate = system.GetFloat("pathFinderUpdateRate", 0.007f);
+		pfFlowFieldGroupSize = std::max(0, system.GetInt("pathFinderFlowFieldGroupSize", 0));
 	}
 
 	{
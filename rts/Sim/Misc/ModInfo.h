@@ -50,6 +50,7 @@ public:
 		, featureVisibility(FEATURELOS_NONE)
 		, pathFinderSystem(PFS_TYPE_DEFAULT)
 		, pfUpdateRate(0.0f)
+		, pfFlowFieldGroupSize(0)
 	{}
 
 
@@ -178,6 +179,9 @@ public:
 	/// which pathfinder system (DEFAULT/legacy or QTPFS) the mod will use
 	int pathFinderSystem;
 	float pfUpdateRate;
+	/// number of same-frame requests to one goal after which the DEFAULT
+	/// pathfinder shares a flow-field between them (0 disables this)
+	int pfFlowFieldGroupSize;
 };
 
 extern CModInfo modInfo;
@@ -7,6 +7,7 @@
 #include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/TeamHandler.h"
+#include "Sim/MoveTypes/UnitCollisionBroadPhase.h"
 #include "Sim/Features/Feature.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Projectiles/Projectile.h"
@@ -115,12 +116,12 @@ CQuadField::~CQuadField()
 }
 
 
-std::vector<int> CQuadField::GetQuads(float3 pos, float radius) const
+CQuadField::QuadVector CQuadField::GetQuads(float3 pos, float radius) const
 {
 	pos.ClampInBounds();
 	pos.AssertNaNs();
 
-	std::vector<int> ret;
+	QuadVector ret;
 
 	// qsx and qsz are always equal
 	const float maxSqLength = (radius + quadSizeX * 0.72f) * (radius + quadSizeZ * 0.72f);
@@ -185,7 +186,7 @@ unsigned int CQuadField::GetQuads(float3 pos, float radius, int*& begQuad, int*&
 
 
 
-std::vector<CUnit*> CQuadField::GetUnits(const float3& pos, float radius)
+CQuadField::UnitVector CQuadField::GetUnits(const float3& pos, float radius)
 {
 	const int tempNum = gs->tempNum++;
 
@@ -194,7 +195,7 @@ std::vector<CUnit*> CQuadField::GetUnits(const float3& pos, float radius)
 
 	GetQuads(pos, radius, begQuad, endQuad);
 
-	std::vector<CUnit*> units;
+	UnitVector units;
 	std::list<CUnit*>::iterator ui;
 
 	for (int* a = begQuad; a != endQuad; ++a) {
@@ -212,7 +213,7 @@ std::vector<CUnit*> CQuadField::GetUnits(const float3& pos, float radius)
 	return units;
 }
 
-std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& pos, float radius, bool spherical)
+CQuadField::UnitVector CQuadField::GetUnitsExact(const float3& pos, float radius, bool spherical)
 {
 	const int tempNum = gs->tempNum++;
 
@@ -221,7 +222,7 @@ std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& pos, float radius, b
 
 	GetQuads(pos, radius, begQuad, endQuad);
 
-	std::vector<CUnit*> units;
+	UnitVector units;
 	std::list<CUnit*>::iterator ui;
 
 	for (int* a = begQuad; a != endQuad; ++a) {
@@ -248,13 +249,13 @@ std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& pos, float radius, b
 	return units;
 }
 
-std::vector<CUnit*> CQuadField::GetUnitsExact(const float3& mins, const float3& maxs)
+CQuadField::UnitVector CQuadField::GetUnitsExact(const float3& mins, const float3& maxs)
 {
-	const std::vector<int>& quads = GetQuadsRectangle(mins, maxs);
+	const QuadVector& quads = GetQuadsRectangle(mins, maxs);
 	const int tempNum = gs->tempNum++;
 
-	std::vector<CUnit*> units;
-	std::vector<int>::const_iterator qi;
+	UnitVector units;
+	QuadVector::const_iterator qi;
 
 	for (qi = quads.begin(); qi != quads.end(); ++qi) {
 		std::list<CUnit*>& quadUnits = baseQuads[*qi].units;
@@ -438,7 +439,10 @@ unsigned int CQuadField::GetQuadsOnRay(float3 start, float3 dir, float length, i
 
 void CQuadField::MovedUnit(CUnit* unit)
 {
-	const std::vector<int>& newQuads = GetQuads(unit->pos, unit->radius);
+	if (unitCollisionBroadPhase != NULL)
+		unitCollisionBroadPhase->UnitMoved(unit);
+
+	const QuadVector& newQuads = GetQuads(unit->pos, unit->radius);
 
 	// compare if the quads have changed, if not stop here
 	if (newQuads.size() == unit->quads.size()) {
@@ -462,11 +466,11 @@ void CQuadField::MovedUnit(CUnit* unit)
 			quadAllyUnits.erase(ui);
 	}
 
-	for (qi = newQuads.begin(); qi != newQuads.end(); ++qi) {
-		baseQuads[*qi].units.push_front(unit);
-		baseQuads[*qi].teamUnits[unit->allyteam].push_front(unit);
+	for (QuadVector::const_iterator nqi = newQuads.begin(); nqi != newQuads.end(); ++nqi) {
+		baseQuads[*nqi].units.push_front(unit);
+		baseQuads[*nqi].teamUnits[unit->allyteam].push_front(unit);
 	}
-	unit->quads = newQuads;
+	unit->quads.assign(newQuads.begin(), newQuads.end());
 }
 
 void CQuadField::RemoveUnit(CUnit* unit)
@@ -492,9 +496,9 @@ void CQuadField::RemoveUnit(CUnit* unit)
 
 void CQuadField::AddFeature(CFeature* feature)
 {
-	const std::vector<int>& newQuads = GetQuads(feature->pos, feature->radius);
+	const QuadVector& newQuads = GetQuads(feature->pos, feature->radius);
 
-	std::vector<int>::const_iterator qi;
+	QuadVector::const_iterator qi;
 	for (qi = newQuads.begin(); qi != newQuads.end(); ++qi) {
 		baseQuads[*qi].features.push_front(feature);
 	}
@@ -502,9 +506,9 @@ void CQuadField::AddFeature(CFeature* feature)
 
 void CQuadField::RemoveFeature(CFeature* feature)
 {
-	const std::vector<int>& quads = GetQuads(feature->pos, feature->radius);
+	const QuadVector& quads = GetQuads(feature->pos, feature->radius);
 
-	std::vector<int>::const_iterator qi;
+	QuadVector::const_iterator qi;
 	for (qi = quads.begin(); qi != quads.end(); ++qi) {
 		baseQuads[*qi].features.remove(feature);
 	}
@@ -630,13 +634,13 @@ void CQuadField::RemoveProjectile(CProjectile* p)
 
 
 
-std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& pos, float radius)
+CQuadField::FeatureVector CQuadField::GetFeaturesExact(const float3& pos, float radius)
 {
-	const std::vector<int>& quads = GetQuads(pos, radius);
+	const QuadVector& quads = GetQuads(pos, radius);
 	const int tempNum = gs->tempNum++;
 
-	std::vector<CFeature*> features;
-	std::vector<int>::const_iterator qi;
+	FeatureVector features;
+	QuadVector::const_iterator qi;
 	std::list<CFeature*>::iterator fi;
 
 	for (qi = quads.begin(); qi != quads.end(); ++qi) {
@@ -652,13 +656,13 @@ std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& pos, float rad
 	return features;
 }
 
-std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& pos, float radius, bool spherical)
+CQuadField::FeatureVector CQuadField::GetFeaturesExact(const float3& pos, float radius, bool spherical)
 {
-	const std::vector<int>& quads = GetQuads(pos, radius);
+	const QuadVector& quads = GetQuads(pos, radius);
 	const int tempNum = gs->tempNum++;
 
-	std::vector<CFeature*> features;
-	std::vector<int>::const_iterator qi;
+	FeatureVector features;
+	QuadVector::const_iterator qi;
 	std::list<CFeature*>::iterator fi;
 	const float totRadSq = radius * radius;
 
@@ -678,13 +682,13 @@ std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& pos, float rad
 	return features;
 }
 
-std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& mins, const float3& maxs)
+CQuadField::FeatureVector CQuadField::GetFeaturesExact(const float3& mins, const float3& maxs)
 {
-	const std::vector<int>& quads = GetQuadsRectangle(mins, maxs);
+	const QuadVector& quads = GetQuadsRectangle(mins, maxs);
 	const int tempNum = gs->tempNum++;
 
-	std::vector<CFeature*> features;
-	std::vector<int>::const_iterator qi;
+	FeatureVector features;
+	QuadVector::const_iterator qi;
 	std::list<CFeature*>::iterator fi;
 
 	for (qi = quads.begin(); qi != quads.end(); ++qi) {
@@ -708,12 +712,12 @@ std::vector<CFeature*> CQuadField::GetFeaturesExact(const float3& mins, const fl
 
 
 
-std::vector<CProjectile*> CQuadField::GetProjectilesExact(const float3& pos, float radius)
+CQuadField::ProjectileVector CQuadField::GetProjectilesExact(const float3& pos, float radius)
 {
-	const std::vector<int>& quads = GetQuads(pos, radius);
+	const QuadVector& quads = GetQuads(pos, radius);
 
-	std::vector<CProjectile*> projectiles;
-	std::vector<int>::const_iterator qi;
+	ProjectileVector projectiles;
+	QuadVector::const_iterator qi;
 	std::list<CProjectile*>::iterator pi;
 
 	for (qi = quads.begin(); qi != quads.end(); ++qi) {
@@ -731,12 +735,12 @@ std::vector<CProjectile*> CQuadField::GetProjectilesExact(const float3& pos, flo
 	return projectiles;
 }
 
-std::vector<CProjectile*> CQuadField::GetProjectilesExact(const float3& mins, const float3& maxs)
+CQuadField::ProjectileVector CQuadField::GetProjectilesExact(const float3& mins, const float3& maxs)
 {
-	const std::vector<int>& quads = GetQuadsRectangle(mins, maxs);
+	const QuadVector& quads = GetQuadsRectangle(mins, maxs);
 
-	std::vector<CProjectile*> projectiles;
-	std::vector<int>::const_iterator qi;
+	ProjectileVector projectiles;
+	QuadVector::const_iterator qi;
 	std::list<CProjectile*>::iterator pi;
 
 	for (qi = quads.begin(); qi != quads.end(); ++qi) {
@@ -758,17 +762,17 @@ std::vector<CProjectile*> CQuadField::GetProjectilesExact(const float3& mins, co
 
 
 
-std::vector<CSolidObject*> CQuadField::GetSolidsExact(
+CQuadField::SolidVector CQuadField::GetSolidsExact(
 	const float3& pos,
 	const float radius,
 	const unsigned int physicalStateBits,
 	const unsigned int collisionStateBits
 ) {
-	const std::vector<int>& quads = GetQuads(pos, radius);
+	const QuadVector& quads = GetQuads(pos, radius);
 	const int tempNum = gs->tempNum++;
 
-	std::vector<CSolidObject*> solids;
-	std::vector<int>::const_iterator qi;
+	SolidVector solids;
+	QuadVector::const_iterator qi;
 
 	std::list<CUnit*>::iterator ui;
 	std::list<CFeature*>::iterator fi;
@@ -812,7 +816,7 @@ std::vector<CSolidObject*> CQuadField::GetSolidsExact(
 
 
 
-std::vector<int> CQuadField::GetQuadsRectangle(const float3& pos1, const float3& pos2) const
+CQuadField::QuadVector CQuadField::GetQuadsRectangle(const float3& pos1, const float3& pos2) const
 {
 	assert(!math::isnan(pos1.x));
 	assert(!math::isnan(pos1.y));
@@ -821,7 +825,7 @@ std::vector<int> CQuadField::GetQuadsRectangle(const float3& pos1, const float3&
 	assert(!math::isnan(pos2.y));
 	assert(!math::isnan(pos2.z));
 
-	std::vector<int> ret;
+	QuadVector ret;
 
 	const int maxx = std::max(0, std::min((int(pos2.x)) / quadSizeX + 1, numQuadsX - 1));
 	const int maxz = std::max(0, std::min((int(pos2.z)) / quadSizeZ + 1, numQuadsZ - 1));
@@ -9,6 +9,7 @@
 #include <boost/noncopyable.hpp>
 
 #include "System/creg/creg_cond.h"
+#include "System/FrameArena.h"
 #include "System/float3.h"
 
 class CUnit;
@@ -24,11 +25,19 @@ class CQuadField : boost::noncopyable
 public:
 	static void Resize(unsigned int nqx, unsigned int nqz);
 
+	// query results are allocated from the calling thread's frame-arena
+	// (see CFrameArena) and must not be kept around past the current frame
+	typedef std::vector<int, FrameAllocator<int> > QuadVector;
+	typedef std::vector<CUnit*, FrameAllocator<CUnit*> > UnitVector;
+	typedef std::vector<CFeature*, FrameAllocator<CFeature*> > FeatureVector;
+	typedef std::vector<CProjectile*, FrameAllocator<CProjectile*> > ProjectileVector;
+	typedef std::vector<CSolidObject*, FrameAllocator<CSolidObject*> > SolidVector;
+
 	CQuadField(unsigned int nqx, unsigned int nqz);
 	~CQuadField();
 
-	std::vector<int> GetQuads(float3 pos, float radius) const;
-	std::vector<int> GetQuadsRectangle(const float3& pos1, const float3& pos2) const;
+	QuadVector GetQuads(float3 pos, float radius) const;
+	QuadVector GetQuadsRectangle(const float3& pos1, const float3& pos2) const;
 
 	// optimized functions, somewhat less userfriendly
 	//
@@ -53,39 +62,39 @@ public:
 	 * Returns all units within @c radius of @c pos,
 	 * and treats each unit as a 3D point object
 	 */
-	std::vector<CUnit*> GetUnits(const float3& pos, float radius);
+	UnitVector GetUnits(const float3& pos, float radius);
 	/**
 	 * Returns all units within @c radius of @c pos,
 	 * takes the 3D model radius of each unit into account,
  	 * and performs the search within a sphere or cylinder depending on @c spherical
 	 */
-	std::vector<CUnit*> GetUnitsExact(const float3& pos, float radius, bool spherical = true);
+	UnitVector GetUnitsExact(const float3& pos, float radius, bool spherical = true);
 	/**
 	 * Returns all units within the rectangle defined by
 	 * mins and maxs, which extends infinitely along the y-axis
 	 */
-	std::vector<CUnit*> GetUnitsExact(const float3& mins, const float3& maxs);
+	UnitVector GetUnitsExact(const float3& mins, const float3& maxs);
 
 	/**
 	 * Returns all features within @c radius of @c pos,
 	 * and takes the 3D model radius of each feature into account
 	 */
-	std::vector<CFeature*> GetFeaturesExact(const float3& pos, float radius);
+	FeatureVector GetFeaturesExact(const float3& pos, float radius);
 	/**
 	 * Returns all features within @c radius of @c pos,
 	 * and performs the search within a sphere or cylinder depending on @c spherical
 	 */
-	std::vector<CFeature*> GetFeaturesExact(const float3& pos, float radius, bool spherical);
+	FeatureVector GetFeaturesExact(const float3& pos, float radius, bool spherical);
 	/**
 	 * Returns all features within the rectangle defined by
 	 * mins and maxs, which extends infinitely along the y-axis
 	 */
-	std::vector<CFeature*> GetFeaturesExact(const float3& mins, const float3& maxs);
+	FeatureVector GetFeaturesExact(const float3& mins, const float3& maxs);
 
-	std::vector<CProjectile*> GetProjectilesExact(const float3& pos, float radius);
-	std::vector<CProjectile*> GetProjectilesExact(const float3& mins, const float3& maxs);
+	ProjectileVector GetProjectilesExact(const float3& pos, float radius);
+	ProjectileVector GetProjectilesExact(const float3& mins, const float3& maxs);
 
-	std::vector<CSolidObject*> GetSolidsExact(
+	SolidVector GetSolidsExact(
 		const float3& pos,
 		const float radius,
 		const unsigned int physicalStateBits = 0xFFFFFFFF,
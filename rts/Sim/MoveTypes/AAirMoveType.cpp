@@ -239,7 +239,7 @@ void AAirMoveType::CheckForCollision()
 	const SyncedFloat3& forward = owner->frontdir;
 
 	const float3 midTestPos = pos + forward * 121.0f;
-	const std::vector<CUnit*>& others = quadField->GetUnitsExact(midTestPos, 115.0f);
+	const CQuadField::UnitVector& others = quadField->GetUnitsExact(midTestPos, 115.0f);
 
 	float dist = 200.0f;
 
@@ -249,7 +249,7 @@ void AAirMoveType::CheckForCollision()
 		lastColWarningType = 0;
 	}
 
-	for (std::vector<CUnit*>::const_iterator ui = others.begin(); ui != others.end(); ++ui) {
+	for (CQuadField::UnitVector::const_iterator ui = others.begin(); ui != others.end(); ++ui) {
 		const CUnit* unit = *ui;
 
 		if (unit == owner || !unit->unitDef->canfly) {
@@ -281,7 +281,7 @@ void AAirMoveType::CheckForCollision()
 		return;
 	}
 
-	for (std::vector<CUnit*>::const_iterator ui = others.begin(); ui != others.end(); ++ui) {
+	for (CQuadField::UnitVector::const_iterator ui = others.begin(); ui != others.end(); ++ui) {
 		if (*ui == owner)
 			continue;
 		if (((*ui)->midPos - pos).SqLength() < (dist * dist)) {
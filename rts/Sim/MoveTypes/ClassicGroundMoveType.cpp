@@ -615,10 +615,10 @@ void CClassicGroundMoveType::CheckCollisionSkid()
 {
 	const SyncedFloat3& midPos = owner->midPos;
 
-	const vector<CUnit*>& nearUnits = quadField->GetUnitsExact(midPos, owner->radius);
-	const vector<CFeature*>& nearFeatures = quadField->GetFeaturesExact(midPos, owner->radius);
+	const CQuadField::UnitVector& nearUnits = quadField->GetUnitsExact(midPos, owner->radius);
+	const CQuadField::FeatureVector& nearFeatures = quadField->GetFeaturesExact(midPos, owner->radius);
 
-	for (vector<CUnit*>::const_iterator ui = nearUnits.begin(); ui != nearUnits.end(); ++ui) {
+	for (CQuadField::UnitVector::const_iterator ui = nearUnits.begin(); ui != nearUnits.end(); ++ui) {
 		CUnit* unit = *ui;
 
 		if (!unit->HasCollidableStateBit(CSolidObject::CSTATE_BIT_SOLIDOBJECTS))
@@ -676,7 +676,7 @@ void CClassicGroundMoveType::CheckCollisionSkid()
 		}
 	}
 
-	for (vector<CFeature*>::const_iterator fi = nearFeatures.begin(); fi != nearFeatures.end(); ++fi) {
+	for (CQuadField::FeatureVector::const_iterator fi = nearFeatures.begin(); fi != nearFeatures.end(); ++fi) {
 		CFeature* feature = *fi;
 
 		if (!feature->HasCollidableStateBit(CSolidObject::CSTATE_BIT_SOLIDOBJECTS))
@@ -796,9 +796,9 @@ float3 CClassicGroundMoveType::ObstacleAvoidance(float3 desiredDir) {
 
 			MoveDef* moveDef = owner->moveDef;
 
-			vector<CSolidObject*> nearbyObjects = quadField->GetSolidsExact(owner->pos, speedf * 35 + 30 + owner->xsize / 2, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
+			CQuadField::SolidVector nearbyObjects = quadField->GetSolidsExact(owner->pos, speedf * 35 + 30 + owner->xsize / 2, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
 			vector<CSolidObject*> objectsOnPath;
-			vector<CSolidObject*>::iterator oi;
+			CQuadField::SolidVector::iterator oi;
 
 			for (oi = nearbyObjects.begin(); oi != nearbyObjects.end(); ++oi) {
 				CSolidObject* o = *oi;
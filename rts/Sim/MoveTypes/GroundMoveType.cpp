@@ -2,6 +2,7 @@
 
 #include "GroundMoveType.h"
 #include "MoveDefHandler.h"
+#include "UnitCollisionBroadPhase.h"
 #include "ExternalAI/EngineOutHandler.h"
 #include "Game/Camera.h"
 #include "Game/GameHelper.h"
@@ -72,6 +73,18 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_GMT)
 
 #define FOOTPRINT_RADIUS(xs, zs, s) ((math::sqrt((xs * xs + zs * zs)) * 0.5f * SQUARE_SIZE) * s)
 
+// mirrors the search radius of CGroundMoveType::HandleUnitCollisions, the broad
+// phase is shared by all ground units and rebuilt by the first one each frame
+static float GetUnitCollisionSearchRadius(const CUnit* unit)
+{
+	if (dynamic_cast<const CGroundMoveType*>(unit->moveType) == NULL)
+		return -1.0f;
+	if (unit->moveDef == NULL)
+		return -1.0f;
+
+	return (unit->speed.w + FOOTPRINT_RADIUS(unit->moveDef->xsize, unit->moveDef->zsize, 0.75f) * 2.0f);
+}
+
 
 CR_BIND_DERIVED(CGroundMoveType, AMoveType, (NULL))
 CR_REG_METADATA(CGroundMoveType, (
@@ -868,11 +881,11 @@ void CGroundMoveType::CheckCollisionSkid()
 	const float3& pos = collider->pos;
 
 	const UnitDef* colliderUD = collider->unitDef;
-	const vector<CUnit*>& nearUnits = quadField->GetUnitsExact(pos, collider->radius);
-	const vector<CFeature*>& nearFeatures = quadField->GetFeaturesExact(pos, collider->radius);
+	const CQuadField::UnitVector& nearUnits = quadField->GetUnitsExact(pos, collider->radius);
+	const CQuadField::FeatureVector& nearFeatures = quadField->GetFeaturesExact(pos, collider->radius);
 
-	vector<CUnit*>::const_iterator ui;
-	vector<CFeature*>::const_iterator fi;
+	CQuadField::UnitVector::const_iterator ui;
+	CQuadField::FeatureVector::const_iterator fi;
 
 	for (ui = nearUnits.begin(); ui != nearUnits.end(); ++ui) {
 		CUnit* collidee = *ui;
@@ -1067,9 +1080,9 @@ float3 CGroundMoveType::GetObstacleAvoidanceDir(const float3& desiredDir) {
 	const float avoidanceRadius = std::max(currentSpeed, 1.0f) * (avoider->radius * 2.0f);
 	const float avoiderRadius = FOOTPRINT_RADIUS(avoiderMD->xsize, avoiderMD->zsize, 1.0f);
 
-	const vector<CSolidObject*>& objects = quadField->GetSolidsExact(avoider->pos, avoidanceRadius, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
+	const CQuadField::SolidVector& objects = quadField->GetSolidsExact(avoider->pos, avoidanceRadius, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
 
-	for (vector<CSolidObject*>::const_iterator oi = objects.begin(); oi != objects.end(); ++oi) {
+	for (CQuadField::SolidVector::const_iterator oi = objects.begin(); oi != objects.end(); ++oi) {
 		const CSolidObject* avoidee = *oi;
 		const MoveDef* avoideeMD = avoidee->moveDef;
 		const UnitDef* avoideeUD = dynamic_cast<const UnitDef*>(avoidee->objectDef);
@@ -1753,15 +1766,24 @@ void CGroundMoveType::HandleUnitCollisions(
 ) {
 	const float searchRadius = colliderSpeed + (colliderRadius * 2.0f);
 
-	const std::vector<CUnit*>& nearUnits = quadField->GetUnitsExact(collider->pos, searchRadius);
-	      std::vector<CUnit*>::const_iterator uit;
+	unitCollisionBroadPhase->Update(GetUnitCollisionSearchRadius);
+
+	const std::vector<CUnit*>* broadPhaseUnits = unitCollisionBroadPhase->GetNearUnits(collider, searchRadius);
+	const CQuadField::UnitVector& quadFieldUnits = (broadPhaseUnits != NULL)?
+		CQuadField::UnitVector():
+		quadField->GetUnitsExact(collider->pos, searchRadius);
+
+	// both results are contiguous, iterate whichever we got in place
+	CUnit* const* nearUnitsBeg = (broadPhaseUnits != NULL)? broadPhaseUnits->data(): quadFieldUnits.data();
+	CUnit* const* nearUnitsEnd = nearUnitsBeg + ((broadPhaseUnits != NULL)? broadPhaseUnits->size(): quadFieldUnits.size());
+	CUnit* const* uit;
 
 	// NOTE: probably too large for most units (eg. causes tree falling animations to be skipped)
 	const int dirSign = Sign(int(!reversing));
 	const float3 crushImpulse = collider->speed * collider->mass * dirSign;
 
-	for (uit = nearUnits.begin(); uit != nearUnits.end(); ++uit) {
-		CUnit* collidee = const_cast<CUnit*>(*uit);
+	for (uit = nearUnitsBeg; uit != nearUnitsEnd; ++uit) {
+		CUnit* collidee = *uit;
 
 		const UnitDef* collideeUD = collidee->unitDef;
 		const MoveDef* collideeMD = collidee->moveDef;
@@ -1944,8 +1966,8 @@ void CGroundMoveType::HandleFeatureCollisions(
 ) {
 	const float searchRadius = colliderSpeed + (colliderRadius * 2.0f);
 
-	const std::vector<CFeature*>& nearFeatures = quadField->GetFeaturesExact(collider->pos, searchRadius);
-	      std::vector<CFeature*>::const_iterator fit;
+	const CQuadField::FeatureVector& nearFeatures = quadField->GetFeaturesExact(collider->pos, searchRadius);
+	      CQuadField::FeatureVector::const_iterator fit;
 
 	const int dirSign = Sign(int(!reversing));
 	const float3 crushImpulse = collider->speed * collider->mass * dirSign;
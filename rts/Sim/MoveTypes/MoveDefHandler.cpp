@@ -46,13 +46,17 @@ CR_REG_METADATA(MoveDef, (
 	CR_MEMBER(flowMapping),
 	CR_MEMBER(heatMod),
 	CR_MEMBER(flowMod),
-	CR_MEMBER(heatProduced)
+	CR_MEMBER(heatProduced),
+
+	// the speed-mod grids are rebuilt (and indices reassigned) on load
+	CR_IGNORED(speedModGridIndex)
 ))
 
 CR_REG_METADATA(MoveDefHandler, (
 	CR_MEMBER(moveDefs),
 	CR_MEMBER(moveDefNames),
-	CR_MEMBER(checksum)
+	CR_MEMBER(checksum),
+	CR_POSTLOAD(PostLoad)
 ))
 
 
@@ -135,6 +139,20 @@ MoveDefHandler::MoveDefHandler(LuaParser* defsParser)
 	crc << CMoveMath::noHoverWaterMove;
 
 	checksum = crc.GetDigest();
+
+	CMoveMath::InitSpeedModGrids(moveDefs);
+}
+
+
+void MoveDefHandler::PostLoad()
+{
+	CMoveMath::InitSpeedModGrids(moveDefs);
+}
+
+
+MoveDefHandler::~MoveDefHandler()
+{
+	CMoveMath::FreeSpeedModGrids();
 }
 
 
@@ -182,6 +200,8 @@ MoveDef::MoveDef()
 
 	, heatMapping(true)
 	, flowMapping(true)
+
+	, speedModGridIndex(0)
 {
 	depthModParams[DEPTHMOD_MIN_HEIGHT] = 0.0f;
 	depthModParams[DEPTHMOD_MAX_HEIGHT] = std::numeric_limits<float>::max();
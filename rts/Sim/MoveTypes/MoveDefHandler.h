@@ -129,6 +129,10 @@ struct MoveDef {
 	/// do we leave heat and avoid any left by others?
 	bool heatMapping;
 	bool flowMapping;
+
+	/// which of CMoveMath's speed-mod grids we use (not checksummed,
+	/// depends only on the members above)
+	unsigned int speedModGridIndex;
 };
 
 
@@ -139,6 +143,9 @@ class MoveDefHandler
 	CR_DECLARE_STRUCT(MoveDefHandler)
 public:
 	MoveDefHandler(LuaParser* defsParser);
+	~MoveDefHandler();
+
+	void PostLoad();
 
 	MoveDef* GetMoveDefByPathType(unsigned int pathType) { return &moveDefs[pathType]; }
 	MoveDef* GetMoveDefByName(const std::string& name);
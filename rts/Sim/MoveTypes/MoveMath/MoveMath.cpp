@@ -2,6 +2,8 @@
 
 #include "MoveMath.h"
 
+#include <algorithm>
+
 #include "Map/MapInfo.h"
 #include "Sim/Features/Feature.h"
 #include "Sim/Misc/GroundBlockingObjectMap.h"
@@ -9,10 +11,15 @@
 #include "Sim/Objects/SolidObject.h"
 #include "Sim/Units/Unit.h"
 #include "Sim/Units/CommandAI/CommandAI.h"
+#include "System/Rectangle.h"
+#include "System/ThreadPool.h"
 
 bool CMoveMath::noHoverWaterMove = false;
 float CMoveMath::waterDamageCost = 0.0f;
 
+std::vector< std::vector<float> > CMoveMath::speedModGrids;
+std::vector<MoveDef> CMoveMath::speedModGridDefs;
+
 
 
 float CMoveMath::yLevel(const MoveDef& moveDef, int xSqr, int zSqr)
@@ -41,13 +48,9 @@ float CMoveMath::yLevel(const MoveDef& moveDef, const float3& pos)
 
 
 
-/* calculate the local speed-modifier for this MoveDef */
-float CMoveMath::GetPosSpeedMod(const MoveDef& moveDef, int xSquare, int zSquare)
+/* calculate the local speed-modifier for this MoveDef at a typemap square */
+float CMoveMath::CalcPosSpeedMod(const MoveDef& moveDef, int square)
 {
-	if (xSquare < 0 || zSquare < 0 || xSquare >= gs->mapx || zSquare >= gs->mapy)
-		return 0.0f;
-
-	const int square = (xSquare >> 1) + ((zSquare >> 1) * gs->hmapx);
 	const int squareTerrType = readMap->GetTypeMapSynced()[square];
 
 	const float height  = readMap->GetMIPHeightMapSynced(1)[square];
@@ -66,6 +69,82 @@ float CMoveMath::GetPosSpeedMod(const MoveDef& moveDef, int xSquare, int zSquare
 	return 0.0f;
 }
 
+static bool HaveEqualSpeedMods(const MoveDef& md1, const MoveDef& md2)
+{
+	if (md1.speedModClass != md2.speedModClass)
+		return false;
+
+	switch (md1.speedModClass) {
+		case MoveDef::Tank: // fall-through
+		case MoveDef::KBot: {
+			return
+				md1.depth == md2.depth &&
+				md1.maxSlope == md2.maxSlope &&
+				md1.slopeMod == md2.slopeMod &&
+				std::equal(md1.depthModParams, md1.depthModParams + MoveDef::DEPTHMOD_NUM_PARAMS, md2.depthModParams);
+		} break;
+		case MoveDef::Hover: {
+			return (md1.maxSlope == md2.maxSlope && md1.slopeMod == md2.slopeMod);
+		} break;
+		case MoveDef::Ship: {
+			return (md1.depth == md2.depth);
+		} break;
+	}
+
+	return false;
+}
+
+void CMoveMath::InitSpeedModGrids(std::vector<MoveDef>& moveDefs)
+{
+	speedModGrids.clear();
+	speedModGridDefs.clear();
+
+	for (unsigned int i = 0; i < moveDefs.size(); i++) {
+		MoveDef& md = moveDefs[i];
+
+		for (md.speedModGridIndex = 0; md.speedModGridIndex < speedModGridDefs.size(); md.speedModGridIndex++) {
+			if (HaveEqualSpeedMods(md, speedModGridDefs[md.speedModGridIndex]))
+				break;
+		}
+
+		if (md.speedModGridIndex < speedModGridDefs.size())
+			continue;
+
+		speedModGridDefs.push_back(md);
+		speedModGrids.push_back(std::vector<float>(gs->hmapx * gs->hmapy, 0.0f));
+	}
+
+	UpdateSpeedModGrids(SRectangle(0, 0, gs->mapx, gs->mapy));
+}
+
+void CMoveMath::FreeSpeedModGrids()
+{
+	// the next map can have a different size
+	speedModGrids.clear();
+	speedModGridDefs.clear();
+}
+
+void CMoveMath::UpdateSpeedModGrids(const SRectangle& rect)
+{
+	// same (padded) area as CReadMap::UpdateSlopemap
+	const int sx = std::max(0, (rect.x1 / 2) - 1);
+	const int ex = std::min(gs->hmapx - 1, (rect.x2 / 2) + 1);
+	const int sy = std::max(0, (rect.z1 / 2) - 1);
+	const int ey = std::min(gs->hmapy - 1, (rect.z2 / 2) + 1);
+
+	for (unsigned int n = 0; n < speedModGrids.size(); n++) {
+		const MoveDef& md = speedModGridDefs[n];
+		std::vector<float>& grid = speedModGrids[n];
+
+		for_mt(sy, ey + 1, [&](const int y) {
+			for (int x = sx; x <= ex; x++) {
+				grid[y * gs->hmapx + x] = CalcPosSpeedMod(md, y * gs->hmapx + x);
+			}
+		});
+	}
+}
+
+
 float CMoveMath::GetPosSpeedMod(const MoveDef& moveDef, int xSquare, int zSquare, const float3& moveDir)
 {
 	if (xSquare < 0 || zSquare < 0 || xSquare >= gs->mapx || zSquare >= gs->mapy)
@@ -211,6 +290,9 @@ CMoveMath::BlockType CMoveMath::SquareIsBlocked(const MoveDef& moveDef, int xSqu
 
 	BlockType r = BLOCK_NONE;
 
+	if (groundBlockingObjectMap->CellEmpty(zSquare * gs->mapx + xSquare))
+		return r;
+
 	const BlockingMapCell& c = groundBlockingObjectMap->GetCell(zSquare * gs->mapx + xSquare);
 
 	for (BlockingMapCellIt it = c.begin(); it != c.end(); ++it) {
@@ -3,12 +3,15 @@
 #ifndef MOVEMATH_H
 #define MOVEMATH_H
 
+#include <vector>
+
 #include "Map/ReadMap.h"
+#include "Sim/MoveTypes/MoveDefHandler.h"
 #include "System/float3.h"
 #include "System/Misc/BitwiseEnum.h"
 
-struct MoveDef;
 class CSolidObject;
+struct SRectangle;
 class CMoveMath {
 	CR_DECLARE(CMoveMath)
 
@@ -20,6 +23,8 @@ protected:
 	static float ShipSpeedMod(const MoveDef& moveDef, float height, float slope);
 	static float ShipSpeedMod(const MoveDef& moveDef, float height, float slope, float dirSlopeMod);
 
+	static float CalcPosSpeedMod(const MoveDef& moveDef, int square);
+
 public:
 	// gives the y-coordinate the unit will "stand on"
 	static float yLevel(const MoveDef& moveDef, const float3& pos);
@@ -38,7 +43,7 @@ public:
 
 
 	// returns a speed-multiplier for given position or data
-	static float GetPosSpeedMod(const MoveDef& moveDef, int xSquare, int zSquare);
+	static inline float GetPosSpeedMod(const MoveDef& moveDef, int xSquare, int zSquare);
 	static float GetPosSpeedMod(const MoveDef& moveDef, int xSquare, int zSquare, const float3& moveDir);
 	static float GetPosSpeedMod(const MoveDef& moveDef, const float3& pos)
 	{
@@ -68,12 +73,35 @@ public:
 		return (SquareIsBlocked(moveDef, pos.x / SQUARE_SIZE, pos.z / SQUARE_SIZE, collider));
 	}
 
+	// (re)builds the speed-mod grids and assigns every MoveDef to one
+	static void InitSpeedModGrids(std::vector<MoveDef>& moveDefs);
+	static void FreeSpeedModGrids();
+	// recalculates the speed-mods for a heightmap-square rectangle
+	static void UpdateSpeedModGrids(const SRectangle& rect);
+
 public:
 	static bool noHoverWaterMove;
 	static float waterDamageCost;
+
+private:
+	// direction-independent speed-mods per typemap square, one grid is
+	// shared by all MoveDefs with the same terrain-related parameters
+	static std::vector< std::vector<float> > speedModGrids;
+	// the first MoveDef assigned to each grid
+	static std::vector<MoveDef> speedModGridDefs;
 };
 
 
+/* looks up the local speed-modifier for this MoveDef */
+inline float CMoveMath::GetPosSpeedMod(const MoveDef& moveDef, int xSquare, int zSquare)
+{
+	if (xSquare < 0 || zSquare < 0 || xSquare >= gs->mapx || zSquare >= gs->mapy)
+		return 0.0f;
+
+	return speedModGrids[moveDef.speedModGridIndex][(xSquare >> 1) + ((zSquare >> 1) * gs->hmapx)];
+}
+
+
 
 /* Check if a given square-position is accessable by the MoveDef footprint. */
 inline CMoveMath::BlockType CMoveMath::IsBlocked(const MoveDef& moveDef, int xSquare, int zSquare, const CSolidObject* collider)
@@ -0,0 +1,227 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+
+#include "UnitCollisionBroadPhase.h"
+#include "Sim/Misc/GlobalConstants.h"
+#include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Units/Unit.h"
+#include "Sim/Units/UnitHandler.h"
+#include "System/myMath.h"
+#include "System/ThreadPool.h"
+
+CUnitCollisionBroadPhase* unitCollisionBroadPhase = NULL;
+
+// roughly the size of a large unit footprint
+static const int CELL_SIZE = SQUARE_SIZE * 8;
+
+// how far a unit may move between the grid being built and being queried
+// (its own step for this frame plus being pushed by a collision or two)
+static inline float GetMoveMargin(const CUnit* unit)
+{
+	return (unit->speed.w * 2.0f + SQUARE_SIZE * 2.0f);
+}
+
+
+
+CUnitCollisionBroadPhase::CUnitCollisionBroadPhase()
+	: numColliders(0)
+	, numCellsX(0)
+	, numCellsZ(0)
+	, lastUpdateFrame(-1)
+	, unitsGeneration(0)
+	, buildGeneration(0)
+	, maxUnitRadius(0.0f)
+{
+}
+
+
+void CUnitCollisionBroadPhase::Update(SearchRadiusFunc searchRadiusFunc)
+{
+	if (lastUpdateFrame == gs->frameNum)
+		return;
+
+	lastUpdateFrame = gs->frameNum;
+	buildGeneration = unitsGeneration;
+	Build(searchRadiusFunc);
+}
+
+
+void CUnitCollisionBroadPhase::Build(SearchRadiusFunc searchRadiusFunc)
+{
+	const std::list<CUnit*>& units = unitHandler->activeUnits;
+
+	numCellsX = (gs->mapx * SQUARE_SIZE) / CELL_SIZE + 1;
+	numCellsZ = (gs->mapy * SQUARE_SIZE) / CELL_SIZE + 1;
+	maxUnitRadius = 0.0f;
+
+	std::vector<int> unitCells;
+	unitCells.reserve(units.size());
+
+	cellStarts.clear();
+	cellStarts.resize(numCellsX * numCellsZ + 1, 0);
+
+	numColliders = 0;
+	colliderIndices.clear();
+	colliderIndices.resize(unitHandler->MaxUnits(), -1);
+	gridUnitIndices.clear();
+	gridUnitIndices.resize(unitHandler->MaxUnits(), -1);
+
+	// count the units per cell (shifted by one for the prefix-sum)
+	for (std::list<CUnit*>::const_iterator it = units.begin(); it != units.end(); ++it) {
+		CUnit* unit = *it;
+
+		const int cell = GetCellX(unit->midPos.x) + GetCellZ(unit->midPos.z) * numCellsX;
+		const float searchRadius = searchRadiusFunc(unit);
+
+		unitCells.push_back(cell);
+		cellStarts[cell + 1] += 1;
+
+		maxUnitRadius = std::max(maxUnitRadius, unit->radius + GetMoveMargin(unit));
+
+		if (searchRadius <= 0.0f)
+			continue;
+
+		if (numColliders == colliders.size())
+			colliders.push_back(Collider());
+
+		colliderIndices[unit->id] = numColliders;
+
+		Collider& collider = colliders[numColliders++];
+		collider.candidates.clear();
+		collider.unit = unit;
+		collider.pos = unit->pos;
+		collider.queryRadius = searchRadius + GetMoveMargin(unit);
+	}
+
+	for (size_t n = 1; n < cellStarts.size(); n++) {
+		cellStarts[n] += cellStarts[n - 1];
+	}
+
+	// place them, within a cell in the order of activeUnits
+	std::vector<unsigned int> cellEnds(cellStarts.begin(), cellStarts.end() - 1);
+	gridUnits.resize(units.size());
+
+	size_t unitIdx = 0;
+
+	for (std::list<CUnit*>::const_iterator it = units.begin(); it != units.end(); ++it, ++unitIdx) {
+		CUnit* unit = *it;
+
+		const unsigned int gridIdx = cellEnds[unitCells[unitIdx]]++;
+		GridUnit& gu = gridUnits[gridIdx];
+
+		gridUnitIndices[unit->id] = gridIdx;
+
+		gu.unit = unit;
+		gu.midPos = unit->midPos;
+		gu.moveMargin = GetMoveMargin(unit);
+		gu.radius = unit->radius + gu.moveMargin;
+	}
+
+	// every list is written by exactly one task, so the result does not
+	// depend on the number of threads
+	for_mt(0, numColliders, [&](const int i) {
+		GatherCandidates(colliders[i]);
+	});
+}
+
+
+void CUnitCollisionBroadPhase::GatherCandidates(Collider& collider) const
+{
+	const float cellRadius = collider.queryRadius + maxUnitRadius;
+
+	const int minCellX = GetCellX(collider.pos.x - cellRadius);
+	const int maxCellX = GetCellX(collider.pos.x + cellRadius);
+	const int minCellZ = GetCellZ(collider.pos.z - cellRadius);
+	const int maxCellZ = GetCellZ(collider.pos.z + cellRadius);
+
+	for (int z = minCellZ; z <= maxCellZ; z++) {
+		for (int x = minCellX; x <= maxCellX; x++) {
+			const int cell = x + z * numCellsX;
+
+			for (unsigned int n = cellStarts[cell]; n < cellStarts[cell + 1]; n++) {
+				const GridUnit& gu = gridUnits[n];
+				const float totRad = collider.queryRadius + gu.radius;
+
+				if (collider.pos.SqDistance2D(gu.midPos) >= (totRad * totRad))
+					continue;
+
+				collider.candidates.push_back(gu.unit);
+			}
+		}
+	}
+}
+
+
+const std::vector<CUnit*>* CUnitCollisionBroadPhase::GetNearUnits(const CUnit* collider, float searchRadius)
+{
+	if (lastUpdateFrame != gs->frameNum)
+		return NULL;
+	// some unit may be missing from the candidate lists
+	if (unitsGeneration != buildGeneration)
+		return NULL;
+	if (collider->id < 0 || collider->id >= int(colliderIndices.size()))
+		return NULL;
+
+	const int colliderIdx = colliderIndices[collider->id];
+
+	if (colliderIdx < 0)
+		return NULL;
+
+	const Collider& c = colliders[colliderIdx];
+
+	// the query circle must lie inside the one the candidates were gathered for
+	if ((collider->pos.distance2D(c.pos) + searchRadius) > c.queryRadius)
+		return NULL;
+
+	nearUnits.clear();
+
+	// same test as QuadField::GetUnitsExact, on the current positions
+	for (std::vector<CUnit*>::const_iterator it = c.candidates.begin(); it != c.candidates.end(); ++it) {
+		CUnit* unit = *it;
+
+		const float totRad = searchRadius + unit->radius;
+
+		if (collider->pos.SqDistance(unit->midPos) >= (totRad * totRad))
+			continue;
+
+		nearUnits.push_back(unit);
+	}
+
+	return &nearUnits;
+}
+
+
+void CUnitCollisionBroadPhase::UnitAdded(const CUnit* unit)
+{
+	unitsGeneration += 1;
+}
+
+void CUnitCollisionBroadPhase::UnitMoved(const CUnit* unit)
+{
+	if (lastUpdateFrame != gs->frameNum)
+		return;
+	if (unitsGeneration != buildGeneration)
+		return;
+
+	if (unit->id < 0 || unit->id >= int(gridUnitIndices.size()) || gridUnitIndices[unit->id] < 0) {
+		unitsGeneration += 1;
+		return;
+	}
+
+	const GridUnit& gu = gridUnits[gridUnitIndices[unit->id]];
+
+	if (gu.unit != unit || unit->midPos.SqDistance2D(gu.midPos) > (gu.moveMargin * gu.moveMargin))
+		unitsGeneration += 1;
+}
+
+
+int CUnitCollisionBroadPhase::GetCellX(float x) const
+{
+	return Clamp(int(x / CELL_SIZE), 0, numCellsX - 1);
+}
+
+int CUnitCollisionBroadPhase::GetCellZ(float z) const
+{
+	return Clamp(int(z / CELL_SIZE), 0, numCellsZ - 1);
+}
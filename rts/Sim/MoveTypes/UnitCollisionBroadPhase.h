@@ -0,0 +1,102 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef UNIT_COLLISION_BROAD_PHASE_H
+#define UNIT_COLLISION_BROAD_PHASE_H
+
+#include <vector>
+
+#include "System/float3.h"
+
+class CUnit;
+
+/**
+ * Broad phase for unit-unit collisions of ground units, replacing one
+ * QuadField::GetUnitsExact call per unit per frame.
+ *
+ * Once per frame every active unit is bucketed into a uniform grid (a
+ * counting sort, so each cell is a contiguous range), after which the
+ * candidate collidees of all colliders are gathered in parallel. Each
+ * candidate list holds every unit GetUnitsExact could return later that
+ * frame, as long as all units stay within a margin of about one frame of
+ * movement; GetNearUnits applies the exact test on the positions current
+ * at the time of the query, in grid order.
+ *
+ * Units added after the grid was built, or moved beyond their margin (as
+ * reported through UnitAdded and UnitMoved), invalidate the grid for the
+ * rest of the frame, as does a collider that left its query circle; in
+ * those cases GetNearUnits returns NULL and callers query the QuadField
+ * as before.
+ *
+ * Owned by CGame, so no unit pointers outlive the game they belong to.
+ */
+class CUnitCollisionBroadPhase
+{
+public:
+	/// returns the search radius of an active collider, or <= 0 for other units
+	typedef float (*SearchRadiusFunc)(const CUnit* unit);
+
+	CUnitCollisionBroadPhase();
+
+	/// rebuilds the grid and candidate lists if not done yet this frame
+	void Update(SearchRadiusFunc searchRadiusFunc);
+
+	/**
+	 * Units whose midPos lies within <searchRadius> plus their radius of
+	 * <collider>'s position, or NULL if the QuadField has to be asked.
+	 * The returned vector is only valid until the next call.
+	 */
+	const std::vector<CUnit*>* GetNearUnits(const CUnit* collider, float searchRadius);
+
+	/// called for every unit added to the sim
+	void UnitAdded(const CUnit* unit);
+	/// called for moves that bypass regular movement (QuadField::MovedUnit)
+	void UnitMoved(const CUnit* unit);
+
+private:
+	struct GridUnit {
+		CUnit* unit;
+		float3 midPos;
+		float radius; ///< includes the movement margin
+		float moveMargin;
+	};
+	struct Collider {
+		CUnit* unit;
+		float3 pos;
+		float queryRadius; ///< includes the movement margin
+		std::vector<CUnit*> candidates;
+	};
+
+	void Build(SearchRadiusFunc searchRadiusFunc);
+	void GatherCandidates(Collider& collider) const;
+
+	int GetCellX(float x) const;
+	int GetCellZ(float z) const;
+
+private:
+	std::vector<GridUnit> gridUnits; ///< sorted by cell
+	std::vector<unsigned int> cellStarts; ///< numCellsX * numCellsZ + 1 offsets into gridUnits
+	/// first numColliders are in use, the rest keep their candidate
+	/// vectors allocated for the next frames
+	std::vector<Collider> colliders;
+	std::vector<int> colliderIndices; ///< by unit ID, -1 if not a collider
+	std::vector<int> gridUnitIndices; ///< by unit ID, -1 if not in the grid
+
+	unsigned int numColliders;
+
+	std::vector<CUnit*> nearUnits;
+
+	int numCellsX;
+	int numCellsZ;
+	int lastUpdateFrame;
+
+	/// bumped by UnitAdded and UnitMoved, the grid is only
+	/// valid while it still equals the value seen by Build
+	unsigned int unitsGeneration;
+	unsigned int buildGeneration;
+
+	float maxUnitRadius;
+};
+
+extern CUnitCollisionBroadPhase* unitCollisionBroadPhase;
+
+#endif // UNIT_COLLISION_BROAD_PHASE_H
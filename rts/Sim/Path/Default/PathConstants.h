@@ -19,6 +19,8 @@ static const unsigned int MAX_SEARCHED_NODES_PE = MAX_SEARCHED_NODES;
 // PathManager distance thresholds (to use PF or PE)
 static const float     MAXRES_SEARCH_DISTANCE = 25.0f;
 static const float     MEDRES_SEARCH_DISTANCE = 55.0f;
+static const float     LOWRES_SEARCH_DISTANCE = 220.0f;
+static const float MIN_LOWRES_SEARCH_DISTANCE = 160.0f;
 static const float MIN_MEDRES_SEARCH_DISTANCE = 40.0f;
 static const float MIN_MAXRES_SEARCH_DISTANCE = 12.0f;
 
@@ -29,6 +31,8 @@ static const unsigned int PATHESTIMATOR_VERSION = 62;
 
 static const unsigned int MEDRES_PE_BLOCKSIZE =  8;
 static const unsigned int LOWRES_PE_BLOCKSIZE = 32;
+// must divide every map size (which are multiples of 64 squares)
+static const unsigned int COARSE_PE_BLOCKSIZE = 64;
 
 static const unsigned int SQUARES_TO_UPDATE = 1000;
 static const unsigned int MAX_SEARCHED_NODES_ON_REFINE = 2000;
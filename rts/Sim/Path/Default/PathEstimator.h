@@ -119,6 +119,7 @@ private:
 
 private:
 	friend class CPathManager;
+	friend class CPathFlowField;
 	friend class CDefaultPathDrawer;
 
 	const unsigned int BLOCKS_TO_UPDATE;
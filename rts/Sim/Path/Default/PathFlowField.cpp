@@ -0,0 +1,156 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+#include "PathFlowField.h"
+#include "PathConstants.h"
+#include "PathEstimator.h"
+#include "Map/ReadMap.h"
+#include "Sim/MoveTypes/MoveDefHandler.h"
+#include "Sim/MoveTypes/MoveMath/MoveMath.h"
+#include "System/myMath.h"
+
+
+
+CPathFlowField::CPathFlowField(const CPathEstimator* pe, const MoveDef* md, const float3& pos, bool syncedField)
+	: pathEstimator(pe)
+	, moveDef(md)
+	, goalPos(pos)
+	, goalBlockIdx(0)
+	, refCount(0)
+	, synced(syncedField)
+	, stale(true)
+{
+	goalBlockIdx = GetBlockIdx(goalPos);
+}
+
+
+unsigned int CPathFlowField::GetBlockIdx(const float3& pos) const
+{
+	const int2 numBlocks = pathEstimator->GetNumBlocks();
+	const int2 blockPos(
+		Clamp(int(pos.x / pathEstimator->BLOCK_PIXEL_SIZE), 0, numBlocks.x - 1),
+		Clamp(int(pos.z / pathEstimator->BLOCK_PIXEL_SIZE), 0, numBlocks.y - 1)
+	);
+
+	return (pathEstimator->BlockPosToIdx(blockPos));
+}
+
+
+void CPathFlowField::Calculate()
+{
+	typedef std::pair<float, unsigned int> QueueItem;
+
+	const int2 numBlocks = pathEstimator->GetNumBlocks();
+	const unsigned int numBlockIdcs = numBlocks.x * numBlocks.y;
+	const unsigned int vertexBaseIdx = moveDef->pathType * numBlockIdcs * PATH_DIRECTION_VERTICES;
+
+	const std::vector<float>& vertexCosts = pathEstimator->vertexCosts;
+	const std::vector<int2>& nodeOffsets = pathEstimator->blockStates.peNodeOffsets[moveDef->pathType];
+
+	costs.clear();
+	costs.resize(numBlockIdcs, PATHCOST_INFINITY);
+	nextDirs.clear();
+	nextDirs.resize(numBlockIdcs, PATH_DIRECTIONS);
+
+	// ties are broken by block index, which keeps the result deterministic
+	std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem> > openBlocks;
+
+	costs[goalBlockIdx] = 0.0f;
+	openBlocks.push(QueueItem(0.0f, goalBlockIdx));
+
+	while (!openBlocks.empty()) {
+		const QueueItem item = openBlocks.top();
+		openBlocks.pop();
+
+		if (item.first > costs[item.second])
+			continue;
+
+		// units travel from the neighbors into this block, so it is the
+		// one whose extra cost applies (as in CPathEstimator::TestBlock)
+		const int2 blockPos = pathEstimator->BlockIdxToPos(item.second);
+		const int2 square = nodeOffsets[item.second];
+		const float extraCost = pathEstimator->blockStates.GetNodeExtraCost(square.x, square.y, synced);
+
+		for (unsigned int pathDir = 0; pathDir < PATH_DIRECTIONS; pathDir++) {
+			const int2 nbrBlockPos = blockPos + CPathEstimator::PE_DIRECTION_VECTORS[pathDir];
+
+			if ((unsigned)nbrBlockPos.x >= numBlocks.x) continue;
+			if ((unsigned)nbrBlockPos.y >= numBlocks.y) continue;
+
+			// vertex costs are bi-directional
+			const unsigned int vertexIdx = vertexBaseIdx + item.second * PATH_DIRECTION_VERTICES + GetBlockVertexOffset(pathDir, numBlocks.x);
+			const float vertexCost = vertexCosts[vertexIdx];
+
+			if (vertexCost >= PATHCOST_INFINITY)
+				continue;
+
+			const unsigned int nbrBlockIdx = pathEstimator->BlockPosToIdx(nbrBlockPos);
+			const float nbrCost = item.first + vertexCost + extraCost;
+
+			if (nbrCost >= costs[nbrBlockIdx])
+				continue;
+
+			// the neighbor continues in the opposite direction
+			costs[nbrBlockIdx] = nbrCost;
+			nextDirs[nbrBlockIdx] = (pathDir + (PATH_DIRECTIONS >> 1)) % PATH_DIRECTIONS;
+
+			openBlocks.push(QueueItem(nbrCost, nbrBlockIdx));
+		}
+	}
+
+	stale = false;
+}
+
+
+bool CPathFlowField::IsReachable(const float3& pos) const
+{
+	if (costs.empty())
+		return false;
+
+	return (costs[GetBlockIdx(pos)] < PATHCOST_INFINITY);
+}
+
+
+bool CPathFlowField::GetPath(const float3& pos, float minDist, IPath::Path& path) const
+{
+	path.path.clear();
+	path.squares.clear();
+	path.pathCost = PATHCOST_INFINITY;
+
+	if (!IsReachable(pos))
+		return false;
+
+	const std::vector<int2>& nodeOffsets = pathEstimator->blockStates.peNodeOffsets[moveDef->pathType];
+
+	unsigned int blockIdx = GetBlockIdx(pos);
+
+	path.pathCost = costs[blockIdx];
+
+	// waypoints are collected front-to-back, then reversed
+	while (true) {
+		if (blockIdx == goalBlockIdx) {
+			path.path.push_back(goalPos);
+			break;
+		}
+
+		const int2 square = nodeOffsets[blockIdx];
+		path.path.push_back(SquareToFloat3(square.x, square.y));
+		path.path.back().y = CMoveMath::yLevel(*moveDef, square.x, square.y);
+
+		// always include the first block after the start block
+		if (path.path.size() > 2 && pos.SqDistance2D(path.path.back()) >= Square(minDist))
+			break;
+
+		const int2 blockPos = pathEstimator->BlockIdxToPos(blockIdx);
+		const int2 nextBlockPos = blockPos + CPathEstimator::PE_DIRECTION_VECTORS[nextDirs[blockIdx]];
+
+		blockIdx = pathEstimator->BlockPosToIdx(nextBlockPos);
+	}
+
+	std::reverse(path.path.begin(), path.path.end());
+	path.pathGoal = path.path.front();
+	return true;
+}
@@ -0,0 +1,69 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef PATH_FLOWFIELD_H
+#define PATH_FLOWFIELD_H
+
+#include <vector>
+
+#include "IPath.h"
+#include "System/float3.h"
+#include "System/type2.h"
+
+class CPathEstimator;
+struct MoveDef;
+
+/**
+ * Shared path for groups of units moving to the same goal.
+ *
+ * Holds the cost-to-goal of every block of an estimator (a Dijkstra
+ * integration over its cached vertex costs, seeded at the goal block)
+ * and the direction in which each block continues toward the goal.
+ * It is computed once per (MoveDef, goal) and sampled by all paths
+ * sharing it instead of each running its own estimator search.
+ */
+class CPathFlowField {
+public:
+	CPathFlowField(const CPathEstimator* pe, const MoveDef* md, const float3& goalPos, bool synced);
+
+	void Calculate();
+
+	/// called on terrain changes, recalculates once the estimator is up to date
+	void MarkStale() { stale = true; }
+	bool IsStale() const { return stale; }
+
+	bool IsReachable(const float3& pos) const;
+
+	/**
+	 * Stores the block waypoints from <pos> toward the goal, covering
+	 * at least <minDist> elmos if possible, in <path> (back-to-front,
+	 * like the estimators do). Returns false if <pos> can not reach
+	 * the goal.
+	 */
+	bool GetPath(const float3& pos, float minDist, IPath::Path& path) const;
+
+	const MoveDef* GetMoveDef() const { return moveDef; }
+
+	unsigned int GetRefCount() const { return refCount; }
+	void AddRef() { ++refCount; }
+	void RemoveRef() { --refCount; }
+
+private:
+	unsigned int GetBlockIdx(const float3& pos) const;
+
+private:
+	const CPathEstimator* pathEstimator;
+	const MoveDef* moveDef;
+
+	const float3 goalPos;
+	unsigned int goalBlockIdx;
+
+	std::vector<float> costs;               ///< per block, PATHCOST_INFINITY if unreachable
+	std::vector<unsigned char> nextDirs;    ///< per block, PATHDIR_* toward the goal
+
+	unsigned int refCount;
+
+	bool synced;
+	bool stale;
+};
+
+#endif
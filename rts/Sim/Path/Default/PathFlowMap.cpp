@@ -1,5 +1,7 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
+
 #include "PathFlowMap.hpp"
 #include "PathConstants.h"
 #include "Sim/Misc/GlobalSynced.h"
@@ -7,12 +9,19 @@
 #include "Sim/Objects/SolidObject.h"
 #include "System/myMath.h"
 
+// the pathfinders do not take flow into account unless this is 1
+// (changes path costs, so it must be the same for all clients)
+#define FLOW_MAP_ENABLED     0
 #define FLOW_EPSILON         0.01f
 #define FLOW_DECAY_ENABLED   0
 #define FLOW_DECAY_FACTOR    0.86f
 #define FLOW_COST_MULT      32.00f
 #define FLOW_NGB_PROJECTION  0
 
+// flow-map cells per tile side, Update only visits tiles that were touched
+static const unsigned int FLOW_TILE_SIZE  = 8;
+static const unsigned int FLOW_TILE_CELLS = FLOW_TILE_SIZE * FLOW_TILE_SIZE;
+
 PathFlowMap* PathFlowMap::GetInstance() {
 	static PathFlowMap* pfm = NULL;
 
@@ -41,12 +50,18 @@ PathFlowMap::PathFlowMap(unsigned int scalex, unsigned int scalez) {
 	zsize  = gs->mapy / zscale;
 	xfact  = SQUARE_SIZE * xscale;
 	zfact  = SQUARE_SIZE * zscale;
+	xtiles = (xsize + FLOW_TILE_SIZE - 1) / FLOW_TILE_SIZE;
+	ztiles = (zsize + FLOW_TILE_SIZE - 1) / FLOW_TILE_SIZE;
 
-	maxFlow[fBufferIdx] = 0.0f;
-	maxFlow[bBufferIdx] = 0.0f;
+	for (unsigned int n = 0; n < 2; n++) {
+		FlowBuffer& buffer = buffers[n];
 
-	buffers[fBufferIdx].resize(xsize * zsize, FlowCell());
-	buffers[bBufferIdx].resize(xsize * zsize, FlowCell());
+		buffer.flowX.resize(xtiles * ztiles * FLOW_TILE_CELLS, 0.0f);
+		buffer.flowZ.resize(xtiles * ztiles * FLOW_TILE_CELLS, 0.0f);
+		buffer.flowY.resize(xtiles * ztiles * FLOW_TILE_CELLS, 0.0f);
+		buffer.numObjects.resize(xtiles * ztiles * FLOW_TILE_CELLS, 0);
+		buffer.dirtyTiles.resize((xtiles * ztiles + 31) / 32, 0);
+	}
 
 	pathOptDirs.resize(PATH_DIRECTIONS << 1);
 
@@ -58,107 +73,126 @@ PathFlowMap::PathFlowMap(unsigned int scalex, unsigned int scalez) {
 	pathOptDirs[PATHOPT_RIGHT | PATHOPT_UP  ] = (pathOptDirs[PATHOPT_RIGHT] + pathOptDirs[PATHOPT_UP  ]) * s;
 	pathOptDirs[PATHOPT_RIGHT | PATHOPT_DOWN] = (pathOptDirs[PATHOPT_RIGHT] + pathOptDirs[PATHOPT_DOWN]) * s;
 	pathOptDirs[PATHOPT_LEFT  | PATHOPT_DOWN] = (pathOptDirs[PATHOPT_LEFT ] + pathOptDirs[PATHOPT_DOWN]) * s;
-
-	for (unsigned int n = 0; n < xsize * zsize; n++) {
-		const unsigned int x = n % xsize;
-		const unsigned int z = n / xsize;
-		const float3 p = float3((x * xfact) + (xfact >> 1), 0.0f, (z * zfact) + (zfact >> 1));
-
-		buffers[fBufferIdx][n].cellCenter = p;
-		buffers[bBufferIdx][n].cellCenter = p;
-	}
 }
 
 PathFlowMap::~PathFlowMap() {
-	buffers[fBufferIdx].clear();
-	buffers[bBufferIdx].clear();
-	indices[fBufferIdx].clear();
-	indices[bBufferIdx].clear();
-
 	pathOptDirs.clear();
 }
 
 void PathFlowMap::Update() {
+	#if (FLOW_MAP_ENABLED == 0)
 	return;
+	#endif
+
+	FlowBuffer& fBuffer = buffers[fBufferIdx];
+	FlowBuffer& bBuffer = buffers[bBufferIdx];
 
-	std::vector<FlowCell>& fCells = buffers[fBufferIdx];
-	std::vector<FlowCell>& bCells = buffers[bBufferIdx];
-	std::set<unsigned int>& fIndices = indices[fBufferIdx];
-	std::set<unsigned int>& bIndices = indices[bBufferIdx];
+	// only visit the tiles touched since the last swap
+	for (unsigned int tileIdx = 0; tileIdx < xtiles * ztiles; tileIdx++) {
+		if (fBuffer.dirtyTiles[tileIdx >> 5] == 0) {
+			tileIdx |= 31;
+			continue;
+		}
 
-	std::set<unsigned int>::iterator it;
-	std::set<unsigned int>::iterator nit;
+		if (!fBuffer.IsTileDirty(tileIdx))
+			continue;
 
-	#if (FLOW_DECAY_ENABLED == 0)
-		for (it = fIndices.begin(); it != fIndices.end(); ++it) {
-			FlowCell& fCell = fCells[*it];
+		#if (FLOW_DECAY_ENABLED == 0)
+		ClearTile(fBuffer, tileIdx);
+		#else
+		DecayTile(fBuffer, bBuffer, tileIdx);
+		#endif
+	}
 
-			fCell.flowVector = ZeroVector;
-			fCell.numObjects = 0;
+	for (unsigned int tileIdx = 0; tileIdx < xtiles * ztiles; tileIdx++) {
+		if (bBuffer.dirtyTiles[tileIdx >> 5] == 0) {
+			tileIdx |= 31;
+			continue;
 		}
 
-		fIndices.clear();
-	#else
-		for (it = fIndices.begin(); it != fIndices.end(); ) {
-			nit = it; ++nit;
+		if (!bBuffer.IsTileDirty(tileIdx))
+			continue;
 
-			FlowCell& fCell = fCells[*it];
-			float3& fCellFlow = fCell.flowVector;
+		NormalizeTile(bBuffer, tileIdx);
+	}
 
-			bool fCellReset = false;
 
-			if (bIndices.find(*it) == bIndices.end()) {
-				// if the cell at index <*it> was NOT written to
-				// during any AddFlow call last frame (meaning no
-				// units were projected into it), start decaying
-				// its flow-strength contribution
-				fCellFlow.y *= FLOW_DECAY_FACTOR;
-				fCellReset = (fCellFlow.y < FLOW_EPSILON);
-			} else {
-				// otherwise, force a cell reset
-				fCellReset = true;
-			}
+	// swap the buffers
+	fBufferIdx = (fBufferIdx + 1) & 1;
+	bBufferIdx = (bBufferIdx + 1) & 1;
 
-			if (fCellReset) {
-				fCell.flowVector = ZeroVector;
-				fCell.numObjects = 0;
+	buffers[bBufferIdx].maxFlow = 0.0f;
+}
 
-				fIndices.erase(it);
-			}
 
-			it = nit;
-		}
-	#endif
+void PathFlowMap::ClearTile(FlowBuffer& buffer, unsigned int tileIdx) {
+	const unsigned int i0 = tileIdx * FLOW_TILE_CELLS;
+	const unsigned int i1 = i0 + FLOW_TILE_CELLS;
 
-	for (it = bIndices.begin(); it != bIndices.end(); ++it) {
-		FlowCell& bCell = bCells[*it];
+	std::fill(buffer.flowX.begin() + i0, buffer.flowX.begin() + i1, 0.0f);
+	std::fill(buffer.flowZ.begin() + i0, buffer.flowZ.begin() + i1, 0.0f);
+	std::fill(buffer.flowY.begin() + i0, buffer.flowY.begin() + i1, 0.0f);
+	std::fill(buffer.numObjects.begin() + i0, buffer.numObjects.begin() + i1, 0);
 
-		if (bCell.flowVector.SqLength2D() > FLOW_EPSILON) {
-			const float flowLen = bCell.flowVector.Length2D();
+	buffer.ClearTileDirty(tileIdx);
+}
 
-			bCell.flowVector.x /= flowLen;
-			bCell.flowVector.z /= flowLen;
-		}
+void PathFlowMap::DecayTile(FlowBuffer& fBuffer, const FlowBuffer& bBuffer, unsigned int tileIdx) {
+	const unsigned int i0 = tileIdx * FLOW_TILE_CELLS;
+	const unsigned int i1 = i0 + FLOW_TILE_CELLS;
 
-		// note: if FLOW_DECAY_ENABLED == 1, all cells whose normalized
-		// flow-strength is less than FLOW_EPSILON will also be decayed
-		// (this can be problematic if the range of unit mass values is
-		// wide and there are units at both extremes in-game)
-		if (maxFlow[bBufferIdx] > FLOW_EPSILON) {
-			bCell.flowVector.y /= maxFlow[bBufferIdx];
-		}
+	unsigned int numActiveCells = 0;
+
+	for (unsigned int i = i0; i < i1; i++) {
+		// if the cell was NOT written to during any AddFlow call last
+		// frame (meaning no units were projected into it), decay its
+		// flow-strength contribution, otherwise force a cell reset
+		const float decayedFlow = fBuffer.flowY[i] * FLOW_DECAY_FACTOR;
+		const bool resetCell = (bBuffer.numObjects[i] != 0 || decayedFlow < FLOW_EPSILON);
+
+		fBuffer.flowX[i] = resetCell? 0.0f: fBuffer.flowX[i];
+		fBuffer.flowZ[i] = resetCell? 0.0f: fBuffer.flowZ[i];
+		fBuffer.flowY[i] = resetCell? 0.0f: decayedFlow;
+		fBuffer.numObjects[i] = resetCell? 0: fBuffer.numObjects[i];
+
+		numActiveCells += (!resetCell);
 	}
 
+	if (numActiveCells == 0) {
+		fBuffer.ClearTileDirty(tileIdx);
+	}
+}
 
-	// swap the buffers
-	fBufferIdx = (fBufferIdx + 1) & 1;
-	bBufferIdx = (bBufferIdx + 1) & 1;
+void PathFlowMap::NormalizeTile(FlowBuffer& buffer, unsigned int tileIdx) {
+	const unsigned int i0 = tileIdx * FLOW_TILE_CELLS;
+	const unsigned int i1 = i0 + FLOW_TILE_CELLS;
 
-	maxFlow[bBufferIdx] = 0.0f;
+	for (unsigned int i = i0; i < i1; i++) {
+		const float sqFlowLen = buffer.flowX[i] * buffer.flowX[i] + buffer.flowZ[i] * buffer.flowZ[i];
+		const float flowLen = (sqFlowLen > FLOW_EPSILON)? math::sqrt(sqFlowLen): 1.0f;
+
+		buffer.flowX[i] /= flowLen;
+		buffer.flowZ[i] /= flowLen;
+	}
+
+	// note: if FLOW_DECAY_ENABLED == 1, all cells whose normalized
+	// flow-strength is less than FLOW_EPSILON will also be decayed
+	// (this can be problematic if the range of unit mass values is
+	// wide and there are units at both extremes in-game)
+	if (buffer.maxFlow > FLOW_EPSILON) {
+		const float maxFlow = buffer.maxFlow;
+
+		for (unsigned int i = i0; i < i1; i++) {
+			buffer.flowY[i] /= maxFlow;
+		}
+	}
 }
 
+
 void PathFlowMap::AddFlow(const CSolidObject* o) {
+	#if (FLOW_MAP_ENABLED == 0)
 	return;
+	#endif
 
 	if (!o->HasCollidableStateBit(CSolidObject::CSTATE_BIT_SOLIDOBJECTS)) {
 		return;
@@ -172,74 +206,76 @@ void PathFlowMap::AddFlow(const CSolidObject* o) {
 
 	// prevent self-obstruction if the unit is not moving
 	const float3& flowVec = (Square(o->speed.w) >= 1.0f)? float3(o->speed): GetVectorFromHeading(o->heading);
-	const unsigned int cellIdx = GetCellIdx(o);
+	const float flowStrength = o->mass * o->moveDef->flowMod;
 
-	std::vector<FlowCell>& bCells = buffers[bBufferIdx];
-	std::set<unsigned int>& bIndices = indices[bBufferIdx];
+	const unsigned int x = std::min(xsize - 1, (unsigned int)(o->pos.x / xfact));
+	const unsigned int z = std::min(zsize - 1, (unsigned int)(o->pos.z / zfact));
 
-	FlowCell& bCell = bCells[cellIdx];
+	FlowBuffer& bBuffer = buffers[bBufferIdx];
 
-	bCell.flowVector.x += (flowVec.x);
-	bCell.flowVector.z += (flowVec.z);
-	bCell.flowVector.y += (o->mass * o->moveDef->flowMod);
-	bCell.numObjects   += 1;
-
-	bIndices.insert(cellIdx);
+	AddCellFlow(bBuffer, x, z, flowVec, flowStrength);
 
 	#if (FLOW_NGB_PROJECTION == 1)
 	{
-		const unsigned int x = cellIdx % xsize;
-		const unsigned int z = cellIdx / xsize;
-		      unsigned int i = -1U;
+		const float cellCenterX = (x * xfact) + (xfact >> 1);
+		const float cellCenterZ = (z * zfact) + (zfact >> 1);
 
 		const bool halfSpaces[4] = {
-			(o->pos.x <  bCell.cellCenter.x && x >         0),
-			(o->pos.x >= bCell.cellCenter.x && x < xsize - 1),
-			(o->pos.z <  bCell.cellCenter.z && z >         0),
-			(o->pos.z >= bCell.cellCenter.z && z < zsize - 1),
+			(o->pos.x <  cellCenterX && x >         0),
+			(o->pos.x >= cellCenterX && x < xsize - 1),
+			(o->pos.z <  cellCenterZ && z >         0),
+			(o->pos.z >= cellCenterZ && z < zsize - 1),
 		};
 
-		FlowCell* ngbs[3] = {NULL, NULL, NULL};
-
-		if (halfSpaces[0]) {  i = ((z    ) * xsize + (x - 1));  bIndices.insert(i);  ngbs[0] = &bCells[i];  }
-		if (halfSpaces[1]) {  i = ((z    ) * xsize + (x + 1));  bIndices.insert(i);  ngbs[0] = &bCells[i];  }
-		if (halfSpaces[2]) {  i = ((z - 1) * xsize + (x    ));  bIndices.insert(i);  ngbs[1] = &bCells[i];  }
-		if (halfSpaces[3]) {  i = ((z + 1) * xsize + (x    ));  bIndices.insert(i);  ngbs[1] = &bCells[i];  }
-
-		     if (halfSpaces[0] && halfSpaces[2]) {  i = ((z - 1) * xsize + (x - 1));  bIndices.insert(i);  ngbs[2] = &bCells[i];  }
-		else if (halfSpaces[0] && halfSpaces[3]) {  i = ((z + 1) * xsize + (x - 1));  bIndices.insert(i);  ngbs[2] = &bCells[i];  }
-		else if (halfSpaces[1] && halfSpaces[2]) {  i = ((z - 1) * xsize + (x + 1));  bIndices.insert(i);  ngbs[2] = &bCells[i];  }
-		else if (halfSpaces[1] && halfSpaces[3]) {  i = ((z + 1) * xsize + (x + 1));  bIndices.insert(i);  ngbs[2] = &bCells[i];  }
+		if (halfSpaces[0]) {  AddCellFlow(bBuffer, x - 1, z    , flowVec, flowStrength * 0.666f);  }
+		if (halfSpaces[1]) {  AddCellFlow(bBuffer, x + 1, z    , flowVec, flowStrength * 0.666f);  }
+		if (halfSpaces[2]) {  AddCellFlow(bBuffer, x    , z - 1, flowVec, flowStrength * 0.666f);  }
+		if (halfSpaces[3]) {  AddCellFlow(bBuffer, x    , z + 1, flowVec, flowStrength * 0.666f);  }
 
-		if (ngbs[0] != NULL) {  ngbs[0]->flowVector += float3(flowVec.x, o->mass * o->moveDef->flowMod * 0.666f, flowVec.z);  ngbs[0]->numObjects += 1;  }
-		if (ngbs[1] != NULL) {  ngbs[1]->flowVector += float3(flowVec.x, o->mass * o->moveDef->flowMod * 0.666f, flowVec.z);  ngbs[1]->numObjects += 1;  }
-		if (ngbs[2] != NULL) {  ngbs[2]->flowVector += float3(flowVec.x, o->mass * o->moveDef->flowMod * 0.333f, flowVec.z);  ngbs[2]->numObjects += 1;  }
+		     if (halfSpaces[0] && halfSpaces[2]) {  AddCellFlow(bBuffer, x - 1, z - 1, flowVec, flowStrength * 0.333f);  }
+		else if (halfSpaces[0] && halfSpaces[3]) {  AddCellFlow(bBuffer, x - 1, z + 1, flowVec, flowStrength * 0.333f);  }
+		else if (halfSpaces[1] && halfSpaces[2]) {  AddCellFlow(bBuffer, x + 1, z - 1, flowVec, flowStrength * 0.333f);  }
+		else if (halfSpaces[1] && halfSpaces[3]) {  AddCellFlow(bBuffer, x + 1, z + 1, flowVec, flowStrength * 0.333f);  }
 	}
 	#endif
+}
+
+void PathFlowMap::AddCellFlow(FlowBuffer& buffer, unsigned int x, unsigned int z, const float3& flowVec, float flowStrength) {
+	const unsigned int cellIdx = GetCellIdx(x, z);
+
+	buffer.flowX[cellIdx] += flowVec.x;
+	buffer.flowZ[cellIdx] += flowVec.z;
+	buffer.flowY[cellIdx] += flowStrength;
+	buffer.numObjects[cellIdx] += 1;
 
-	maxFlow[bBufferIdx] = std::max(maxFlow[bBufferIdx], bCell.flowVector.y);
+	buffer.SetTileDirty(cellIdx / FLOW_TILE_CELLS);
+	buffer.maxFlow = std::max(buffer.maxFlow, buffer.flowY[cellIdx]);
 }
 
 
 
-unsigned int PathFlowMap::GetCellIdx(const CSolidObject* o) const {
-	const unsigned int xcell = o->pos.x / xfact;
-	const unsigned int zcell = o->pos.z / zfact;
+unsigned int PathFlowMap::GetCellIdx(unsigned int x, unsigned int z) const {
+	const unsigned int tileIdx = (z / FLOW_TILE_SIZE) * xtiles + (x / FLOW_TILE_SIZE);
+	const unsigned int tileOfs = (z % FLOW_TILE_SIZE) * FLOW_TILE_SIZE + (x % FLOW_TILE_SIZE);
 
-	return (zcell * xsize + xcell);
+	return (tileIdx * FLOW_TILE_CELLS + tileOfs);
 }
 
-const float3& PathFlowMap::GetFlowVec(unsigned int hmx, unsigned int hmz) const {
+float3 PathFlowMap::GetFlowVec(unsigned int hmx, unsigned int hmz) const {
+	#if (FLOW_MAP_ENABLED == 0)
 	return ZeroVector;
+	#endif
 
-	const std::vector<FlowCell>& fCells = buffers[fBufferIdx];
-	const unsigned int fCellIdx = (hmz / zscale) * xsize + (hmx / xscale);
+	const FlowBuffer& fBuffer = buffers[fBufferIdx];
+	const unsigned int fCellIdx = GetCellIdx(std::min(xsize - 1, hmx / xscale), std::min(zsize - 1, hmz / zscale));
 
-	return (fCells[fCellIdx].flowVector);
+	return (float3(fBuffer.flowX[fCellIdx], fBuffer.flowY[fCellIdx], fBuffer.flowZ[fCellIdx]));
 }
 
 float PathFlowMap::GetFlowCost(unsigned int x, unsigned int z, const MoveDef& md, unsigned int pathOpt) const {
+	#if (FLOW_MAP_ENABLED == 0)
 	return 0.0f;
+	#endif
 
 	const float3& flowVec = GetFlowVec(x, z);
 	const float3& pathDir = pathOptDirs[pathOpt];
@@ -3,8 +3,8 @@
 #ifndef PATH_FLOWMAP_HDR
 #define PATH_FLOWMAP_HDR
 
-#include <set>
 #include <vector>
+#include <boost/cstdint.hpp>
 
 #include "System/type2.h"
 #include "System/float3.h"
@@ -13,16 +13,6 @@ struct MoveDef;
 class CSolidObject;
 class PathFlowMap {
 public:
-	struct FlowCell {
-		FlowCell(): numObjects(0) {
-		}
-
-		float3 flowVector;
-		float3 cellCenter; // WS
-
-		unsigned int numObjects;
-	};
-
 	static PathFlowMap* GetInstance();
 	static void FreeInstance(PathFlowMap*);
 
@@ -32,21 +22,44 @@ public:
 	void Update();
 	void AddFlow(const CSolidObject*);
 
-	const float3& GetFlowVec(unsigned int hmx, unsigned int hmz) const;
+	float3 GetFlowVec(unsigned int hmx, unsigned int hmz) const;
 	float GetFlowCost(unsigned int x, unsigned int z, const MoveDef&, unsigned int opt) const;
-	float GetMaxFlow() const { return maxFlow[fBufferIdx]; }
+	float GetMaxFlow() const { return buffers[fBufferIdx].maxFlow; }
 
 	unsigned int GetFrontBufferIdx() const { return fBufferIdx; }
 	unsigned int GetBackBufferIdx() const { return bBufferIdx; }
 
-	const std::vector<FlowCell>& GetFrontBuffer() { return buffers[fBufferIdx]; }
-	const std::vector<FlowCell>& GetBackBuffer() { return buffers[bBufferIdx]; }
-
 private:
-	unsigned int GetCellIdx(const CSolidObject*) const;
+	/**
+	 * Dense grid of cells, stored per component and tile-major so that
+	 * every tile is one contiguous run of cells. Only the tiles flagged
+	 * in dirtyTiles can hold non-zero values, Update streams over those.
+	 */
+	struct FlowBuffer {
+		FlowBuffer(): maxFlow(0.0f) {}
+
+		bool IsTileDirty(unsigned int tileIdx) const { return ((dirtyTiles[tileIdx >> 5] & (1u << (tileIdx & 31))) != 0); }
+		void SetTileDirty(unsigned int tileIdx) { dirtyTiles[tileIdx >> 5] |= (1u << (tileIdx & 31)); }
+		void ClearTileDirty(unsigned int tileIdx) { dirtyTiles[tileIdx >> 5] &= ~(1u << (tileIdx & 31)); }
+
+		std::vector<float> flowX;
+		std::vector<float> flowZ;
+		std::vector<float> flowY; ///< flow strength
+		std::vector<unsigned int> numObjects;
+
+		std::vector<boost::uint32_t> dirtyTiles;
+
+		float maxFlow;
+	};
+
+	unsigned int GetCellIdx(unsigned int x, unsigned int z) const;
+	void AddCellFlow(FlowBuffer& buffer, unsigned int x, unsigned int z, const float3& flowVec, float flowStrength);
 
-	std::vector<FlowCell> buffers[2];
-	std::set<unsigned int> indices[2];
+	void ClearTile(FlowBuffer& buffer, unsigned int tileIdx);
+	void DecayTile(FlowBuffer& fBuffer, const FlowBuffer& bBuffer, unsigned int tileIdx);
+	void NormalizeTile(FlowBuffer& buffer, unsigned int tileIdx);
+
+	FlowBuffer buffers[2];
 
 	std::vector<float3> pathOptDirs;
 
@@ -54,8 +67,7 @@ private:
 	unsigned int bBufferIdx;
 	unsigned int xscale, xsize, xfact;
 	unsigned int zscale, zsize, zfact;
-
-	float maxFlow[2];
+	unsigned int xtiles, ztiles;
 };
 
 #endif
@@ -5,12 +5,14 @@
 #include "PathConstants.h"
 #include "PathFinder.h"
 #include "PathEstimator.h"
+#include "PathFlowField.h"
 #include "PathFlowMap.hpp"
 #include "PathHeatMap.hpp"
 #include "PathLog.h"
 #include "Map/MapInfo.h"
 #include "Sim/Misc/GeometricObjects.h"
 #include "Sim/Misc/GlobalSynced.h"
+#include "Sim/Misc/ModInfo.h"
 #include "Sim/Objects/SolidObjectDef.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "System/Log/ILog.h"
@@ -27,6 +29,7 @@ CPathManager::CPathManager(): nextPathID(0)
 	maxResPF = NULL;
 	medResPE = NULL;
 	lowResPE = NULL;
+	coarsePE = NULL;
 
 	pathFlowMap = PathFlowMap::GetInstance();
 	pathHeatMap = PathHeatMap::GetInstance();
@@ -34,6 +37,11 @@ CPathManager::CPathManager(): nextPathID(0)
 
 CPathManager::~CPathManager()
 {
+	for (auto it = flowFields.begin(); it != flowFields.end(); ++it) {
+		delete it->second;
+	}
+
+	delete coarsePE; coarsePE = NULL;
 	delete lowResPE; lowResPE = NULL;
 	delete medResPE; medResPE = NULL;
 	delete maxResPF; maxResPF = NULL;
@@ -49,6 +57,7 @@ boost::int64_t CPathManager::Finalize() {
 		maxResPF = new CPathFinder();
 		medResPE = new CPathEstimator(maxResPF, MEDRES_PE_BLOCKSIZE, "pe",  mapInfo->map.name);
 		lowResPE = new CPathEstimator(medResPE, LOWRES_PE_BLOCKSIZE, "pe2", mapInfo->map.name);
+		coarsePE = new CPathEstimator(lowResPE, COARSE_PE_BLOCKSIZE, "pe3", mapInfo->map.name);
 
 		#ifdef SYNCDEBUG
 		// clients may have a non-writable cache directory (which causes
@@ -69,7 +78,10 @@ boost::int64_t CPathManager::Finalize() {
 
 void CPathManager::FinalizePath(MultiPath* path, const float3 startPos, const float3 goalPos, const bool cantGetCloser)
 {
-	IPath::Path* sp = &path->lowResPath;
+	IPath::Path* sp = &path->coarsePath;
+	if (!path->lowResPath.path.empty()) {
+		sp = &path->lowResPath;
+	}
 	if (!path->medResPath.path.empty()) {
 		sp = &path->medResPath;
 	}
@@ -87,8 +99,13 @@ void CPathManager::FinalizePath(MultiPath* path, const float3 startPos, const fl
 	if (!path->medResPath.path.empty() && !path->lowResPath.path.empty()) {
 		path->lowResPath.path.back() = path->medResPath.path.front();
 	}
+	if (!path->lowResPath.path.empty() && !path->coarsePath.path.empty()) {
+		path->coarsePath.path.back() = path->lowResPath.path.front();
+	}
 
-	if (cantGetCloser)
+	// flow-field paths only cover the part ahead of the unit, and
+	// end at the goal itself once that is within reach
+	if (cantGetCloser || path->flowField != NULL)
 		return;
 
 	IPath::Path* ep = &path->maxResPath;
@@ -98,6 +115,9 @@ void CPathManager::FinalizePath(MultiPath* path, const float3 startPos, const fl
 	if (!path->lowResPath.path.empty()) {
 		ep = &path->lowResPath;
 	}
+	if (!path->coarsePath.path.empty()) {
+		ep = &path->coarsePath;
+	}
 	if (!ep->path.empty()) {
 		ep->path.front() = goalPos;
 		ep->path.front().y = CMoveMath::yLevel(*path->moveDef, ep->path.front());
@@ -124,10 +144,11 @@ IPath::SearchResult CPathManager::ArrangePath(
 	enum {
 		PATH_MAX_RES = 0,
 		PATH_MED_RES = 1,
-		PATH_LOW_RES = 3
+		PATH_LOW_RES = 3,
+		PATH_COARSE  = 4
 	};
 
-	int origPathRes = PATH_LOW_RES;
+	int origPathRes = PATH_COARSE;
 
 	// first attempt - use ideal pathfinder (performance-wise)
 	{
@@ -135,14 +156,17 @@ IPath::SearchResult CPathManager::ArrangePath(
 			origPathRes = PATH_MAX_RES;
 		} else if (heuristicGoalDist2D < MEDRES_SEARCH_DISTANCE) {
 			origPathRes = PATH_MED_RES;
+		} else if (heuristicGoalDist2D < LOWRES_SEARCH_DISTANCE) {
+			origPathRes = PATH_LOW_RES;
 		//} else {
-		//	origPathRes = PATH_LOW_RES;
+		//	origPathRes = PATH_COARSE;
 		}
 
 		switch (origPathRes) {
 			case PATH_MAX_RES: result = maxResPF->GetPath(*moveDef, *pfDef, caller, startPos, newPath->maxResPath, MAX_SEARCHED_NODES_PF >> 3); break;
 			case PATH_MED_RES: result = medResPE->GetPath(*moveDef, *pfDef, caller, startPos, newPath->medResPath, MAX_SEARCHED_NODES_PE >> 3); break;
 			case PATH_LOW_RES: result = lowResPE->GetPath(*moveDef, *pfDef, caller, startPos, newPath->lowResPath, MAX_SEARCHED_NODES_PE >> 3); break;
+			case PATH_COARSE:  result = coarsePE->GetPath(*moveDef, *pfDef, caller, startPos, newPath->coarsePath, MAX_SEARCHED_NODES_PE >> 3); break;
 		}
 
 		if (result == IPath::Ok) {
@@ -194,6 +218,7 @@ IPath::SearchResult CPathManager::ArrangePath(
 				case PATH_MAX_RES: result = maxResPF->GetPath(*moveDef, *pfDef, caller, startPos, newPath->maxResPath, MAX_SEARCHED_NODES_PF >> 3); break;
 				case PATH_MED_RES: result = medResPE->GetPath(*moveDef, *pfDef, caller, startPos, newPath->medResPath, MAX_SEARCHED_NODES_PE >> 3); break;
 				case PATH_LOW_RES: result = lowResPE->GetPath(*moveDef, *pfDef, caller, startPos, newPath->lowResPath, MAX_SEARCHED_NODES_PE >> 3); break;
+				case PATH_COARSE:  result = coarsePE->GetPath(*moveDef, *pfDef, caller, startPos, newPath->coarsePath, MAX_SEARCHED_NODES_PE >> 3); break;
 			}
 
 			if (result == IPath::Ok) {
@@ -213,6 +238,7 @@ IPath::SearchResult CPathManager::ArrangePath(
 				case PATH_MAX_RES: result = maxResPF->GetPath(*moveDef, *pfDef, caller, startPos, newPath->maxResPath, MAX_SEARCHED_NODES_PF >> 3); break;
 				case PATH_MED_RES: result = medResPE->GetPath(*moveDef, *pfDef, caller, startPos, newPath->medResPath, MAX_SEARCHED_NODES_PE >> 3); break;
 				case PATH_LOW_RES: result = lowResPE->GetPath(*moveDef, *pfDef, caller, startPos, newPath->lowResPath, MAX_SEARCHED_NODES_PE >> 3); break;
+				case PATH_COARSE:  result = coarsePE->GetPath(*moveDef, *pfDef, caller, startPos, newPath->coarsePath, MAX_SEARCHED_NODES_PE >> 3); break;
 			}
 
 			if (result == IPath::Ok) {
@@ -277,7 +303,22 @@ unsigned int CPathManager::RequestPath(
 		caller->UnBlock();
 	}
 
-	IPath::SearchResult result = ArrangePath(newPath, moveDef, startPos, goalPos, pfDef, caller);
+	IPath::SearchResult result = IPath::Error;
+
+	// large groups ordered to the same goal share a flow-field
+	// instead of each doing its own estimator search
+	if ((newPath->flowField = GetFlowField(moveDef, goalPos, synced)) != NULL) {
+		if (newPath->flowField->IsReachable(startPos)) {
+			result = IPath::Ok;
+		} else {
+			ReleaseFlowField(newPath->flowField);
+			newPath->flowField = NULL;
+		}
+	}
+
+	if (newPath->flowField == NULL)
+		result = ArrangePath(newPath, moveDef, startPos, goalPos, pfDef, caller);
+
 	pfDef->DisableConstraint(true);
 
 	unsigned int pathID = 0;
@@ -285,6 +326,8 @@ unsigned int CPathManager::RequestPath(
 	if (result != IPath::Error) {
 		if (newPath->maxResPath.path.empty()) {
 			if (result != IPath::CantGetCloser) {
+				FlowField2MedRes(*newPath, startPos);
+				Coarse2LowRes(*newPath, startPos, caller, synced);
 				LowRes2MedRes(*newPath, startPos, caller, synced);
 				MedRes2MaxRes(*newPath, startPos, caller, synced);
 			} else {
@@ -333,6 +376,7 @@ void CPathManager::MedRes2MaxRes(MultiPath& multiPath, const float3& startPos, c
 	IPath::Path& maxResPath = multiPath.maxResPath;
 	IPath::Path& medResPath = multiPath.medResPath;
 	IPath::Path& lowResPath = multiPath.lowResPath;
+	IPath::Path& coarsePath = multiPath.coarsePath;
 
 	if (medResPath.path.empty())
 		return;
@@ -356,7 +400,7 @@ void CPathManager::MedRes2MaxRes(MultiPath& multiPath, const float3& startPos, c
 
 	// Perform the search.
 	// If this is the final improvement of the path, then use the original goal.
-	auto pfd = (medResPath.path.empty() && lowResPath.path.empty()) ? *multiPath.peDef : rangedGoalDef;
+	auto pfd = (medResPath.path.empty() && lowResPath.path.empty() && coarsePath.path.empty()) ? *multiPath.peDef : rangedGoalDef;
 	const IPath::SearchResult result = maxResPF->GetPath(*multiPath.moveDef, pfd, owner, startPos, maxResPath, MAX_SEARCHED_NODES_ON_REFINE);
 
 	// If no refined path could be found, set goal as desired goal.
@@ -372,6 +416,7 @@ void CPathManager::LowRes2MedRes(MultiPath& multiPath, const float3& startPos, c
 
 	IPath::Path& medResPath = multiPath.medResPath;
 	IPath::Path& lowResPath = multiPath.lowResPath;
+	IPath::Path& coarsePath = multiPath.coarsePath;
 
 	if (lowResPath.path.empty())
 		return;
@@ -395,7 +440,7 @@ void CPathManager::LowRes2MedRes(MultiPath& multiPath, const float3& startPos, c
 
 	// Perform the search.
 	// If there is no low-res path left, use original goal.
-	auto pfd = (lowResPath.path.empty()) ? *multiPath.peDef : rangedGoalDef;
+	auto pfd = (lowResPath.path.empty() && coarsePath.path.empty()) ? *multiPath.peDef : rangedGoalDef;
 	const IPath::SearchResult result = medResPE->GetPath(*multiPath.moveDef, pfd, owner, startPos, medResPath, MAX_SEARCHED_NODES_ON_REFINE);
 
 	// If no refined path could be found, set goal as desired goal.
@@ -404,6 +449,68 @@ void CPathManager::LowRes2MedRes(MultiPath& multiPath, const float3& startPos, c
 	}
 }
 
+// samples the next part of a med-res path from a shared flow-field
+void CPathManager::FlowField2MedRes(MultiPath& multiPath, const float3& startPos) const
+{
+	assert(IsFinalized());
+
+	CPathFlowField* flowField = multiPath.flowField;
+
+	if (flowField == NULL)
+		return;
+
+	// wait for the estimator to process all terrain changes first
+	if (flowField->IsStale() && medResPE->updatedBlocks.empty())
+		flowField->Calculate();
+
+	IPath::Path medResPath;
+
+	// keep the current path if we were pushed off the field
+	if (!flowField->GetPath(startPos, MEDRES_SEARCH_DISTANCE * SQUARE_SIZE, medResPath))
+		return;
+
+	multiPath.medResPath = medResPath;
+}
+
+// converts part of a coarse path into a low-res path
+void CPathManager::Coarse2LowRes(MultiPath& multiPath, const float3& startPos, const CSolidObject* owner, bool synced) const
+{
+	assert(IsFinalized());
+
+	IPath::Path& lowResPath = multiPath.lowResPath;
+	IPath::Path& coarsePath = multiPath.coarsePath;
+
+	if (coarsePath.path.empty())
+		return;
+
+	coarsePath.path.pop_back();
+
+	// remove coarse waypoints until the next one is far enough
+	while (!coarsePath.path.empty() && startPos.SqDistance2D(coarsePath.path.back()) < Square(LOWRES_SEARCH_DISTANCE * SQUARE_SIZE)) {
+		coarsePath.path.pop_back();
+	}
+
+	// get the goal of the detailed search
+	float3 goalPos = coarsePath.pathGoal;
+	if (!coarsePath.path.empty()) {
+		goalPos = coarsePath.path.back();
+	}
+
+	// define the search
+	CCircularSearchConstraint rangedGoalDef(startPos, goalPos, 0.0f, 2.0f, Square(LOWRES_SEARCH_DISTANCE));
+	rangedGoalDef.synced = synced;
+
+	// Perform the search.
+	// If there is no coarse path left, use original goal.
+	auto pfd = (coarsePath.path.empty()) ? *multiPath.peDef : rangedGoalDef;
+	const IPath::SearchResult result = lowResPE->GetPath(*multiPath.moveDef, pfd, owner, startPos, lowResPath, MAX_SEARCHED_NODES_ON_REFINE);
+
+	// If no refined path could be found, set goal as desired goal.
+	if (result == IPath::CantGetCloser || result == IPath::Error) {
+		lowResPath.pathGoal = goalPos;
+	}
+}
+
 
 /*
 Removes and return the next waypoint in the multipath corresponding to given id.
@@ -439,6 +546,7 @@ float3 CPathManager::NextWayPoint(
 	IPath::Path& maxResPath = multiPath->maxResPath;
 	IPath::Path& medResPath = multiPath->medResPath;
 	IPath::Path& lowResPath = multiPath->lowResPath;
+	IPath::Path& coarsePath = multiPath->coarsePath;
 
 	if ((callerPos == ZeroVector) && !maxResPath.path.empty()) {
 		callerPos = maxResPath.path.back();
@@ -449,18 +557,24 @@ float3 CPathManager::NextWayPoint(
 	#define EXTEND_PATH_POINTS(curResPts, nxtResPts, dist) ((!curResPts.empty() && (curResPts.back()).SqDistance2D(callerPos) < Square((dist))) || nxtResPts.size() <= 2)
 	const bool extendMaxResPath = EXTEND_PATH_POINTS(medResPath.path, maxResPath.path, MIN_MAXRES_SEARCH_DISTANCE * SQUARE_SIZE);
 	const bool extendMedResPath = EXTEND_PATH_POINTS(lowResPath.path, medResPath.path, MIN_MEDRES_SEARCH_DISTANCE * SQUARE_SIZE);
+	const bool extendLowResPath = EXTEND_PATH_POINTS(coarsePath.path, lowResPath.path, MIN_LOWRES_SEARCH_DISTANCE * SQUARE_SIZE);
 	#undef EXTEND_PATH_POINTS
 
 	// check whether the max-res path needs extending through
 	// recursive refinement of its lower-resolution segments
-	// if so, check if the med-res path also needs extending
+	// if so, check if the med-res (and in turn the low-res) path
+	// also needs extending
 	if (extendMaxResPath) {
 		if (multiPath->caller != NULL) {
 			multiPath->caller->UnBlock();
 		}
 
-		if (extendMedResPath)
+		if (extendMedResPath) {
+			if (extendLowResPath)
+				Coarse2LowRes(*multiPath, callerPos, owner, synced);
 			LowRes2MedRes(*multiPath, callerPos, owner, synced);
+			FlowField2MedRes(*multiPath, callerPos);
+		}
 		MedRes2MaxRes(*multiPath, callerPos, owner, synced);
 
 		if (multiPath->caller != NULL) {
@@ -479,7 +593,7 @@ float3 CPathManager::NextWayPoint(
 		// the way to it (ie. a GoalOutOfRange result)
 		// OR we are stuck on an impassable square
 		if (maxResPath.path.empty()) {
-			if (lowResPath.path.empty() && medResPath.path.empty()) {
+			if (coarsePath.path.empty() && lowResPath.path.empty() && medResPath.path.empty()) {
 				if (multiPath->searchResult == IPath::Ok) {
 					waypoint = multiPath->finalGoal; break;
 				} else {
@@ -514,11 +628,60 @@ void CPathManager::DeletePath(unsigned int pathID) {
 
 	MultiPath* multiPath = pi->second;
 	pathMap.erase(pi);
+
+	if (multiPath->flowField != NULL)
+		ReleaseFlowField(multiPath->flowField);
+
 	delete multiPath;
 }
 
 
 
+CPathFlowField* CPathManager::GetFlowField(const MoveDef* moveDef, const float3& goalPos, bool synced)
+{
+	if (modInfo.pfFlowFieldGroupSize <= 0)
+		return NULL;
+
+	const unsigned int goalSquareIdx = int(goalPos.z / SQUARE_SIZE) * gs->mapx + int(goalPos.x / SQUARE_SIZE);
+	const boost::uint64_t key = (boost::uint64_t(moveDef->pathType * 2 + synced) << 32) | goalSquareIdx;
+
+	CPathFlowField*& flowField = flowFields[key];
+
+	// the first requests of a group still get their own paths
+	if (flowField == NULL) {
+		if (++flowFieldRequests[key] < (unsigned int) modInfo.pfFlowFieldGroupSize) {
+			flowFields.erase(key);
+			return NULL;
+		}
+
+		flowField = new CPathFlowField(medResPE, moveDef, goalPos, synced);
+		flowField->Calculate();
+	}
+
+	flowField->AddRef();
+	return flowField;
+}
+
+void CPathManager::ReleaseFlowField(CPathFlowField* flowField)
+{
+	flowField->RemoveRef();
+
+	if (flowField->GetRefCount() > 0)
+		return;
+
+	for (auto it = flowFields.begin(); it != flowFields.end(); ++it) {
+		if (it->second != flowField)
+			continue;
+
+		flowFields.erase(it);
+		break;
+	}
+
+	delete flowField;
+}
+
+
+
 // Tells estimators about changes in or on the map.
 void CPathManager::TerrainChange(unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2, unsigned int /*type*/) {
 	SCOPED_TIMER("PathManager::TerrainChange");
@@ -529,6 +692,12 @@ void CPathManager::TerrainChange(unsigned int x1, unsigned int z1, unsigned int
 	medResPE->MapChanged(x1, z1, x2, z2);
 	if (medResPE->nextPathEstimator == nullptr)
 		lowResPE->MapChanged(x1, z1, x2, z2); // is informed via medResPE
+	if (lowResPE->nextPathEstimator == nullptr)
+		coarsePE->MapChanged(x1, z1, x2, z2); // is informed via lowResPE
+
+	for (auto it = flowFields.begin(); it != flowFields.end(); ++it) {
+		it->second->MarkStale();
+	}
 }
 
 
@@ -541,8 +710,11 @@ void CPathManager::Update()
 	pathFlowMap->Update();
 	pathHeatMap->Update();
 
+	flowFieldRequests.clear();
+
 	medResPE->Update();
 	lowResPE->Update();
+	coarsePE->Update();
 }
 
 // used to deposit heat on the heat-map as a unit moves along its path
@@ -613,8 +785,9 @@ void CPathManager::GetPathWayPoints(
 	const IPath::path_list_type& maxResPoints = multiPath->maxResPath.path;
 	const IPath::path_list_type& medResPoints = multiPath->medResPath.path;
 	const IPath::path_list_type& lowResPoints = multiPath->lowResPath.path;
+	const IPath::path_list_type& coarsePoints = multiPath->coarsePath.path;
 
-	points.reserve(maxResPoints.size() + medResPoints.size() + lowResPoints.size());
+	points.reserve(maxResPoints.size() + medResPoints.size() + lowResPoints.size() + coarsePoints.size());
 	starts.reserve(3);
 	starts.push_back(points.size());
 
@@ -633,13 +806,18 @@ void CPathManager::GetPathWayPoints(
 	for (IPath::path_list_type::const_reverse_iterator pvi = lowResPoints.rbegin(); pvi != lowResPoints.rend(); ++pvi) {
 		points.push_back(*pvi);
 	}
+
+	// coarse waypoints continue the last (low-res) section
+	for (IPath::path_list_type::const_reverse_iterator pvi = coarsePoints.rbegin(); pvi != coarsePoints.rend(); ++pvi) {
+		points.push_back(*pvi);
+	}
 }
 
 
 
 boost::uint32_t CPathManager::GetPathCheckSum() const {
 	assert(IsFinalized());
-	return (medResPE->GetPathChecksum() + lowResPE->GetPathChecksum());
+	return (medResPE->GetPathChecksum() + lowResPE->GetPathChecksum() + coarsePE->GetPathChecksum());
 }
 
 
@@ -654,10 +832,12 @@ bool CPathManager::SetNodeExtraCost(unsigned int x, unsigned int z, float cost,
 	PathNodeStateBuffer& maxResBuf = maxResPF->GetNodeStateBuffer();
 	PathNodeStateBuffer& medResBuf = medResPE->GetNodeStateBuffer();
 	PathNodeStateBuffer& lowResBuf = lowResPE->GetNodeStateBuffer();
+	PathNodeStateBuffer& coarseBuf = coarsePE->GetNodeStateBuffer();
 
 	maxResBuf.SetNodeExtraCost(x, z, cost, synced);
 	medResBuf.SetNodeExtraCost(x, z, cost, synced);
 	lowResBuf.SetNodeExtraCost(x, z, cost, synced);
+	coarseBuf.SetNodeExtraCost(x, z, cost, synced);
 	return true;
 }
 
@@ -671,11 +851,13 @@ bool CPathManager::SetNodeExtraCosts(const float* costs, unsigned int sizex, uns
 	PathNodeStateBuffer& maxResBuf = maxResPF->GetNodeStateBuffer();
 	PathNodeStateBuffer& medResBuf = medResPE->GetNodeStateBuffer();
 	PathNodeStateBuffer& lowResBuf = lowResPE->GetNodeStateBuffer();
+	PathNodeStateBuffer& coarseBuf = coarsePE->GetNodeStateBuffer();
 
 	// make all buffers share the same cost-overlay
 	maxResBuf.SetNodeExtraCosts(costs, sizex, sizez, synced);
 	medResBuf.SetNodeExtraCosts(costs, sizex, sizez, synced);
 	lowResBuf.SetNodeExtraCosts(costs, sizex, sizez, synced);
+	coarseBuf.SetNodeExtraCosts(costs, sizex, sizez, synced);
 	return true;
 }
 
@@ -705,7 +887,7 @@ int2 CPathManager::GetNumQueuedUpdates() const {
 
 	if (IsFinalized()) {
 		data.x = medResPE->updatedBlocks.size();
-		data.y = lowResPE->updatedBlocks.size();
+		data.y = lowResPE->updatedBlocks.size() + coarsePE->updatedBlocks.size();
 	}
 
 	return data;
@@ -13,6 +13,7 @@
 class CSolidObject;
 class CPathFinder;
 class CPathEstimator;
+class CPathFlowField;
 class PathFlowMap;
 class PathHeatMap;
 class CPathFinderDef;
@@ -90,11 +91,13 @@ private:
 			, moveDef(moveDef)
 			, finalGoal(ZeroVector)
 			, caller(NULL)
+			, flowField(NULL)
 		{}
 
 		~MultiPath() { delete peDef; }
 
 		// Paths
+		IPath::Path coarsePath;
 		IPath::Path lowResPath;
 		IPath::Path medResPath;
 		IPath::Path maxResPath;
@@ -108,6 +111,10 @@ private:
 		// Additional information.
 		float3 finalGoal;
 		CSolidObject* caller;
+
+		// shared with other paths to the same goal, replaces the
+		// lower-resolution paths if set
+		CPathFlowField* flowField;
 	};
 
 private:
@@ -132,21 +139,31 @@ private:
 	inline MultiPath* GetMultiPath(int pathID) const;
 	unsigned int Store(MultiPath* path);
 	static void FinalizePath(MultiPath* path, const float3 startPos, const float3 goalPos, const bool cantGetCloser);
+	void FlowField2MedRes(MultiPath& path, const float3& startPos) const;
+	void Coarse2LowRes(MultiPath& path, const float3& startPos, const CSolidObject* owner, bool synced) const;
 	void LowRes2MedRes(MultiPath& path, const float3& startPos, const CSolidObject* owner, bool synced) const;
 	void MedRes2MaxRes(MultiPath& path, const float3& startPos, const CSolidObject* owner, bool synced) const;
 
+	CPathFlowField* GetFlowField(const MoveDef* moveDef, const float3& goalPos, bool synced);
+	void ReleaseFlowField(CPathFlowField* flowField);
+
 	bool IsFinalized() const { return (maxResPF != NULL); }
 
 private:
 	CPathFinder* maxResPF;
 	CPathEstimator* medResPE;
 	CPathEstimator* lowResPE;
+	CPathEstimator* coarsePE;
 
 	PathFlowMap* pathFlowMap;
 	PathHeatMap* pathHeatMap;
 
 	std::map<unsigned int, MultiPath*> pathMap;
 	unsigned int nextPathID;
+
+	// keyed by goal-square, pathType and synced-ness
+	std::map<boost::uint64_t, CPathFlowField*> flowFields;
+	std::map<boost::uint64_t, unsigned int> flowFieldRequests; ///< reset every frame
 };
 
 inline CPathManager::MultiPath* CPathManager::GetMultiPath(int pathID) const {
@@ -190,9 +190,20 @@ void QTPFS::QTNode::InitStatic() {
 	MAX_DEPTH  = std::max(1u, mapInfo->pfs.qtpfs_constants.maxNodeDepth);
 }
 
+QTPFS::QTNode::QTNode()
+	: nodeNumber(-1u)
+	, heapIndex(-1u)
+	, poolIndex(-1u)
+	, childBaseIndex(-1u)
+	, ngbsOffset(0)
+	, numNgbs(0)
+{
+}
+
 QTPFS::QTNode::QTNode(
 	const QTNode* parent,
 	unsigned int nn,
+	unsigned int pi,
 	unsigned int x1, unsigned int z1,
 	unsigned int x2, unsigned int z2
 ) {
@@ -225,45 +236,32 @@ QTPFS::QTNode::QTNode(
 
 	prevNode = NULL;
 
-	// for leafs, all children remain NULL
-	children.resize(QTNODE_CHILD_COUNT, NULL);
-}
+	// for leafs, children remain unallocated
+	poolIndex = pi;
+	childBaseIndex = -1u;
 
-QTPFS::QTNode::~QTNode() {
-	children.clear();
-	neighbors.clear();
+	ngbsOffset = 0;
+	numNgbs = 0;
 }
 
-void QTPFS::QTNode::Delete() {
+// releases the subtree below <this> (but not <this> itself,
+// which is only returned to the pool along with its siblings)
+void QTPFS::QTNode::Delete(NodeLayer& nl) {
 	if (!IsLeaf()) {
-		for (unsigned int i = 0; i < children.size(); i++) {
-			children[i]->Delete(); children[i] = NULL;
+		for (unsigned int i = 0; i < QTNODE_CHILD_COUNT; i++) {
+			nl.GetPoolNode(GetChildIndex(i))->Delete(nl);
 		}
+
+		nl.FreeNodeGroup(childBaseIndex);
+		childBaseIndex = -1u;
 	}
 
-	neighbors.clear();
-	delete this;
+	nl.FreeNodeNeighbors(this);
 }
 
 
 
-boost::uint64_t QTPFS::QTNode::GetMemFootPrint() const {
-	boost::uint64_t memFootPrint = sizeof(QTNode);
-
-	if (IsLeaf()) {
-		memFootPrint += (neighbors.size() * sizeof(INode*));
-		memFootPrint += (children.size() * sizeof(QTNode*));
-		memFootPrint += (netpoints.size() * sizeof(float3));
-	} else {
-		for (unsigned int i = 0; i < children.size(); i++) {
-			memFootPrint += (children[i]->GetMemFootPrint());
-		}
-	}
-
-	return memFootPrint;
-}
-
-boost::uint64_t QTPFS::QTNode::GetCheckSum() const {
+boost::uint64_t QTPFS::QTNode::GetCheckSum(const NodeLayer& nl) const {
 	boost::uint64_t sum = 0;
 
 	{
@@ -290,8 +288,8 @@ boost::uint64_t QTPFS::QTNode::GetCheckSum() const {
 	}
 
 	if (!IsLeaf()) {
-		for (unsigned int n = 0; n < children.size(); n++) {
-			sum ^= (((nodeNumber << 8) + 1) * children[n]->GetCheckSum());
+		for (unsigned int n = 0; n < QTNODE_CHILD_COUNT; n++) {
+			sum ^= (((nodeNumber << 8) + 1) * nl.GetPoolNode(GetChildIndex(n))->GetCheckSum(nl));
 		}
 	}
 
@@ -300,15 +298,6 @@ boost::uint64_t QTPFS::QTNode::GetCheckSum() const {
 
 
 
-bool QTPFS::QTNode::IsLeaf() const {
-	assert(children.size() == QTNODE_CHILD_COUNT);
-	assert(
-		(children[0] == NULL && children[1] == NULL && children[2] == NULL && children[3] == NULL) ||
-		(children[0] != NULL && children[1] != NULL && children[2] != NULL && children[3] != NULL)
-	);
-	return (children[0] == NULL);
-}
-
 bool QTPFS::QTNode::CanSplit(bool forced) const {
 	// NOTE: caller must additionally check IsLeaf() before calling Split()
 	if (forced) {
@@ -337,19 +326,18 @@ bool QTPFS::QTNode::Split(NodeLayer& nl, bool forced) {
 	if (!CanSplit(forced))
 		return false;
 
-	neighbors.clear();
-	netpoints.clear();
+	nl.FreeNodeNeighbors(this);
 
-	// can only split leaf-nodes (ie. nodes with NULL-children)
-	assert(children[NODE_IDX_TL] == NULL);
-	assert(children[NODE_IDX_TR] == NULL);
-	assert(children[NODE_IDX_BR] == NULL);
-	assert(children[NODE_IDX_BL] == NULL);
+	// can only split leaf-nodes (ie. nodes without children)
+	assert(IsLeaf());
 
-	children[NODE_IDX_TL] = new QTNode(this, GetChildID(NODE_IDX_TL),  xmin(), zmin(),  xmid(), zmid());
-	children[NODE_IDX_TR] = new QTNode(this, GetChildID(NODE_IDX_TR),  xmid(), zmin(),  xmax(), zmid());
-	children[NODE_IDX_BR] = new QTNode(this, GetChildID(NODE_IDX_BR),  xmid(), zmid(),  xmax(), zmax());
-	children[NODE_IDX_BL] = new QTNode(this, GetChildID(NODE_IDX_BL),  xmin(), zmid(),  xmid(), zmax());
+	// NOTE: this can grow the pool, but never moves existing nodes
+	childBaseIndex = nl.AllocNodeGroup();
+
+	*nl.GetPoolNode(GetChildIndex(NODE_IDX_TL)) = QTNode(this, GetChildID(NODE_IDX_TL), GetChildIndex(NODE_IDX_TL),  xmin(), zmin(),  xmid(), zmid());
+	*nl.GetPoolNode(GetChildIndex(NODE_IDX_TR)) = QTNode(this, GetChildID(NODE_IDX_TR), GetChildIndex(NODE_IDX_TR),  xmid(), zmin(),  xmax(), zmid());
+	*nl.GetPoolNode(GetChildIndex(NODE_IDX_BR)) = QTNode(this, GetChildID(NODE_IDX_BR), GetChildIndex(NODE_IDX_BR),  xmid(), zmid(),  xmax(), zmax());
+	*nl.GetPoolNode(GetChildIndex(NODE_IDX_BL)) = QTNode(this, GetChildID(NODE_IDX_BL), GetChildIndex(NODE_IDX_BL),  xmin(), zmid(),  xmid(), zmax());
 
 	nl.SetNumLeafNodes(nl.GetNumLeafNodes() + (4 - 1));
 	assert(!IsLeaf());
@@ -361,12 +349,8 @@ bool QTPFS::QTNode::Merge(NodeLayer& nl) {
 		return false;
 	}
 
-	neighbors.clear();
-
 	// get rid of our children completely, but not of <this>!
-	for (unsigned int i = 0; i < children.size(); i++) {
-		children[i]->Delete(); children[i] = NULL;
-	}
+	Delete(nl);
 
 	nl.SetNumLeafNodes(nl.GetNumLeafNodes() - (4 - 1));
 	assert(IsLeaf());
@@ -390,10 +374,12 @@ bool QTPFS::QTNode::Merge(NodeLayer& nl) {
 		bool cont = false;
 
 		if (!IsLeaf()) {
-			for (unsigned int i = 0; i < children.size(); i++) {
-				if ((cont |= (children[i]->GetRectangleRelation(r) == REL_RECT_INTERIOR_NODE))) {
+			for (unsigned int i = 0; i < QTNODE_CHILD_COUNT; i++) {
+				QTNode* cn = nl.GetPoolNode(GetChildIndex(i));
+
+				if ((cont |= (cn->GetRectangleRelation(r) == REL_RECT_INTERIOR_NODE))) {
 					// only need to descend down one branch
-					children[i]->PreTesselate(nl, r, ur);
+					cn->PreTesselate(nl, r, ur);
 					break;
 				}
 			}
@@ -447,8 +433,8 @@ bool QTPFS::QTNode::Merge(NodeLayer& nl) {
 			return;
 		}
 
-		for (unsigned int i = 0; i < children.size(); i++) {
-			children[i]->PreTesselate(nl, cr, ur);
+		for (unsigned int i = 0; i < QTNODE_CHILD_COUNT; i++) {
+			nl.GetPoolNode(GetChildIndex(i))->PreTesselate(nl, cr, ur);
 		}
 	}
 
@@ -494,8 +480,8 @@ void QTPFS::QTNode::Tesselate(NodeLayer& nl, const SRectangle& r) {
 	if ((wantSplit && Split(nl, false)) || (needSplit && Split(nl, true))) {
 		registerNode = false;
 
-		for (unsigned int i = 0; i < children.size(); i++) {
-			QTNode* cn = children[i];
+		for (unsigned int i = 0; i < QTNODE_CHILD_COUNT; i++) {
+			QTNode* cn = nl.GetPoolNode(GetChildIndex(i));
 			SRectangle cr = cn->ClipRectangle(r);
 
 			cn->Tesselate(nl, cr);
@@ -681,38 +667,26 @@ void QTPFS::QTNode::Serialize(std::fstream& fStream, NodeLayer& nodeLayer, unsig
 	}
 
 	for (unsigned int i = 0; i < numChildren; i++) {
-		children[i]->Serialize(fStream, nodeLayer, streamSize, readMode);
+		nodeLayer.GetPoolNode(GetChildIndex(i))->Serialize(fStream, nodeLayer, streamSize, readMode);
 	}
 }
 
-unsigned int QTPFS::QTNode::GetNeighbors(const std::vector<INode*>& nodes, std::vector<INode*>& ngbs) {
-	#ifdef QTPFS_CONSERVATIVE_NEIGHBOR_CACHE_UPDATES
-	UpdateNeighborCache(nodes);
-	#endif
-
-	if (!neighbors.empty()) {
-		ngbs.clear();
-		ngbs.resize(neighbors.size());
+void QTPFS::QTNode::AddNeighbor(NodeLayer& nl, const INode* ngb) {
+	float3 ngbNetPoints[QTPFS_MAX_NETPOINTS_PER_NODE_EDGE];
 
-		std::copy(neighbors.begin(), neighbors.end(), ngbs.begin());
+	// NOTE: caching ETP's breaks QTPFS_ORTHOPROJECTED_EDGE_TRANSITIONS
+	for (unsigned int i = 0; i < QTPFS_MAX_NETPOINTS_PER_NODE_EDGE; i++) {
+		ngbNetPoints[i] = INode::GetNeighborEdgeTransitionPoint(ngb, float3(), QTPFS_NETPOINT_EDGE_SPACING_SCALE * (i + 1));
 	}
 
-	return (neighbors.size());
-}
-
-const std::vector<QTPFS::INode*>& QTPFS::QTNode::GetNeighbors(const std::vector<INode*>& nodes) {
-	#ifdef QTPFS_CONSERVATIVE_NEIGHBOR_CACHE_UPDATES
-	UpdateNeighborCache(nodes);
-	#endif
-	return neighbors;
+	nl.AddNodeNeighbor(this, ngb, ngbNetPoints);
 }
 
-// this is *either* called from ::GetNeighbors when the conservative
+// this is *either* called from PathSearch::IterateNodes when the conservative
 // update-scheme is enabled, *or* from PM::ExecQueuedNodeLayerUpdates
 // (never both)
-bool QTPFS::QTNode::UpdateNeighborCache(const std::vector<INode*>& nodes) {
+bool QTPFS::QTNode::UpdateNeighborCache(NodeLayer& nl) {
 	assert(IsLeaf());
-	assert(!nodes.empty());
 
 	if (prevMagicNum != currMagicNum) {
 		prevMagicNum = currMagicNum;
@@ -722,30 +696,20 @@ bool QTPFS::QTNode::UpdateNeighborCache(const std::vector<INode*>& nodes) {
 
 		// regenerate our neighbor cache
 		if (maxNgbs > 0) {
-			neighbors.clear();
-			neighbors.reserve(maxNgbs + 4);
+			// the previous range becomes stale, a new one is appended
+			nl.BeginNodeNeighbors(this);
 
-			netpoints.clear();
-			netpoints.reserve(1 + maxNgbs * QTPFS_MAX_NETPOINTS_PER_NODE_EDGE + 4);
-			// NOTE: caching ETP's breaks QTPFS_ORTHOPROJECTED_EDGE_TRANSITIONS
-			// NOTE: [0] is a reserved index and must always be valid
-			netpoints.push_back(float3());
-
-			INode* ngb = NULL;
+			const INode* ngb = NULL;
 
 			if (xmin() > 0) {
 				const unsigned int hmx = xmin() - 1;
 
 				// walk along EDGE_L (west) neighbors
 				for (unsigned int hmz = zmin(); hmz < zmax(); ) {
-					ngb = nodes[hmz * gs->mapx + hmx];
+					ngb = nl.GetNode(hmx, hmz);
 					hmz = ngb->zmax();
 
-					neighbors.push_back(ngb);
-
-					for (unsigned int i = 0; i < QTPFS_MAX_NETPOINTS_PER_NODE_EDGE; i++) {
-						netpoints.push_back(INode::GetNeighborEdgeTransitionPoint(ngb, float3(), QTPFS_NETPOINT_EDGE_SPACING_SCALE * (i + 1)));
-					}
+					AddNeighbor(nl, ngb);
 				}
 
 				ngbRels |= REL_NGB_EDGE_L;
@@ -755,14 +719,10 @@ bool QTPFS::QTNode::UpdateNeighborCache(const std::vector<INode*>& nodes) {
 
 				// walk along EDGE_R (east) neighbors
 				for (unsigned int hmz = zmin(); hmz < zmax(); ) {
-					ngb = nodes[hmz * gs->mapx + hmx];
+					ngb = nl.GetNode(hmx, hmz);
 					hmz = ngb->zmax();
 
-					neighbors.push_back(ngb);
-
-					for (unsigned int i = 0; i < QTPFS_MAX_NETPOINTS_PER_NODE_EDGE; i++) {
-						netpoints.push_back(INode::GetNeighborEdgeTransitionPoint(ngb, float3(), QTPFS_NETPOINT_EDGE_SPACING_SCALE * (i + 1)));
-					}
+					AddNeighbor(nl, ngb);
 				}
 
 				ngbRels |= REL_NGB_EDGE_R;
@@ -773,14 +733,10 @@ bool QTPFS::QTNode::UpdateNeighborCache(const std::vector<INode*>& nodes) {
 
 				// walk along EDGE_T (north) neighbors
 				for (unsigned int hmx = xmin(); hmx < xmax(); ) {
-					ngb = nodes[hmz * gs->mapx + hmx];
+					ngb = nl.GetNode(hmx, hmz);
 					hmx = ngb->xmax();
 
-					neighbors.push_back(ngb);
-
-					for (unsigned int i = 0; i < QTPFS_MAX_NETPOINTS_PER_NODE_EDGE; i++) {
-						netpoints.push_back(INode::GetNeighborEdgeTransitionPoint(ngb, float3(), QTPFS_NETPOINT_EDGE_SPACING_SCALE * (i + 1)));
-					}
+					AddNeighbor(nl, ngb);
 				}
 
 				ngbRels |= REL_NGB_EDGE_T;
@@ -790,14 +746,10 @@ bool QTPFS::QTNode::UpdateNeighborCache(const std::vector<INode*>& nodes) {
 
 				// walk along EDGE_B (south) neighbors
 				for (unsigned int hmx = xmin(); hmx < xmax(); ) {
-					ngb = nodes[hmz * gs->mapx + hmx];
+					ngb = nl.GetNode(hmx, hmz);
 					hmx = ngb->xmax();
 
-					neighbors.push_back(ngb);
-
-					for (unsigned int i = 0; i < QTPFS_MAX_NETPOINTS_PER_NODE_EDGE; i++) {
-						netpoints.push_back(INode::GetNeighborEdgeTransitionPoint(ngb, float3(), QTPFS_NETPOINT_EDGE_SPACING_SCALE * (i + 1)));
-					}
+					AddNeighbor(nl, ngb);
 				}
 
 				ngbRels |= REL_NGB_EDGE_B;
@@ -807,34 +759,26 @@ bool QTPFS::QTNode::UpdateNeighborCache(const std::vector<INode*>& nodes) {
 			// top- and bottom-left corners
 			if ((ngbRels & REL_NGB_EDGE_L) != 0) {
 				if ((ngbRels & REL_NGB_EDGE_T) != 0) {
-					const INode* ngbL = nodes[(zmin() + 0) * gs->mapx + (xmin() - 1)];
-					const INode* ngbT = nodes[(zmin() - 1) * gs->mapx + (xmin() + 0)];
-						  INode* ngbC = nodes[(zmin() - 1) * gs->mapx + (xmin() - 1)];
+					const INode* ngbL = nl.GetNode(xmin() - 1, zmin() + 0);
+					const INode* ngbT = nl.GetNode(xmin() + 0, zmin() - 1);
+					const INode* ngbC = nl.GetNode(xmin() - 1, zmin() - 1);
 
 					// VERT_TL ngb must be distinct from EDGE_L and EDGE_T ngbs
 					if (ngbC != ngbL && ngbC != ngbT) {
 						if (ngbL->AllSquaresAccessible() && ngbT->AllSquaresAccessible()) {
-							neighbors.push_back(ngbC);
-
-							for (unsigned int i = 0; i < QTPFS_MAX_NETPOINTS_PER_NODE_EDGE; i++) {
-								netpoints.push_back(INode::GetNeighborEdgeTransitionPoint(ngbC, float3(), QTPFS_NETPOINT_EDGE_SPACING_SCALE * (i + 1)));
-							}
+							AddNeighbor(nl, ngbC);
 						}
 					}
 				}
 				if ((ngbRels & REL_NGB_EDGE_B) != 0) {
-					const INode* ngbL = nodes[(zmax() - 1) * gs->mapx + (xmin() - 1)];
-					const INode* ngbB = nodes[(zmax() + 0) * gs->mapx + (xmin() + 0)];
-						  INode* ngbC = nodes[(zmax() + 0) * gs->mapx + (xmin() - 1)];
+					const INode* ngbL = nl.GetNode(xmin() - 1, zmax() - 1);
+					const INode* ngbB = nl.GetNode(xmin() + 0, zmax() + 0);
+					const INode* ngbC = nl.GetNode(xmin() - 1, zmax() + 0);
 
 					// VERT_BL ngb must be distinct from EDGE_L and EDGE_B ngbs
 					if (ngbC != ngbL && ngbC != ngbB) {
 						if (ngbL->AllSquaresAccessible() && ngbB->AllSquaresAccessible()) {
-							neighbors.push_back(ngbC);
-
-							for (unsigned int i = 0; i < QTPFS_MAX_NETPOINTS_PER_NODE_EDGE; i++) {
-								netpoints.push_back(INode::GetNeighborEdgeTransitionPoint(ngbC, float3(), QTPFS_NETPOINT_EDGE_SPACING_SCALE * (i + 1)));
-							}
+							AddNeighbor(nl, ngbC);
 						}
 					}
 				}
@@ -843,45 +787,32 @@ bool QTPFS::QTNode::UpdateNeighborCache(const std::vector<INode*>& nodes) {
 			// top- and bottom-right corners
 			if ((ngbRels & REL_NGB_EDGE_R) != 0) {
 				if ((ngbRels & REL_NGB_EDGE_T) != 0) {
-					const INode* ngbR = nodes[(zmin() + 0) * gs->mapx + (xmax() + 0)];
-					const INode* ngbT = nodes[(zmin() - 1) * gs->mapx + (xmax() - 1)];
-						  INode* ngbC = nodes[(zmin() - 1) * gs->mapx + (xmax() + 0)];
+					const INode* ngbR = nl.GetNode(xmax() + 0, zmin() + 0);
+					const INode* ngbT = nl.GetNode(xmax() - 1, zmin() - 1);
+					const INode* ngbC = nl.GetNode(xmax() + 0, zmin() - 1);
 
 					// VERT_TR ngb must be distinct from EDGE_R and EDGE_T ngbs
 					if (ngbC != ngbR && ngbC != ngbT) {
 						if (ngbR->AllSquaresAccessible() && ngbT->AllSquaresAccessible()) {
-							neighbors.push_back(ngbC);
-
-							for (unsigned int i = 0; i < QTPFS_MAX_NETPOINTS_PER_NODE_EDGE; i++) {
-								netpoints.push_back(INode::GetNeighborEdgeTransitionPoint(ngbC, float3(), QTPFS_NETPOINT_EDGE_SPACING_SCALE * (i + 1)));
-							}
+							AddNeighbor(nl, ngbC);
 						}
 					}
 				}
 				if ((ngbRels & REL_NGB_EDGE_B) != 0) {
-					const INode* ngbR = nodes[(zmax() - 1) * gs->mapx + (xmax() + 0)];
-					const INode* ngbB = nodes[(zmax() + 0) * gs->mapx + (xmax() - 1)];
-						  INode* ngbC = nodes[(zmax() + 0) * gs->mapx + (xmax() + 0)];
+					const INode* ngbR = nl.GetNode(xmax() + 0, zmax() - 1);
+					const INode* ngbB = nl.GetNode(xmax() - 1, zmax() + 0);
+					const INode* ngbC = nl.GetNode(xmax() + 0, zmax() + 0);
 
 					// VERT_BR ngb must be distinct from EDGE_R and EDGE_B ngbs
 					if (ngbC != ngbR && ngbC != ngbB) {
 						if (ngbR->AllSquaresAccessible() && ngbB->AllSquaresAccessible()) {
-							neighbors.push_back(ngbC);
-
-							for (unsigned int i = 0; i < QTPFS_MAX_NETPOINTS_PER_NODE_EDGE; i++) {
-								netpoints.push_back(INode::GetNeighborEdgeTransitionPoint(ngbC, float3(), QTPFS_NETPOINT_EDGE_SPACING_SCALE * (i + 1)));
-							}
+							AddNeighbor(nl, ngbC);
 						}
 					}
 				}
 			}
 			#endif
 
-			// NOTE: gcc 4.7 should FINALLY define __cplusplus properly (and accept -std=c++11)
-			#if (__cplusplus >= 201103L)
-			// neighbors.shrink_to_fit();
-			// netpoints.shrink_to_fit();
-			#endif
 		}
 
 		return true;
@@ -3,7 +3,6 @@
 #ifndef QTPFS_NODE_HDR
 #define QTPFS_NODE_HDR
 
-#include <vector>
 #include <fstream>
 #include <boost/cstdint.hpp>
 
@@ -13,9 +12,8 @@
 #include "System/float3.h"
 #include "System/Rectangle.h"
 
-#ifndef QTPFS_VIRTUAL_NODE_FUNCTIONS
+// single concrete node type, no virtual dispatch on the search path
 #define QTNode INode
-#endif
 
 namespace QTPFS {
 	struct NodeLayer;
@@ -33,46 +31,12 @@ namespace QTPFS {
 		bool operator <= (const INode* n) const { return (fCost <= n->fCost); }
 		bool operator >= (const INode* n) const { return (fCost >= n->fCost); }
 
-		#ifdef QTPFS_VIRTUAL_NODE_FUNCTIONS
-		virtual void Serialize(std::fstream&, NodeLayer&, unsigned int*, bool) = 0;
-		virtual unsigned int GetNeighbors(const std::vector<INode*>&, std::vector<INode*>&) = 0;
-		virtual const std::vector<INode*>& GetNeighbors(const std::vector<INode*>& v) = 0;
-		virtual bool UpdateNeighborCache(const std::vector<INode*>& nodes) = 0;
-
-		virtual void SetNeighborEdgeTransitionPoint(unsigned int ngbIdx, const float3& point) = 0;
-		virtual const float3& GetNeighborEdgeTransitionPoint(unsigned int ngbIdx) const = 0;
-		#endif
-
 		unsigned int GetNeighborRelation(const INode* ngb) const;
 		unsigned int GetRectangleRelation(const SRectangle& r) const;
 		float GetDistance(const INode* n, unsigned int type) const;
 		float3 GetNeighborEdgeTransitionPoint(const INode* ngb, const float3& pos, float alpha) const;
 		SRectangle ClipRectangle(const SRectangle& r) const;
 
-		#ifdef QTPFS_VIRTUAL_NODE_FUNCTIONS
-		virtual unsigned int xmin() const = 0;
-		virtual unsigned int zmin() const = 0;
-		virtual unsigned int xmax() const = 0;
-		virtual unsigned int zmax() const = 0;
-		virtual unsigned int xmid() const = 0;
-		virtual unsigned int zmid() const = 0;
-		virtual unsigned int xsize() const = 0;
-		virtual unsigned int zsize() const = 0;
-		virtual unsigned int area() const = 0;
-
-		virtual bool AllSquaresAccessible() const = 0;
-		virtual bool AllSquaresImpassable() const = 0;
-
-		virtual void SetMoveCost(float cost) = 0;
-		virtual float GetMoveCost() const = 0;
-
-		virtual void SetSearchState(unsigned int) = 0;
-		virtual unsigned int GetSearchState() const = 0;
-
-		virtual void SetMagicNumber(unsigned int) = 0;
-		virtual unsigned int GetMagicNumber() const = 0;
-		#endif
-
 		void SetPathCosts(float g, float h) { fCost = g + h; gCost = g; hCost = h; }
 		void SetPathCost(unsigned int type, float cost);
 		const float* GetPathCosts() const { return &fCost; }
@@ -95,23 +59,18 @@ namespace QTPFS {
 		// points back to previous node in path
 		INode* prevNode;
 
-	#ifdef QTPFS_VIRTUAL_NODE_FUNCTIONS
-	};
-	#endif
-
-
-
-	#ifdef QTPFS_VIRTUAL_NODE_FUNCTIONS
-	struct QTNode: public INode {
-	#endif
 	public:
+		// NOTE:
+		//   nodes live in their NodeLayer's pool, and are referred to by
+		//   pool index everywhere except in search-state (see NodeLayer)
+		QTNode();
 		QTNode(
 			const QTNode* parent,
 			unsigned int nn,
+			unsigned int pi,
 			unsigned int x1, unsigned int z1,
 			unsigned int x2, unsigned int z2
 		);
-		~QTNode();
 
 		static void InitStatic();
 
@@ -121,27 +80,35 @@ namespace QTPFS {
 		unsigned int GetChildID(unsigned int i) const { return (nodeNumber << 2) + (i + 1); }
 		unsigned int GetParentID() const { return ((nodeNumber - 1) >> 2); }
 
-		boost::uint64_t GetMemFootPrint() const;
-		boost::uint64_t GetCheckSum() const;
+		// the four children of a node occupy consecutive pool slots
+		unsigned int GetPoolIndex() const { return poolIndex; }
+		unsigned int GetChildIndex(unsigned int i) const { return (childBaseIndex + i); }
 
-		void Delete();
+		boost::uint64_t GetCheckSum(const NodeLayer& nl) const;
+
+		void Delete(NodeLayer& nl);
 		void PreTesselate(NodeLayer& nl, const SRectangle& r, SRectangle& ur);
 		void Tesselate(NodeLayer& nl, const SRectangle& r);
 		void Serialize(std::fstream& fStream, NodeLayer& nodeLayer, unsigned int* streamSize, bool readMode);
 
-		bool IsLeaf() const;
+		bool IsLeaf() const { return (childBaseIndex == -1u); }
 		bool CanSplit(bool forced) const;
 
 		bool Split(NodeLayer& nl, bool forced);
 		bool Merge(NodeLayer& nl);
 
 		unsigned int GetMaxNumNeighbors() const;
-		unsigned int GetNeighbors(const std::vector<INode*>&, std::vector<INode*>&);
-		const std::vector<INode*>& GetNeighbors(const std::vector<INode*>&);
-		bool UpdateNeighborCache(const std::vector<INode*>& nodes);
+		bool UpdateNeighborCache(NodeLayer& nl);
+
+		// neighbors (and their edge transition-points, QTPFS_MAX_NETPOINTS_PER_NODE_EDGE
+		// per neighbor) are stored as a range of the NodeLayer's neighbor arrays
+		void SetNeighborRange(unsigned int offset, unsigned int count) { ngbsOffset = offset; numNgbs = count; }
+		unsigned int GetNeighborsOffset() const { return ngbsOffset; }
+		unsigned int GetNumNeighbors() const { return numNgbs; }
 
-		void SetNeighborEdgeTransitionPoint(unsigned int ngbIdx, const float3& point) { netpoints[ngbIdx] = point; }
-		const float3& GetNeighborEdgeTransitionPoint(unsigned int ngbIdx) const { return netpoints[ngbIdx]; }
+		// the transition-point through which the current search entered this node
+		void SetEntryPoint(const float3& point) { entryPoint = point; }
+		const float3& GetEntryPoint() const { return entryPoint; }
 
 		unsigned int xmin() const { return (_xminxmax  & 0xFFFF); }
 		unsigned int zmin() const { return (_zminzmax  & 0xFFFF); }
@@ -181,6 +148,8 @@ namespace QTPFS {
 			bool& needSplit
 		);
 
+		void AddNeighbor(NodeLayer& nl, const INode* ngb);
+
 		static unsigned int MIN_SIZE_X;
 		static unsigned int MIN_SIZE_Z;
 		static unsigned int MAX_DEPTH;
@@ -197,15 +166,20 @@ namespace QTPFS {
 		unsigned int currMagicNum;
 		unsigned int prevMagicNum;
 
-		std::vector<QTNode*> children;
-		std::vector<INode*> neighbors;
+		// NOTE:
+		//   members below are not part of the checksum, pool
+		//   indices depend on the order of (de-)allocations
+		unsigned int poolIndex;
+		unsigned int childBaseIndex; // -1u for leafs
+
+		unsigned int ngbsOffset;
+		unsigned int numNgbs;
 
 		// NOTE:
-		//   these should be float2's, but profiling shows float3's to be *faster* and
+		//   this should be a float2, but profiling shows float3's to be *faster* and
 		//   float3's are also more convenient to work with (so we take the memory hit)
-		std::vector<float3> netpoints;
+		float3 entryPoint;
 	};
 }
 
 #endif
-
@@ -21,6 +21,8 @@ float        QTPFS::NodeLayer::MAX_SPEEDMOD_VALUE;
 QTPFS::NodeLayer::NodeLayer()
 	: layerNumber(0)
 	, numLeafNodes(0)
+	, numPoolNodes(0)
+	, numStaleNeighbors(0)
 	, updateCounter(0)
 	, xsize(0)
 	, zsize(0)
@@ -38,11 +40,126 @@ void QTPFS::NodeLayer::InitStatic() {
 void QTPFS::NodeLayer::RegisterNode(INode* n) {
 	for (unsigned int hmz = n->zmin(); hmz < n->zmax(); hmz++) {
 		for (unsigned int hmx = n->xmin(); hmx < n->xmax(); hmx++) {
-			nodeGrid[hmz * xsize + hmx] = n;
+			nodeGrid[hmz * xsize + hmx] = n->GetPoolIndex();
 		}
 	}
 }
 
+
+
+QTPFS::INode* QTPFS::NodeLayer::AllocRootNode(const SRectangle& r) {
+	assert(numPoolNodes == 0);
+
+	const unsigned int rootIndex = AllocNodeGroup();
+	INode* rootNode = GetPoolNode(rootIndex);
+
+	*rootNode = INode(NULL, 0, rootIndex, r.x1, r.z1, r.x2, r.z2);
+	return rootNode;
+}
+
+unsigned int QTPFS::NodeLayer::AllocNodeGroup() {
+	if (!freeNodeGroups.empty()) {
+		const unsigned int baseIndex = freeNodeGroups.back();
+		freeNodeGroups.pop_back();
+		return baseIndex;
+	}
+
+	// groups are 4-aligned, so never straddle two blocks
+	if (numPoolNodes == (nodePoolBlocks.size() * NODE_POOL_BLOCK_SIZE)) {
+		nodePoolBlocks.push_back(new INode[NODE_POOL_BLOCK_SIZE]);
+	}
+
+	const unsigned int baseIndex = numPoolNodes;
+	numPoolNodes += 4;
+	return baseIndex;
+}
+
+void QTPFS::NodeLayer::FreeNodeGroup(unsigned int baseIndex) {
+	assert((baseIndex & 3) == 0);
+	assert(baseIndex < numPoolNodes);
+
+	for (unsigned int i = 0; i < 4; i++) {
+		assert(GetPoolNode(baseIndex + i)->GetNumNeighbors() == 0);
+		assert(GetPoolNode(baseIndex + i)->IsLeaf());
+	}
+
+	freeNodeGroups.push_back(baseIndex);
+}
+
+
+
+void QTPFS::NodeLayer::BeginNodeNeighbors(INode* n) {
+	FreeNodeNeighbors(n);
+	n->SetNeighborRange(nodeNeighbors.size(), 0);
+}
+
+void QTPFS::NodeLayer::AddNodeNeighbor(INode* n, const INode* ngb, const float3* ngbNetPoints) {
+	// only the most recently begun range can grow
+	assert((n->GetNeighborsOffset() + n->GetNumNeighbors()) == nodeNeighbors.size());
+
+	nodeNeighbors.push_back(ngb->GetPoolIndex());
+	nodeNetPoints.insert(nodeNetPoints.end(), ngbNetPoints, ngbNetPoints + QTPFS_MAX_NETPOINTS_PER_NODE_EDGE);
+
+	n->SetNeighborRange(n->GetNeighborsOffset(), n->GetNumNeighbors() + 1);
+}
+
+void QTPFS::NodeLayer::FreeNodeNeighbors(INode* n) {
+	numStaleNeighbors += n->GetNumNeighbors();
+	n->SetNeighborRange(0, 0);
+}
+
+// neighbor ranges are only ever appended, so reclaim the space
+// of stale ones once these make up half of the neighbor arrays
+void QTPFS::NodeLayer::CompactNodeNeighbors() {
+	if ((numStaleNeighbors * 2) <= nodeNeighbors.size())
+		return;
+
+	std::vector<unsigned int> newNeighbors;
+	std::vector<float3> newNetPoints;
+
+	newNeighbors.reserve(nodeNeighbors.size() - numStaleNeighbors);
+	newNetPoints.reserve(newNeighbors.capacity() * QTPFS_MAX_NETPOINTS_PER_NODE_EDGE);
+
+	// walk the pool in order, internal and unused nodes have no neighbors
+	for (unsigned int i = 0; i < numPoolNodes; i++) {
+		INode* n = GetPoolNode(i);
+
+		const unsigned int numNgbs = n->GetNumNeighbors();
+
+		if (numNgbs == 0)
+			continue;
+
+		const unsigned int* ngbs = GetNodeNeighbors(n);
+		const float3* netPoints = GetNodeNetPoints(n);
+
+		n->SetNeighborRange(newNeighbors.size(), numNgbs);
+
+		newNeighbors.insert(newNeighbors.end(), ngbs, ngbs + numNgbs);
+		newNetPoints.insert(newNetPoints.end(), netPoints, netPoints + numNgbs * QTPFS_MAX_NETPOINTS_PER_NODE_EDGE);
+	}
+
+	nodeNeighbors.swap(newNeighbors);
+	nodeNetPoints.swap(newNetPoints);
+
+	numStaleNeighbors = 0;
+}
+
+
+
+boost::uint64_t QTPFS::NodeLayer::GetMemFootPrint() const {
+	boost::uint64_t memFootPrint = sizeof(NodeLayer);
+	memFootPrint += (curSpeedMods.size() * sizeof(SpeedModType));
+	memFootPrint += (oldSpeedMods.size() * sizeof(SpeedModType));
+	memFootPrint += (curSpeedBins.size() * sizeof(SpeedBinType));
+	memFootPrint += (oldSpeedBins.size() * sizeof(SpeedBinType));
+	memFootPrint += (nodeGrid.size() * sizeof(unsigned int));
+	memFootPrint += (nodePoolBlocks.size() * NODE_POOL_BLOCK_SIZE * sizeof(INode));
+	memFootPrint += (freeNodeGroups.capacity() * sizeof(unsigned int));
+	memFootPrint += (nodeNeighbors.capacity() * sizeof(unsigned int));
+	memFootPrint += (nodeNetPoints.capacity() * sizeof(float3));
+	return memFootPrint;
+}
+
 void QTPFS::NodeLayer::Init(unsigned int layerNum) {
 	assert((QTPFS::NodeLayer::NUM_SPEEDMOD_BINS + 1) <= MaxSpeedBinTypeValue());
 
@@ -53,7 +170,7 @@ void QTPFS::NodeLayer::Init(unsigned int layerNum) {
 	xsize = gs->mapx;
 	zsize = gs->mapy;
 
-	nodeGrid.resize(xsize * zsize, NULL);
+	nodeGrid.resize(xsize * zsize, -1u);
 
 	curSpeedMods.resize(xsize * zsize,  0);
 	oldSpeedMods.resize(xsize * zsize,  0);
@@ -64,6 +181,18 @@ void QTPFS::NodeLayer::Init(unsigned int layerNum) {
 void QTPFS::NodeLayer::Clear() {
 	nodeGrid.clear();
 
+	for (unsigned int i = 0; i < nodePoolBlocks.size(); i++) {
+		delete[] nodePoolBlocks[i];
+	}
+
+	nodePoolBlocks.clear();
+	freeNodeGroups.clear();
+	nodeNeighbors.clear();
+	nodeNetPoints.clear();
+
+	numPoolNodes = 0;
+	numStaleNeighbors = 0;
+
 	curSpeedMods.clear();
 	oldSpeedMods.clear();
 	oldSpeedBins.clear();
@@ -249,19 +378,19 @@ void QTPFS::NodeLayer::ExecNodeNeighborCacheUpdate(unsigned int currFrameNum, un
 		// top-left quadrant: [0, gs->mapx >> 1) x [0, gs->mapy >> 1)
 		//
 		// update an 8x8 block of squares per quadrant per frame
-		// in row-major order; every GetNeighbors() call invokes
-		// UpdateNeighborCache if the magic numbers do not match
-		// (nodes can be visited multiple times per block update)
+		// in row-major order; UpdateNeighborCache is a no-op if
+		// the magic numbers already match (nodes can be visited
+		// multiple times per block update)
 		const int xmin =         (xoff +           0               ), zmin =         (zoff +           0               );
 		const int xmax = std::min(xmin + SQUARE_SIZE, gs->mapx >> 1), zmax = std::min(zmin + SQUARE_SIZE, gs->mapy >> 1);
 
 		for (int z = zmin; z < zmax; z++) {
 			for (int x = xmin; x < xmax; ) {
-				n = nodeGrid[z * xsize + x];
+				n = GetNode(x, z);
 				x = n->xmax();
 
 				n->SetMagicNumber(currMagicNum);
-				n->GetNeighbors(nodeGrid);
+				n->UpdateNeighborCache(*this);
 			}
 		}
 	}
@@ -272,11 +401,11 @@ void QTPFS::NodeLayer::ExecNodeNeighborCacheUpdate(unsigned int currFrameNum, un
 
 		for (int z = zmin; z < zmax; z++) {
 			for (int x = xmin; x < xmax; ) {
-				n = nodeGrid[z * xsize + x];
+				n = GetNode(x, z);
 				x = n->xmax();
 
 				n->SetMagicNumber(currMagicNum);
-				n->GetNeighbors(nodeGrid);
+				n->UpdateNeighborCache(*this);
 			}
 		}
 	}
@@ -287,11 +416,11 @@ void QTPFS::NodeLayer::ExecNodeNeighborCacheUpdate(unsigned int currFrameNum, un
 
 		for (int z = zmin; z < zmax; z++) {
 			for (int x = xmin; x < xmax; ) {
-				n = nodeGrid[z * xsize + x];
+				n = GetNode(x, z);
 				x = n->xmax();
 
 				n->SetMagicNumber(currMagicNum);
-				n->GetNeighbors(nodeGrid);
+				n->UpdateNeighborCache(*this);
 			}
 		}
 	}
@@ -302,14 +431,16 @@ void QTPFS::NodeLayer::ExecNodeNeighborCacheUpdate(unsigned int currFrameNum, un
 
 		for (int z = zmin; z < zmax; z++) {
 			for (int x = xmin; x < xmax; ) {
-				n = nodeGrid[z * xsize + x];
+				n = GetNode(x, z);
 				x = n->xmax();
 
 				n->SetMagicNumber(currMagicNum);
-				n->GetNeighbors(nodeGrid);
+				n->UpdateNeighborCache(*this);
 			}
 		}
 	}
+
+	CompactNodeNeighbors();
 }
 #endif
 #endif
@@ -326,16 +457,18 @@ void QTPFS::NodeLayer::ExecNodeNeighborCacheUpdates(const SRectangle& ur, unsign
 
 	for (int z = zmin; z < zmax; z++) {
 		for (int x = xmin; x < xmax; ) {
-			n = nodeGrid[z * xsize + x];
+			n = GetNode(x, z);
 			x = n->xmax();
 
 			// NOTE:
 			//   during initialization, currMagicNum == 0 which nodes start with already 
 			//   (does not matter because prevMagicNum == -1, so updates are not no-ops)
 			n->SetMagicNumber(currMagicNum);
-			n->UpdateNeighborCache(nodeGrid);
+			n->UpdateNeighborCache(*this);
 		}
 	}
+
+	CompactNodeNeighbors();
 }
 
 
@@ -8,14 +8,14 @@
 #include <list> // for QTPFS_STAGGERED_LAYER_UPDATES
 #include <boost/cstdint.hpp>
 
+#include "System/float3.h"
 #include "System/Rectangle.h"
 #include "PathDefines.hpp"
+#include "Node.hpp"
 
 struct MoveDef;
 
 namespace QTPFS {
-	struct INode;
-
 	#ifdef QTPFS_STAGGERED_LAYER_UPDATES
 	struct LayerUpdate {
 		SRectangle rectangle;
@@ -61,17 +61,37 @@ namespace QTPFS {
 		void ExecNodeNeighborCacheUpdates(const SRectangle& ur, unsigned int currMagicNum);
 
 		float GetNodeRatio() const { return (numLeafNodes / std::max(1.0f, float(xsize * zsize))); }
-		const INode* GetNode(unsigned int x, unsigned int z) const { return nodeGrid[z * xsize + x]; }
-		      INode* GetNode(unsigned int x, unsigned int z)       { return nodeGrid[z * xsize + x]; }
-		const INode* GetNode(unsigned int i) const { return nodeGrid[i]; }
-		      INode* GetNode(unsigned int i)       { return nodeGrid[i]; }
+		const INode* GetNode(unsigned int x, unsigned int z) const { return GetPoolNode(nodeGrid[z * xsize + x]); }
+		      INode* GetNode(unsigned int x, unsigned int z)       { return GetPoolNode(nodeGrid[z * xsize + x]); }
+		const INode* GetNode(unsigned int i) const { return GetPoolNode(nodeGrid[i]); }
+		      INode* GetNode(unsigned int i)       { return GetPoolNode(nodeGrid[i]); }
+
+		// node pool; nodes are allocated in groups of four siblings
+		// (the root occupies the first slot of group 0) and never
+		// move, so pointers to them stay valid until freed
+		const INode* GetPoolNode(unsigned int i) const { return &nodePoolBlocks[i >> NODE_POOL_BLOCK_SHIFT][i & NODE_POOL_BLOCK_MASK]; }
+		      INode* GetPoolNode(unsigned int i)       { return &nodePoolBlocks[i >> NODE_POOL_BLOCK_SHIFT][i & NODE_POOL_BLOCK_MASK]; }
+
+		INode* AllocRootNode(const SRectangle& r);
+		unsigned int AllocNodeGroup();
+		void FreeNodeGroup(unsigned int baseIndex);
+
+		// neighbor cache of all leaf-nodes, in CSR form: each node owns the
+		// range [offset, offset + count) of nodeNeighbors (pool indices) and
+		// the QTPFS_MAX_NETPOINTS_PER_NODE_EDGE times larger range of netPoints
+		const unsigned int* GetNodeNeighbors(const INode* n) const { return (nodeNeighbors.data() + n->GetNeighborsOffset()); }
+		const float3* GetNodeNetPoints(const INode* n) const { return (nodeNetPoints.data() + n->GetNeighborsOffset() * QTPFS_MAX_NETPOINTS_PER_NODE_EDGE); }
+
+		void BeginNodeNeighbors(INode* n);
+		void AddNodeNeighbor(INode* n, const INode* ngb, const float3* ngbNetPoints);
+		void FreeNodeNeighbors(INode* n);
+		void CompactNodeNeighbors();
 
 		const std::vector<SpeedBinType>& GetOldSpeedBins() const { return oldSpeedBins; }
 		const std::vector<SpeedBinType>& GetCurSpeedBins() const { return curSpeedBins; }
 		const std::vector<SpeedModType>& GetOldSpeedMods() const { return oldSpeedMods; }
 		const std::vector<SpeedModType>& GetCurSpeedMods() const { return curSpeedMods; }
 
-		std::vector<INode*>& GetNodes() { return nodeGrid; }
 		void RegisterNode(INode* n);
 
 		void SetNumLeafNodes(unsigned int n) { numLeafNodes = n; }
@@ -82,18 +102,21 @@ namespace QTPFS {
 
 		SpeedBinType GetSpeedModBin(float absSpeedMod, float relSpeedMod) const;
 
-		boost::uint64_t GetMemFootPrint() const {
-			boost::uint64_t memFootPrint = sizeof(NodeLayer);
-			memFootPrint += (curSpeedMods.size() * sizeof(SpeedModType));
-			memFootPrint += (oldSpeedMods.size() * sizeof(SpeedModType));
-			memFootPrint += (curSpeedBins.size() * sizeof(SpeedBinType));
-			memFootPrint += (oldSpeedBins.size() * sizeof(SpeedBinType));
-			memFootPrint += (nodeGrid.size() * sizeof(INode*));
-			return memFootPrint;
-		}
+		boost::uint64_t GetMemFootPrint() const;
 
 	private:
-		std::vector<INode*> nodeGrid;
+		static const unsigned int NODE_POOL_BLOCK_SHIFT = 12;
+		static const unsigned int NODE_POOL_BLOCK_SIZE = 1 << NODE_POOL_BLOCK_SHIFT;
+		static const unsigned int NODE_POOL_BLOCK_MASK = NODE_POOL_BLOCK_SIZE - 1;
+
+		// pool index of the leaf covering each square
+		std::vector<unsigned int> nodeGrid;
+
+		std::vector<INode*> nodePoolBlocks;
+		std::vector<unsigned int> freeNodeGroups;
+
+		std::vector<unsigned int> nodeNeighbors;
+		std::vector<float3> nodeNetPoints;
 
 		std::vector<SpeedModType> curSpeedMods;
 		std::vector<SpeedModType> oldSpeedMods;
@@ -114,6 +137,8 @@ namespace QTPFS {
 
 		unsigned int layerNumber;
 		unsigned int numLeafNodes;
+		unsigned int numPoolNodes;
+		unsigned int numStaleNeighbors;
 		unsigned int updateCounter;
 
 		unsigned int xsize;
@@ -16,7 +16,6 @@
 // #define QTPFS_ORTHOPROJECTED_EDGE_TRANSITIONS
 #define QTPFS_STAGGERED_LAYER_UPDATES
 //
-// #define QTPFS_VIRTUAL_NODE_FUNCTIONS
 // #define QTPFS_ENABLE_THREADED_UPDATE
 // #define QTPFS_AMORTIZED_NODE_NEIGHBOR_CACHE_UPDATES
 #define QTPFS_ENABLE_MICRO_OPTIMIZATION_HACKS
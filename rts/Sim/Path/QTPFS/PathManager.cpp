@@ -104,7 +104,7 @@ QTPFS::PathManager::~PathManager() {
 	std::map<unsigned int, PathSearchTrace::Execution*>::const_iterator tracesIt;
 
 	for (unsigned int layerNum = 0; layerNum < nodeLayers.size(); layerNum++) {
-		nodeTrees[layerNum]->Delete();
+		// also frees the layer's node-tree
 		nodeLayers[layerNum].Clear();
 
 		for (searchesIt = pathSearches[layerNum].begin(); searchesIt != pathSearches[layerNum].end(); ++searchesIt) {
@@ -224,7 +224,7 @@ void QTPFS::PathManager::Load() {
 			}
 			#endif
 
-			pfsCheckSum ^= nodeTrees[layerNum]->GetCheckSum();
+			pfsCheckSum ^= nodeTrees[layerNum]->GetCheckSum(nodeLayers[layerNum]);
 			maxNumLeafNodes = std::max(nodeLayers[layerNum].GetNumLeafNodes(), maxNumLeafNodes);
 		}
 
@@ -248,7 +248,6 @@ boost::uint64_t QTPFS::PathManager::GetMemFootPrint() const {
 
 	for (unsigned int i = 0; i < nodeLayers.size(); i++) {
 		memFootPrint += nodeLayers[i].GetMemFootPrint();
-		memFootPrint += nodeTrees[i]->GetMemFootPrint();
 	}
 
 	// convert to megabytes
@@ -302,9 +301,8 @@ void QTPFS::PathManager::InitNodeLayersThreaded(const SRectangle& rect) {
 			InitNodeLayer(layerNum, rect);
 			UpdateNodeLayer(layerNum, rect);
 
-			const QTNode* tree = nodeTrees[layerNum];
 			const NodeLayer& layer = nodeLayers[layerNum];
-			const unsigned int mem = (tree->GetMemFootPrint() + layer.GetMemFootPrint()) / (1024 * 1024);
+			const unsigned int mem = layer.GetMemFootPrint() / (1024 * 1024);
 
 			#ifndef NDEBUG
 			sprintf(loadMsg, pstFmtStr, layerNum, mem, layer.GetNumLeafNodes(), layer.GetNodeRatio());
@@ -352,9 +350,8 @@ void QTPFS::PathManager::InitNodeLayersThread(
 		InitNodeLayer(layerNum, rect);
 		UpdateNodeLayer(layerNum, rect);
 
-		const QTNode* tree = nodeTrees[layerNum];
 		const NodeLayer& layer = nodeLayers[layerNum];
-		const unsigned int mem = (tree->GetMemFootPrint() + layer.GetMemFootPrint()) / (1024 * 1024);
+		const unsigned int mem = layer.GetMemFootPrint() / (1024 * 1024);
 
 		#ifndef NDEBUG
 		sprintf(loadMsg, pstFmtStr, layerNum, mem, layer.GetNumLeafNodes(), layer.GetNodeRatio());
@@ -364,7 +361,7 @@ void QTPFS::PathManager::InitNodeLayersThread(
 }
 
 void QTPFS::PathManager::InitNodeLayer(unsigned int layerNum, const SRectangle& r) {
-	nodeTrees[layerNum] = new QTPFS::QTNode(NULL,  0,  r.x1, r.z1,  r.x2, r.z2);
+	nodeTrees[layerNum] = nodeLayers[layerNum].AllocRootNode(r);
 
 	if (moveDefHandler->GetMoveDefByPathType(layerNum)->udRefCount == 0)
 		return;
@@ -696,6 +693,8 @@ void QTPFS::PathManager::ThreadUpdate() {
 		}
 	#endif
 
+		SCOPED_TRACE("QTPFS::PathManager::ThreadUpdate");
+
 		// NOTE:
 		//     for a mod with N move-types, any unit will be waiting
 		//     (N / LAYERS_PER_UPDATE) sim-frames before its request
@@ -146,8 +146,8 @@ namespace QTPFS {
 		void ResetState(INode* node);
 		void UpdateNode(INode* nextNode, INode* prevNode, unsigned int netPointIdx);
 
-		void IterateNodes(const std::vector<INode*>& allNodes);
-		void IterateNodeNeighbors(const std::vector<INode*>& nxtNodes);
+		void IterateNodes();
+		void IterateNodeNeighbors(const unsigned int* nxtNodeIndices, const float3* nxtNetPoints, unsigned int numNxtNodes);
 
 		void TracePath(IPath* path);
 		void SmoothPath(IPath* path);
@@ -103,16 +103,16 @@ void CFireProjectile::Update()
 		}
 		if (!(ttl & 31)) {
 			// synced code
-			const std::vector<CFeature*>& features = quadField->GetFeaturesExact(emitPos + wind.GetCurrentWind() * 0.7f, emitRadius * 2);
-			const std::vector<CUnit*>& units = quadField->GetUnitsExact(emitPos + wind.GetCurrentWind() * 0.7f, emitRadius * 2);
+			const CQuadField::FeatureVector& features = quadField->GetFeaturesExact(emitPos + wind.GetCurrentWind() * 0.7f, emitRadius * 2);
+			const CQuadField::UnitVector& units = quadField->GetUnitsExact(emitPos + wind.GetCurrentWind() * 0.7f, emitRadius * 2);
 
-			for (std::vector<CFeature*>::const_iterator fi = features.begin(); fi != features.end(); ++fi) {
+			for (CQuadField::FeatureVector::const_iterator fi = features.begin(); fi != features.end(); ++fi) {
 				if (gs->randFloat() > 0.8f) {
 					(*fi)->StartFire();
 				}
 			}
 
-			for (std::vector<CUnit*>::const_iterator ui = units.begin(); ui != units.end(); ++ui) {
+			for (CQuadField::UnitVector::const_iterator ui = units.begin(); ui != units.end(); ++ui) {
 				(*ui)->DoDamage(DamageArray(30), ZeroVector, NULL, -CSolidObject::DAMAGE_EXTSOURCE_FIRE, -1);
 			}
 		}
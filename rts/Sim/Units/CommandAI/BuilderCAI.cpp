@@ -1465,8 +1465,8 @@ int CBuilderCAI::FindReclaimTarget(const float3& pos, float radius, unsigned cha
 	int rid = -1;
 
 	if (recUnits || recEnemy || recEnemyOnly) {
-		const std::vector<CUnit*>& units = quadField->GetUnitsExact(pos, radius);
-		for (std::vector<CUnit*>::const_iterator ui = units.begin(); ui != units.end(); ++ui) {
+		const CQuadField::UnitVector& units = quadField->GetUnitsExact(pos, radius);
+		for (CQuadField::UnitVector::const_iterator ui = units.begin(); ui != units.end(); ++ui) {
 			const CUnit* u = *ui;
 
 			if (u == owner)
@@ -1505,9 +1505,9 @@ int CBuilderCAI::FindReclaimTarget(const float3& pos, float radius, unsigned cha
 	if ((!best || !stationary) && !recEnemyOnly) {
 		best = NULL;
 		const CTeam* team = teamHandler->Team(owner->team);
-		const std::vector<CFeature*>& features = quadField->GetFeaturesExact(pos, radius);
+		const CQuadField::FeatureVector& features = quadField->GetFeaturesExact(pos, radius);
 		bool metal = false;
-		for (std::vector<CFeature*>::const_iterator fi = features.begin(); fi != features.end(); ++fi) {
+		for (CQuadField::FeatureVector::const_iterator fi = features.begin(); fi != features.end(); ++fi) {
 			const CFeature* f = *fi;
 			if (f->def->reclaimable && (recSpecial || f->def->autoreclaim) &&
 				(!recNonRez || !(f->def->destructable && f->udef != NULL))
@@ -1576,12 +1576,12 @@ bool CBuilderCAI::FindResurrectableFeatureAndResurrect(const float3& pos,
                                                        unsigned char options,
 													   bool freshOnly)
 {
-	const std::vector<CFeature*> &features = quadField->GetFeaturesExact(pos, radius);
+	const CQuadField::FeatureVector& features = quadField->GetFeaturesExact(pos, radius);
 
 	const CFeature* best = NULL;
 	float bestDist = 1.0e30f;
 
-	for (std::vector<CFeature*>::const_iterator fi = features.begin(); fi != features.end(); ++fi) {
+	for (CQuadField::FeatureVector::const_iterator fi = features.begin(); fi != features.end(); ++fi) {
 		const CFeature* f = *fi;
 		if (f->def->destructable && f->udef != NULL) {
 			if (!f->IsInLosForAllyTeam(owner->allyteam)) {
@@ -1619,8 +1619,8 @@ bool CBuilderCAI::FindCaptureTargetAndCapture(const float3& pos, float radius,
                                               unsigned char options,
 											  bool healthyOnly)
 {
-	const std::vector<CUnit*> &cu = quadField->GetUnits(pos, radius);
-	std::vector<CUnit*>::const_iterator ui;
+	const CQuadField::UnitVector& cu = quadField->GetUnits(pos, radius);
+	CQuadField::UnitVector::const_iterator ui;
 
 	const CUnit* best = NULL;
 	float bestDist = 1.0e30f;
@@ -1668,7 +1668,7 @@ bool CBuilderCAI::FindRepairTargetAndRepair(const float3& pos, float radius,
                                             bool attackEnemy,
 											bool builtOnly)
 {
-	const std::vector<CUnit*>& cu = quadField->GetUnitsExact(pos, radius);
+	const CQuadField::UnitVector& cu = quadField->GetUnitsExact(pos, radius);
 	const CUnit* bestUnit = NULL;
 
 	const float maxSpeed = owner->moveType->GetMaxSpeed();
@@ -1679,7 +1679,7 @@ bool CBuilderCAI::FindRepairTargetAndRepair(const float3& pos, float radius,
 	bool trySelfRepair = false;
 	bool stationary = false;
 
-	for (std::vector<CUnit*>::const_iterator ui = cu.begin(); ui != cu.end(); ++ui) {
+	for (CQuadField::UnitVector::const_iterator ui = cu.begin(); ui != cu.end(); ++ui) {
 		const CUnit* unit = *ui;
 
 		if (teamHandler->Ally(owner->allyteam, unit->allyteam)) {
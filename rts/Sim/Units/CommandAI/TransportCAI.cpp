@@ -380,7 +380,7 @@ bool CTransportCAI::FindEmptySpot(const float3& center, float radius, float spre
 		if (moveDef != NULL && CGround::GetSlope(pos.x, pos.z) > moveDef->maxSlope)
 			continue;
 
-		const std::vector<CSolidObject*>& units = quadField->GetSolidsExact(pos, spread, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
+		const CQuadField::SolidVector& units = quadField->GetSolidsExact(pos, spread, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
 
 		if (isAirTrans && (units.size() > 1 || (units.size() == 1 && units[0] != owner)))
 			continue;
@@ -423,7 +423,7 @@ bool CTransportCAI::SpotIsClearIgnoreSelf(float3 pos, CUnit* unitToUnload)
 
 	const float radius = std::max(1.0f, math::ceil(unitToUnload->radius / SQUARE_SIZE)) * SQUARE_SIZE;
 
-	const std::vector<CSolidObject*>& units = quadField->GetSolidsExact(pos, radius, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
+	const CQuadField::SolidVector& units = quadField->GetSolidsExact(pos, radius, 0xFFFFFFFF, CSolidObject::CSTATE_BIT_SOLIDOBJECTS);
 	const std::list<CTransportUnit::TransportedUnit>& transportees = ownerTrans->GetTransportedUnits();
 
 	for (auto objectsIt = units.begin(); objectsIt != units.end(); ++objectsIt) {
@@ -898,9 +898,9 @@ CUnit* CTransportCAI::FindUnitToTransport(float3 center, float radius)
 	CUnit* bestUnit = NULL;
 	float bestDist = std::numeric_limits<float>::max();
 
-	const std::vector<CUnit*>& units = quadField->GetUnitsExact(center, radius);
+	const CQuadField::UnitVector& units = quadField->GetUnitsExact(center, radius);
 
-	for (std::vector<CUnit*>::const_iterator ui = units.begin(); ui != units.end(); ++ui) {
+	for (CQuadField::UnitVector::const_iterator ui = units.begin(); ui != units.end(); ++ui) {
 		CUnit* unit = (*ui);
 		float dist = unit->pos.SqDistance2D(owner->pos);
 
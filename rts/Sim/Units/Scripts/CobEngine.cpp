@@ -37,24 +37,20 @@ CCobEngine::CCobEngine()
 CCobEngine::~CCobEngine()
 {
 	//Should delete all things that the scheduler knows
+	std::vector<CCobThread*> threads;
+
 	do {
-		while (!running.empty()) {
-			CCobThread* tmp = running.front();
-			running.pop_front();
-			delete tmp;
-		}
-		while (!wantToRun.empty()) {
-			CCobThread* tmp = wantToRun.front();
-			wantToRun.pop_front();
-			delete tmp;
-		}
-		while (!sleeping.empty()) {
-			CCobThread* tmp = sleeping.top();
-			sleeping.pop();
-			delete tmp;
+		threads.clear();
+		threads.swap(running);
+		threads.insert(threads.end(), wantToRun.begin(), wantToRun.end());
+		wantToRun.clear();
+		sleeping.Clear(threads);
+
+		for (size_t n = 0; n < threads.size(); n++) {
+			delete threads[n];
 		}
 		// callbacks may add new threads
-	} while (!running.empty() || !wantToRun.empty() || !sleeping.empty());
+	} while (!running.empty() || !wantToRun.empty() || !sleeping.Empty());
 }
 
 
@@ -72,10 +68,10 @@ void CCobEngine::AddThread(CCobThread *thread)
 {
 	switch (thread->state) {
 		case CCobThread::Run:
-			wantToRun.push_front(thread);
+			wantToRun.push_back(thread);
 			break;
 		case CCobThread::Sleep:
-			sleeping.push(thread);
+			sleeping.Add(thread, thread->GetWakeTime());
 			break;
 		default:
 			LOG_L(L_ERROR, "thread added to scheduler with unknown state (%d)", thread->state);
@@ -104,12 +100,12 @@ void CCobEngine::Tick(int deltaTime)
 	LOG_L(L_DEBUG, "----");
 
 	// Advance all running threads
-	for (std::list<CCobThread*>::iterator i = running.begin(); i != running.end(); ++i) {
-		//LOG_L(L_DEBUG, "Now 1running %d: %s", GCurrentTime, (*i)->GetName().c_str());
+	for (size_t n = 0; n < running.size(); n++) {
+		//LOG_L(L_DEBUG, "Now 1running %d: %s", GCurrentTime, running[n]->GetName().c_str());
 #ifdef _CONSOLE
 		printf("----\n");
 #endif
-		TickThread(*i);
+		TickThread(running[n]);
 	}
 
 	// A thread can never go from running->running, so clear the list
@@ -119,39 +115,24 @@ void CCobEngine::Tick(int deltaTime)
 	running.clear();
 
 	// The threads that just ran may have added new threads that should run next tick
-	for (std::list<CCobThread *>::iterator i = wantToRun.begin(); i != wantToRun.end(); ++i) {
-		running.push_front(*i);
-	}
-
-	wantToRun.clear();
+	running.swap(wantToRun);
 
 	//Check on the sleeping threads
-	if (!sleeping.empty()) {
-		CCobThread* cur = sleeping.top();
-
-		while ((cur != NULL) && (cur->GetWakeTime() < GCurrentTime)) {
-			// Start with removing the executing thread from the queue
-			sleeping.pop();
+	CCobThread* cur = NULL;
 
-			//Run forward again. This can quite possibly readd the thread to the sleeping array again
-			//But it will not interfere since it is guaranteed to sleep > 0 ms
-			//LOG_L(L_DEBUG, "Now 2running %d: %s", GCurrentTime, cur->GetName().c_str());
+	while ((cur = sleeping.Pop(GCurrentTime)) != NULL) {
+		//Run forward again. This can quite possibly readd the thread to the sleeping wheel again
+		//LOG_L(L_DEBUG, "Now 2running %d: %s", GCurrentTime, cur->GetName().c_str());
 #ifdef _CONSOLE
-			printf("+++\n");
+		printf("+++\n");
 #endif
-			if (cur->state == CCobThread::Sleep) {
-				cur->state = CCobThread::Run;
-				TickThread(cur);
-			} else if (cur->state == CCobThread::Dead) {
-				delete cur;
-			} else {
-				LOG_L(L_ERROR, "Sleeping thread strange state %d", cur->state);
-			}
-
-			if (!sleeping.empty())
-				cur = sleeping.top();
-			else
-				cur = NULL;
+		if (cur->state == CCobThread::Sleep) {
+			cur->state = CCobThread::Run;
+			TickThread(cur);
+		} else if (cur->state == CCobThread::Dead) {
+			delete cur;
+		} else {
+			LOG_L(L_ERROR, "Sleeping thread strange state %d", cur->state);
 		}
 	}
 }
@@ -3,6 +3,7 @@
 
 #include "Sim/Misc/GlobalConstants.h"
 #include "CobFile.h"
+#include "CobOpcodes.h"
 #include "System/FileSystem/FileHandler.h"
 #include "System/Log/ILog.h"
 #include "System/Sound/ISound.h"
@@ -194,6 +195,71 @@ CCobFile::CCobFile(CFileHandler &in, string name)
 			scriptIndex[it->second] = fn;
 		}
 	}
+
+	fireScripts.resize(scriptNames.size(), false);
+	for (int i = 0; i < MAX_WEAPONS_PER_UNIT; ++i) {
+		const int fn = scriptIndex[COBFN_FirePrimary + COBFN_Weapon_Funcs * i];
+		if (fn >= 0) {
+			fireScripts[fn] = true;
+		}
+	}
+
+	TranslateCode(code_ints);
+}
+
+
+/**
+ * Builds the dense opcode array the interpreter dispatches on.
+ * Every word gets translated (not just the ones at instruction boundaries),
+ * so a jump to any position behaves exactly as it would on the raw code.
+ * Also resolves CALLs to regular or Lua calls, and fuses a PUSH_CONSTANT
+ * with the operation following it; the follower's word is left untouched,
+ * so a jump straight to it still executes it on its own.
+ */
+void CCobFile::TranslateCode(int numCodeInts)
+{
+	ops.resize(numCodeInts, COBOP_UNKNOWN);
+
+	for (int i = 0; i < numCodeInts; ++i) {
+		ops[i] = GetDenseCobOpcode(code[i]);
+	}
+
+	for (int i = 0; i < numCodeInts; ++i) {
+		switch (ops[i]) {
+			case COBOP_CALL: {
+				if ((i + 1) >= numCodeInts)
+					break;
+
+				const int fn = code[i + 1];
+
+				// leave invalid calls to be handled (or not) at runtime
+				if (fn < 0 || fn >= scriptNames.size())
+					break;
+
+				ops[i] = (scriptNames[fn].find("lua_") == 0)? COBOP_LUA_CALL: COBOP_REAL_CALL;
+			} break;
+
+			case COBOP_PUSH_CONSTANT: {
+				if ((i + 2) >= numCodeInts)
+					break;
+
+				switch (code[i + 2]) {
+					case ADD:                  { ops[i] = COBOP_PUSH_CONSTANT_ADD;                  } break;
+					case SUB:                  { ops[i] = COBOP_PUSH_CONSTANT_SUB;                  } break;
+					case MUL:                  { ops[i] = COBOP_PUSH_CONSTANT_MUL;                  } break;
+					case SET_LESS:             { ops[i] = COBOP_PUSH_CONSTANT_SET_LESS;             } break;
+					case SET_LESS_OR_EQUAL:    { ops[i] = COBOP_PUSH_CONSTANT_SET_LESS_OR_EQUAL;    } break;
+					case SET_GREATER:          { ops[i] = COBOP_PUSH_CONSTANT_SET_GREATER;          } break;
+					case SET_GREATER_OR_EQUAL: { ops[i] = COBOP_PUSH_CONSTANT_SET_GREATER_OR_EQUAL; } break;
+					case SET_EQUAL:            { ops[i] = COBOP_PUSH_CONSTANT_SET_EQUAL;            } break;
+					case SET_NOT_EQUAL:        { ops[i] = COBOP_PUSH_CONSTANT_SET_NOT_EQUAL;        } break;
+					default: {} break;
+				}
+			} break;
+
+			default: {} break;
+		}
+	}
 }
 
 
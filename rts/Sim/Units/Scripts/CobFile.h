@@ -20,6 +20,10 @@ public:
 
 	int GetFunctionId(const std::string& name);
 
+private:
+	void TranslateCode(int numCodeInts);
+
+public:
 
 	std::vector<std::string> scriptNames;
 	std::vector<int> scriptOffsets;
@@ -31,6 +35,10 @@ public:
 	std::map<std::string, int> scriptMap;
 	std::vector<LuaHashString> luaScripts;
 	int* code;
+	/// dense opcode (CobDenseOpcode) of every word in code, see TranslateCode
+	std::vector<unsigned char> ops;
+	/// whether a function is one of the FireWeaponN scripts (SHOW emits flares)
+	std::vector<bool> fireScripts;
 	int numStaticVars;
 	std::string name;
 };
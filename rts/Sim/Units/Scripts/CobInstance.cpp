@@ -77,10 +77,10 @@ CCobInstance::~CCobInstance()
 
 	do {
 		for (int animType = ATurn; animType <= AMove; animType++) {
-			for (std::list<AnimInfo *>::iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
+			for (size_t i = 0; i < anims[animType].size(); i++) {
 				// All threads blocking on animations can be killed safely from here since the scheduler does not
 				// know about them
-				std::list<IAnimListener *>& listeners = (*i)->listeners;
+				std::list<IAnimListener *>& listeners = anims[animType][i]->listeners;
 				while (!listeners.empty()) {
 					IAnimListener* al = listeners.front();
 					listeners.pop_front();
@@ -0,0 +1,132 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "CobSleepWheel.h"
+
+#include <cassert>
+
+
+CCobSleepWheel::CCobSleepWheel()
+	: curTime(0)
+	, curSlotPos(0)
+	, numThreads(0)
+{
+	levels[0].resize(LEVEL0_SIZE);
+
+	for (int n = 1; n < NUM_LEVELS; n++) {
+		levels[n].resize(LEVELN_SIZE);
+	}
+}
+
+
+void CCobSleepWheel::Add(CCobThread* thread, int wakeTime)
+{
+	Entry e;
+	e.thread = thread;
+	e.wakeTime = wakeTime;
+
+	Insert(e);
+	numThreads += 1;
+}
+
+
+void CCobSleepWheel::Insert(const Entry& e)
+{
+	// a wake time in the past goes into the slot currently being popped
+	const int wakeTime = (e.wakeTime < curTime)? curTime: e.wakeTime;
+	const unsigned int delta = wakeTime - curTime;
+
+	if (delta < (1u << LEVEL0_BITS)) {
+		levels[0][wakeTime & (LEVEL0_SIZE - 1)].push_back(e);
+		return;
+	}
+
+	for (int n = 1; n < NUM_LEVELS; n++) {
+		const int shift = LEVEL0_BITS + n * LEVELN_BITS;
+
+		if (delta < (1u << shift) || n == (NUM_LEVELS - 1)) {
+			int index = (wakeTime >> (shift - LEVELN_BITS)) & (LEVELN_SIZE - 1);
+
+			// beyond the wheel's range: park in the farthest slot, the
+			// thread gets re-inserted with its real wake time on cascade
+			if (delta >= (1u << shift))
+				index = ((curTime >> (shift - LEVELN_BITS)) - 1) & (LEVELN_SIZE - 1);
+
+			levels[n][index].push_back(e);
+			return;
+		}
+	}
+}
+
+
+void CCobSleepWheel::Cascade(int level, int index)
+{
+	Slot slot;
+	slot.swap(levels[level][index]);
+
+	for (size_t n = 0; n < slot.size(); n++) {
+		Insert(slot[n]);
+	}
+
+	// hand the buffer back for reuse; re-inserting never
+	// targets the slot being cascaded, so it is still empty
+	slot.clear();
+
+	if (levels[level][index].empty())
+		levels[level][index].swap(slot);
+}
+
+
+CCobThread* CCobSleepWheel::Pop(int endTime)
+{
+	while (curTime < endTime) {
+		Slot& slot = levels[0][curTime & (LEVEL0_SIZE - 1)];
+
+		if (curSlotPos < slot.size()) {
+			CCobThread* thread = slot[curSlotPos++].thread;
+			numThreads -= 1;
+			return thread;
+		}
+
+		slot.clear();
+		curSlotPos = 0;
+		curTime += 1;
+
+		if ((curTime & (LEVEL0_SIZE - 1)) != 0)
+			continue;
+
+		// level 0 wrapped, refill it from the coarser levels
+		for (int n = 1; n < NUM_LEVELS; n++) {
+			const int shift = LEVEL0_BITS + (n - 1) * LEVELN_BITS;
+			const int index = (curTime >> shift) & (LEVELN_SIZE - 1);
+
+			Cascade(n, index);
+
+			if (index != 0)
+				break;
+		}
+	}
+
+	return NULL;
+}
+
+
+void CCobSleepWheel::Clear(std::vector<CCobThread*>& threads)
+{
+	for (int n = 0; n < NUM_LEVELS; n++) {
+		for (size_t i = 0; i < levels[n].size(); i++) {
+			Slot& slot = levels[n][i];
+
+			// skip what was already popped from the current slot
+			const size_t start = (n == 0 && i == (curTime & (LEVEL0_SIZE - 1)))? curSlotPos: 0;
+
+			for (size_t k = start; k < slot.size(); k++) {
+				threads.push_back(slot[k].thread);
+			}
+
+			slot.clear();
+		}
+	}
+
+	curSlotPos = 0;
+	numThreads = 0;
+}
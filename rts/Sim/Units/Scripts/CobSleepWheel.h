@@ -0,0 +1,70 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef COB_SLEEP_WHEEL_H
+#define COB_SLEEP_WHEEL_H
+
+#include <cstddef>
+#include <vector>
+
+class CCobThread;
+
+/**
+ * Hierarchical timer wheel holding the sleeping COB threads.
+ * Level 0 has one slot per millisecond for the next 256ms, each further
+ * level covers 64 slots of the previous level's whole range; the contents
+ * of a coarse slot are redistributed ("cascaded") into the finer levels
+ * when level 0 wraps around. Adding a thread and waking it are O(1)
+ * amortized, compared to O(log n) for the former priority queue.
+ *
+ * Threads are woken in order of their wake time, threads with the same
+ * wake time in the order they were added to that slot.
+ */
+class CCobSleepWheel
+{
+public:
+	CCobSleepWheel();
+
+	/// current time of the wheel, every thread waking before it was popped
+	int GetTime() const { return curTime; }
+	bool Empty() const { return (numThreads == 0); }
+
+	/// threads with a wake time in the past are woken at the current time
+	void Add(CCobThread* thread, int wakeTime);
+
+	/**
+	 * Returns the next thread with a wake time before <endTime>,
+	 * or NULL (after advancing the wheel to <endTime>) if there is none.
+	 * Threads can be added between calls.
+	 */
+	CCobThread* Pop(int endTime);
+
+	/// removes and returns every thread, e.g. to delete them
+	void Clear(std::vector<CCobThread*>& threads);
+
+private:
+	struct Entry {
+		CCobThread* thread;
+		int wakeTime;
+	};
+	typedef std::vector<Entry> Slot;
+
+	void Insert(const Entry& e);
+	void Cascade(int level, int index);
+
+private:
+	static const int LEVEL0_BITS = 8;
+	static const int LEVELN_BITS = 6;
+	static const int NUM_LEVELS = 4;
+
+	static const int LEVEL0_SIZE = 1 << LEVEL0_BITS;
+	static const int LEVELN_SIZE = 1 << LEVELN_BITS;
+
+	std::vector<Slot> levels[NUM_LEVELS];
+
+	/// slot being popped from and the position inside it
+	int curTime;
+	size_t curSlotPos;
+	size_t numThreads;
+};
+
+#endif // COB_SLEEP_WHEEL_H
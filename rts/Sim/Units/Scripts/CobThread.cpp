@@ -3,6 +3,7 @@
 
 #include "CobThread.h"
 #include "CobFile.h"
+#include "CobOpcodes.h"
 #include "CobInstance.h"
 #include "CobEngine.h"
 #include "UnitScriptLog.h"
@@ -103,86 +104,6 @@ int CCobThread::GetWakeTime() const
 	return wakeTime;
 }
 
-// Command documentation from http://visualta.tauniverse.com/Downloads/cob-commands.txt
-// And some information from basm0.8 source (basm ops.txt)
-
-// Model interaction
-const int MOVE       = 0x10001000;
-const int TURN       = 0x10002000;
-const int SPIN       = 0x10003000;
-const int STOP_SPIN  = 0x10004000;
-const int SHOW       = 0x10005000;
-const int HIDE       = 0x10006000;
-const int CACHE      = 0x10007000;
-const int DONT_CACHE = 0x10008000;
-const int MOVE_NOW   = 0x1000B000;
-const int TURN_NOW   = 0x1000C000;
-const int SHADE      = 0x1000D000;
-const int DONT_SHADE = 0x1000E000;
-const int EMIT_SFX   = 0x1000F000;
-
-// Blocking operations
-const int WAIT_TURN  = 0x10011000;
-const int WAIT_MOVE  = 0x10012000;
-const int SLEEP      = 0x10013000;
-
-// Stack manipulation
-const int PUSH_CONSTANT    = 0x10021001;
-const int PUSH_LOCAL_VAR   = 0x10021002;
-const int PUSH_STATIC      = 0x10021004;
-const int CREATE_LOCAL_VAR = 0x10022000;
-const int POP_LOCAL_VAR    = 0x10023002;
-const int POP_STATIC       = 0x10023004;
-const int POP_STACK        = 0x10024000; ///< Not sure what this is supposed to do
-
-// Arithmetic operations
-const int ADD         = 0x10031000;
-const int SUB         = 0x10032000;
-const int MUL         = 0x10033000;
-const int DIV         = 0x10034000;
-const int MOD		  = 0x10034001; ///< spring specific
-const int BITWISE_AND = 0x10035000;
-const int BITWISE_OR  = 0x10036000;
-const int BITWISE_XOR = 0x10037000;
-const int BITWISE_NOT = 0x10038000;
-
-// Native function calls
-const int RAND           = 0x10041000;
-const int GET_UNIT_VALUE = 0x10042000;
-const int GET            = 0x10043000;
-
-// Comparison
-const int SET_LESS             = 0x10051000;
-const int SET_LESS_OR_EQUAL    = 0x10052000;
-const int SET_GREATER          = 0x10053000;
-const int SET_GREATER_OR_EQUAL = 0x10054000;
-const int SET_EQUAL            = 0x10055000;
-const int SET_NOT_EQUAL        = 0x10056000;
-const int LOGICAL_AND          = 0x10057000;
-const int LOGICAL_OR           = 0x10058000;
-const int LOGICAL_XOR          = 0x10059000;
-const int LOGICAL_NOT          = 0x1005A000;
-
-// Flow control
-const int START           = 0x10061000;
-const int CALL            = 0x10062000; ///< converted when executed
-const int REAL_CALL       = 0x10062001; ///< spring custom
-const int LUA_CALL        = 0x10062002; ///< spring custom
-const int JUMP            = 0x10064000;
-const int RETURN          = 0x10065000;
-const int JUMP_NOT_EQUAL  = 0x10066000;
-const int SIGNAL          = 0x10067000;
-const int SET_SIGNAL_MASK = 0x10068000;
-
-// Piece destruction
-const int EXPLODE    = 0x10071000;
-const int PLAY_SOUND = 0x10072000;
-
-// Special functions
-const int SET    = 0x10082000;
-const int ATTACH = 0x10083000;
-const int DROP   = 0x10084000;
-
 // Indices for SET, GET, and GET_UNIT_VALUE for LUA return values
 #define LUA0 110 // (LUA0 returns the lua call status, 0 or 1)
 #define LUA1 111
@@ -237,37 +158,85 @@ bool CCobThread::Tick()
 		// Disabling exec trace gives about a 50% speedup on vm-intensive code
 		//execTrace.push_back(PC);
 
-		int opcode = GET_LONG_PC();
+		const int opcode = script.ops[PC++];
 
-		LOG_L(L_DEBUG, "PC: %x opcode: %x (%s)", PC - 1, opcode, GetOpcodeName(opcode).c_str());
+		LOG_L(L_DEBUG, "PC: %x opcode: %x (%s)", PC - 1, script.code[PC - 1], GetOpcodeName(script.code[PC - 1]).c_str());
 
-		switch(opcode) {
-			case PUSH_CONSTANT:
+		switch (opcode) {
+			case COBOP_PUSH_CONSTANT:
 				r1 = GET_LONG_PC();
 				stack.push_back(r1);
 				break;
-			case SLEEP:
+
+			// fused PUSH_CONSTANT + op, PC skips the op's own word
+			case COBOP_PUSH_CONSTANT_ADD:
+				r2 = GET_LONG_PC(); PC++;
+				r1 = POP();
+				stack.push_back(r1 + r2);
+				break;
+			case COBOP_PUSH_CONSTANT_SUB:
+				r2 = GET_LONG_PC(); PC++;
+				r1 = POP();
+				stack.push_back(r1 - r2);
+				break;
+			case COBOP_PUSH_CONSTANT_MUL:
+				r1 = GET_LONG_PC(); PC++;
+				r2 = POP();
+				stack.push_back(r1 * r2);
+				break;
+			case COBOP_PUSH_CONSTANT_SET_LESS:
+				r2 = GET_LONG_PC(); PC++;
+				r1 = POP();
+				stack.push_back(int(r1 < r2));
+				break;
+			case COBOP_PUSH_CONSTANT_SET_LESS_OR_EQUAL:
+				r2 = GET_LONG_PC(); PC++;
+				r1 = POP();
+				stack.push_back(int(r1 <= r2));
+				break;
+			case COBOP_PUSH_CONSTANT_SET_GREATER:
+				r2 = GET_LONG_PC(); PC++;
+				r1 = POP();
+				stack.push_back(int(r1 > r2));
+				break;
+			case COBOP_PUSH_CONSTANT_SET_GREATER_OR_EQUAL:
+				r2 = GET_LONG_PC(); PC++;
+				r1 = POP();
+				stack.push_back(int(r1 >= r2));
+				break;
+			case COBOP_PUSH_CONSTANT_SET_EQUAL:
+				r1 = GET_LONG_PC(); PC++;
+				r2 = POP();
+				stack.push_back(int(r1 == r2));
+				break;
+			case COBOP_PUSH_CONSTANT_SET_NOT_EQUAL:
+				r1 = GET_LONG_PC(); PC++;
+				r2 = POP();
+				stack.push_back(int(r1 != r2));
+				break;
+
+			case COBOP_SLEEP:
 				r1 = POP();
 				wakeTime = GCurrentTime + r1;
 				state = Sleep;
 				GCobEngine.AddThread(this);
 				LOG_L(L_DEBUG, "%s sleeping for %d ms", script.scriptNames[callStack.back().functionId].c_str(), r1);
 				return true;
-			case SPIN:
+			case COBOP_SPIN:
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				r3 = POP();         // speed
 				r4 = POP();         // accel
 				owner->Spin(r1, r2, r3, r4);
 				break;
-			case STOP_SPIN:
+			case COBOP_STOP_SPIN:
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				r3 = POP();         // decel
 				//LOG_L(L_DEBUG, "Stop spin of %s around %d", script.pieceNames[r1].c_str(), r2);
 				owner->StopSpin(r1, r2, r3);
 				break;
-			case RETURN:
+			case COBOP_RETURN:
 				retCode = POP();
 				if (callStack.back().returnAddr == -1) {
 					LOG_L(L_DEBUG, "%s returned %d", script.scriptNames[callStack.back().functionId].c_str(), retCode);
@@ -284,32 +253,31 @@ bool CCobThread::Tick()
 				callStack.pop_back();
 				LOG_L(L_DEBUG, "Returning to %s", script.scriptNames[callStack.back().functionId].c_str());
 				break;
-			case SHADE:
+			case COBOP_SHADE:
 				r1 = GET_LONG_PC();
 				break;
-			case DONT_SHADE:
+			case COBOP_DONT_SHADE:
 				r1 = GET_LONG_PC();
 				break;
-			case CACHE:
+			case COBOP_CACHE:
 				r1 = GET_LONG_PC();
 				break;
-			case DONT_CACHE:
+			case COBOP_DONT_CACHE:
 				r1 = GET_LONG_PC();
 				break;
-			case CALL: {
+			case COBOP_CALL: {
+				// only reached if CCobFile could not resolve the call at load time
 				r1 = GET_LONG_PC();
 				PC--;
 				const string& name = script.scriptNames[r1];
 				if (name.find("lua_") == 0) {
-					script.code[PC - 1] = LUA_CALL;
 					LuaCall();
 					break;
 				}
-				script.code[PC - 1] = REAL_CALL;
 
 				// fall through //
 			}
-			case REAL_CALL:
+			case COBOP_REAL_CALL:
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 
@@ -328,19 +296,19 @@ bool CCobThread::Tick()
 				PC = script.scriptOffsets[r1];
 				//LOG_L(L_DEBUG, "Calling %s", script.scriptNames[r1].c_str());
 				break;
-			case LUA_CALL:
+			case COBOP_LUA_CALL:
 				LuaCall();
 				break;
-			case POP_STATIC:
+			case COBOP_POP_STATIC:
 				r1 = GET_LONG_PC();
 				r2 = POP();
 				owner->staticVars[r1] = r2;
 				//LOG_L(L_DEBUG, "Pop static var %d val %d", r1, r2);
 				break;
-			case POP_STACK:
+			case COBOP_POP_STACK:
 				POP();
 				break;
-			case START: {
+			case COBOP_START: {
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 
@@ -363,14 +331,14 @@ bool CCobThread::Tick()
 				thread->signalMask = signalMask;
 				LOG_L(L_DEBUG, "Starting %s %d", script.scriptNames[r1].c_str(), signalMask);
 			} break;
-			case CREATE_LOCAL_VAR:
+			case COBOP_CREATE_LOCAL_VAR:
 				if (paramCount == 0) {
 					stack.push_back(0);
 				} else {
 					paramCount--;
 				}
 				break;
-			case GET_UNIT_VALUE:
+			case COBOP_GET_UNIT_VALUE:
 				r1 = POP();
 				if ((r1 >= LUA0) && (r1 <= LUA9)) {
 					stack.push_back(luaArgs[r1 - LUA0]);
@@ -379,30 +347,30 @@ bool CCobThread::Tick()
 				r1 = owner->GetUnitVal(r1, 0, 0, 0, 0);
 				stack.push_back(r1);
 				break;
-			case JUMP_NOT_EQUAL:
+			case COBOP_JUMP_NOT_EQUAL:
 				r1 = GET_LONG_PC();
 				r2 = POP();
 				if (r2 == 0) {
 					PC = r1;
 				}
 				break;
-			case JUMP:
+			case COBOP_JUMP:
 				r1 = GET_LONG_PC();
 				// this seem to be an error in the docs..
 				//r2 = script.scriptOffsets[callStack.back().functionId] + r1;
 				PC = r1;
 				break;
-			case POP_LOCAL_VAR:
+			case COBOP_POP_LOCAL_VAR:
 				r1 = GET_LONG_PC();
 				r2 = POP();
 				stack[callStack.back().stackTop + r1] = r2;
 				break;
-			case PUSH_LOCAL_VAR:
+			case COBOP_PUSH_LOCAL_VAR:
 				r1 = GET_LONG_PC();
 				r2 = stack[callStack.back().stackTop + r1];
 				stack.push_back(r2);
 				break;
-			case SET_LESS_OR_EQUAL:
+			case COBOP_SET_LESS_OR_EQUAL:
 				r2 = POP();
 				r1 = POP();
 				if (r1 <= r2)
@@ -410,41 +378,41 @@ bool CCobThread::Tick()
 				else
 					stack.push_back(0);
 				break;
-			case BITWISE_AND:
+			case COBOP_BITWISE_AND:
 				r1 = POP();
 				r2 = POP();
 				stack.push_back(r1 & r2);
 				break;
-			case BITWISE_OR: // seems to want stack contents or'd, result places on stack
+			case COBOP_BITWISE_OR: // seems to want stack contents or'd, result places on stack
 				r1 = POP();
 				r2 = POP();
 				stack.push_back(r1 | r2);
 				break;
-			case BITWISE_XOR:
+			case COBOP_BITWISE_XOR:
 				r1 = POP();
 				r2 = POP();
 				stack.push_back(r1 ^ r2);
 				break;
-			case BITWISE_NOT:
+			case COBOP_BITWISE_NOT:
 				r1 = POP();
 				stack.push_back(~r1);
 				break;
-			case EXPLODE:
+			case COBOP_EXPLODE:
 				r1 = GET_LONG_PC();
 				r2 = POP();
 				owner->Explode(r1, r2);
 				break;
-			case PLAY_SOUND:
+			case COBOP_PLAY_SOUND:
 				r1 = GET_LONG_PC();
 				r2 = POP();
 				owner->PlayUnitSound(r1, r2);
 				break;
-			case PUSH_STATIC:
+			case COBOP_PUSH_STATIC:
 				r1 = GET_LONG_PC();
 				stack.push_back(owner->staticVars[r1]);
 				//LOG_L(L_DEBUG, "Push static %d val %d", r1, owner->staticVars[r1]);
 				break;
-			case SET_NOT_EQUAL:
+			case COBOP_SET_NOT_EQUAL:
 				r1 = POP();
 				r2 = POP();
 				if (r1 != r2)
@@ -452,7 +420,7 @@ bool CCobThread::Tick()
 				else
 					stack.push_back(0);
 				break;
-			case SET_EQUAL:
+			case COBOP_SET_EQUAL:
 				r1 = POP();
 				r2 = POP();
 				if (r1 == r2)
@@ -460,7 +428,7 @@ bool CCobThread::Tick()
 				else
 					stack.push_back(0);
 				break;
-			case SET_LESS:
+			case COBOP_SET_LESS:
 				r2 = POP();
 				r1 = POP();
 				if (r1 < r2)
@@ -468,7 +436,7 @@ bool CCobThread::Tick()
 				else
 					stack.push_back(0);
 				break;
-			case SET_GREATER:
+			case COBOP_SET_GREATER:
 				r2 = POP();
 				r1 = POP();
 				if (r1 > r2)
@@ -476,7 +444,7 @@ bool CCobThread::Tick()
 				else
 					stack.push_back(0);
 				break;
-			case SET_GREATER_OR_EQUAL:
+			case COBOP_SET_GREATER_OR_EQUAL:
 				r2 = POP();
 				r1 = POP();
 				if (r1 >= r2)
@@ -484,31 +452,31 @@ bool CCobThread::Tick()
 				else
 					stack.push_back(0);
 				break;
-			case RAND:
+			case COBOP_RAND:
 				r2 = POP();
 				r1 = POP();
 				r3 = gs->randInt() % (r2 - r1 + 1) + r1;
 				stack.push_back(r3);
 				break;
-			case EMIT_SFX:
+			case COBOP_EMIT_SFX:
 				r1 = POP();
 				r2 = GET_LONG_PC();
 				owner->EmitSfx(r1, r2);
 				break;
-			case MUL:
+			case COBOP_MUL:
 				r1 = POP();
 				r2 = POP();
 				stack.push_back(r1 * r2);
 				break;
-			case SIGNAL:
+			case COBOP_SIGNAL:
 				r1 = POP();
 				owner->Signal(r1);
 				break;
-			case SET_SIGNAL_MASK:
+			case COBOP_SET_SIGNAL_MASK:
 				r1 = POP();
 				signalMask = r1;
 				break;
-			case TURN:
+			case COBOP_TURN:
 				r2 = POP();
 				r1 = POP();
 				r3 = GET_LONG_PC();
@@ -516,7 +484,7 @@ bool CCobThread::Tick()
 				//LOG_L(L_DEBUG, "Turning piece %s axis %d to %d speed %d", script.pieceNames[r3].c_str(), r4, r2, r1);
 				owner->Turn(r3, r4, r1, r2);
 				break;
-			case GET:
+			case COBOP_GET:
 				r5 = POP();
 				r4 = POP();
 				r3 = POP();
@@ -529,18 +497,18 @@ bool CCobThread::Tick()
 				r6 = owner->GetUnitVal(r1, r2, r3, r4, r5);
 				stack.push_back(r6);
 				break;
-			case ADD:
+			case COBOP_ADD:
 				r2 = POP();
 				r1 = POP();
 				stack.push_back(r1 + r2);
 				break;
-			case SUB:
+			case COBOP_SUB:
 				r2 = POP();
 				r1 = POP();
 				r3 = r1 - r2;
 				stack.push_back(r3);
 				break;
-			case DIV:
+			case COBOP_DIV:
 				r2 = POP();
 				r1 = POP();
 				if (r2 != 0)
@@ -551,7 +519,7 @@ bool CCobThread::Tick()
 				}
 				stack.push_back(r3);
 				break;
-			case MOD:
+			case COBOP_MOD:
 				r2 = POP();
 				r1 = POP();
 				if (r2 != 0)
@@ -561,26 +529,26 @@ bool CCobThread::Tick()
 					LOG_L(L_ERROR, "modulo division by zero");
 				}
 				break;
-			case MOVE:
+			case COBOP_MOVE:
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				r4 = POP();
 				r3 = POP();
 				owner->Move(r1, r2, r3, r4);
 				break;
-			case MOVE_NOW:{
+			case COBOP_MOVE_NOW:{
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				r3 = POP();
 				owner->MoveNow(r1, r2, r3);
 				break;}
-			case TURN_NOW:{
+			case COBOP_TURN_NOW:{
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				r3 = POP();
 				owner->TurnNow(r1, r2, r3);
 				break;}
-			case WAIT_TURN:
+			case COBOP_WAIT_TURN:
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				//LOG_L(L_DEBUG, "Waiting for turn on piece %s around axis %d", script.pieceNames[r1].c_str(), r2);
@@ -590,7 +558,7 @@ bool CCobThread::Tick()
 				}
 				else
 					break;
-			case WAIT_MOVE:
+			case COBOP_WAIT_MOVE:
 				r1 = GET_LONG_PC();
 				r2 = GET_LONG_PC();
 				//LOG_L(L_DEBUG, "Waiting for move on piece %s on axis %d", script.pieceNames[r1].c_str(), r2);
@@ -599,7 +567,7 @@ bool CCobThread::Tick()
 					return true;
 				}
 				break;
-			case SET:
+			case COBOP_SET:
 				r2 = POP();
 				r1 = POP();
 				//LOG_L(L_DEBUG, "Setting unit value %d to %d", r1, r2);
@@ -609,24 +577,24 @@ bool CCobThread::Tick()
 				}
 				owner->SetUnitVal(r1, r2);
 				break;
-			case ATTACH:
+			case COBOP_ATTACH:
 				r3 = POP();
 				r2 = POP();
 				r1 = POP();
 				owner->AttachUnit(r2, r1);
 				break;
-			case DROP:
+			case COBOP_DROP:
 				r1 = POP();
 				owner->DropUnit(r1);
 				break;
-			case LOGICAL_NOT: // Like bitwise, but only on values 1 and 0.
+			case COBOP_LOGICAL_NOT: // Like bitwise, but only on values 1 and 0.
 				r1 = POP();
 				if (r1 == 0)
 					stack.push_back(1);
 				else
 					stack.push_back(0);
 				break;
-			case LOGICAL_AND:
+			case COBOP_LOGICAL_AND:
 				r1 = POP();
 				r2 = POP();
 				if (r1 && r2)
@@ -634,7 +602,7 @@ bool CCobThread::Tick()
 				else
 					stack.push_back(0);
 				break;
-			case LOGICAL_OR:
+			case COBOP_LOGICAL_OR:
 				r1 = POP();
 				r2 = POP();
 				if (r1 || r2)
@@ -642,7 +610,7 @@ bool CCobThread::Tick()
 				else
 					stack.push_back(0);
 				break;
-			case LOGICAL_XOR:
+			case COBOP_LOGICAL_XOR:
 				r1 = POP();
 				r2 = POP();
 				if ( (!!r1) ^ (!!r2))
@@ -650,20 +618,16 @@ bool CCobThread::Tick()
 				else
 					stack.push_back(0);
 				break;
-			case HIDE:
+			case COBOP_HIDE:
 				r1 = GET_LONG_PC();
 				owner->SetVisibility(r1, false);
 				//LOG_L(L_DEBUG, "Hiding %d", r1);
 				break;
-			case SHOW:{
+			case COBOP_SHOW:{
 				r1 = GET_LONG_PC();
-				int i;
-				for (i = 0; i < MAX_WEAPONS_PER_UNIT; ++i)
-					if (callStack.back().functionId == script.scriptIndex[COBFN_FirePrimary + COBFN_Weapon_Funcs * i])
-						break;
 
 				// If true, we are in a Fire-script and should show a special flare effect
-				if (i < MAX_WEAPONS_PER_UNIT) {
+				if (script.fireScripts[callStack.back().functionId]) {
 					owner->ShowFlare(r1);
 				}
 				else {
@@ -673,7 +637,7 @@ bool CCobThread::Tick()
 				break;}
 			default:
 				LOG_L(L_ERROR, "Unknown opcode %x (in %s:%s at %x)",
-						opcode, script.name.c_str(),
+						script.code[PC - 1], script.name.c_str(),
 						script.scriptNames[callStack.back().functionId].c_str(),
 						PC - 1);
 				LOG_L(L_ERROR, "Exec trace:");
@@ -85,9 +85,9 @@ CUnitScript::~CUnitScript()
 	bool haveAnimations = false;
 
 	for (int animType = ATurn; animType <= AMove; animType++) {
-		for (std::list<AnimInfo*>::iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
+		for (size_t i = 0; i < anims[animType].size(); i++) {
 			// anim listeners are not owned by the anim in general, so don't delete them here
-			delete *i;
+			delete anims[animType][i];
 		}
 
 		haveAnimations = (haveAnimations || !anims[animType].empty());
@@ -213,50 +213,50 @@ bool CUnitScript::DoSpin(float& cur, float dest, float &speed, float accel, int
 
 
 
-void CUnitScript::TickAnims(int deltaTime, AnimType type, std::list< std::list<AnimInfo*>::iterator >& doneAnims) {
+void CUnitScript::TickAnims(int deltaTime, AnimType type, std::vector<AnimInfo*>& doneAnims) {
 	switch (type) {
 		case AMove: {
-			for (std::list<AnimInfo*>::iterator it = anims[type].begin(); it != anims[type].end(); ++it) {
-				AnimInfo* ai = *it;
+			for (size_t i = 0; i < anims[type].size(); i++) {
+				AnimInfo* ai = anims[type][i];
 
 				// NOTE: we should not need to copy-and-set here, because
 				// MoveToward/TurnToward/DoSpin modify pos/rot by reference
 				float3 pos = pieces[ai->piece]->GetPosition();
 
 				if (MoveToward(pos[ai->axis], ai->dest, ai->speed / (1000 / deltaTime))) {
-					ai->done = true; doneAnims.push_back(it);
+					ai->done = true; doneAnims.push_back(ai);
 				}
 
 				pieces[ai->piece]->SetPosition(pos);
-				unit->localModel->PieceUpdated(ai->piece);
+				unit->localModel->PieceUpdated(pieces[ai->piece]);
 			}
 		} break;
 
 		case ATurn: {
-			for (std::list<AnimInfo*>::iterator it = anims[type].begin(); it != anims[type].end(); ++it) {
-				AnimInfo* ai = *it;
+			for (size_t i = 0; i < anims[type].size(); i++) {
+				AnimInfo* ai = anims[type][i];
 				float3 rot = pieces[ai->piece]->GetRotation();
 
 				if (TurnToward(rot[ai->axis], ai->dest, ai->speed / (1000 / deltaTime))) {
-					ai->done = true; doneAnims.push_back(it);
+					ai->done = true; doneAnims.push_back(ai);
 				}
 
 				pieces[ai->piece]->SetRotation(rot);
-				unit->localModel->PieceUpdated(ai->piece);
+				unit->localModel->PieceUpdated(pieces[ai->piece]);
 			}
 		} break;
 
 		case ASpin: {
-			for (std::list<AnimInfo*>::iterator it = anims[type].begin(); it != anims[type].end(); ++it) {
-				AnimInfo* ai = *it;
+			for (size_t i = 0; i < anims[type].size(); i++) {
+				AnimInfo* ai = anims[type][i];
 				float3 rot = pieces[ai->piece]->GetRotation();
 
 				if (DoSpin(rot[ai->axis], ai->dest, ai->speed, ai->accel, 1000 / deltaTime)) {
-					ai->done = true; doneAnims.push_back(it);
+					ai->done = true; doneAnims.push_back(ai);
 				}
 
 				pieces[ai->piece]->SetRotation(rot);
-				unit->localModel->PieceUpdated(ai->piece);
+				unit->localModel->PieceUpdated(pieces[ai->piece]);
 			}
 		} break;
 
@@ -273,11 +273,7 @@ void CUnitScript::TickAnims(int deltaTime, AnimType type, std::list< std::list<A
  */
 bool CUnitScript::Tick(int deltaTime)
 {
-	typedef std::list<AnimInfo*>::iterator AnimInfoIt;
-
-	// list of _iterators_ to finished animations,
-	// so we can get rid of them in constant time
-	std::list<AnimInfoIt> doneAnims;
+	std::vector<AnimInfo*> doneAnims;
 
 	for (int animType = ATurn; animType <= AMove; animType++) {
 		TickAnims(deltaTime, AnimType(animType), doneAnims);
@@ -288,14 +284,16 @@ bool CUnitScript::Tick(int deltaTime)
 	//!     removing a finished animation _must_ happen before notifying its listeners,
 	//!     otherwise the callback function (AnimFinished()) can call AddAnimListener()
 	//!     and append it to the listeners-list again (causing an endless loop)!
+	//!     All of them are detached first since removal reorders anims[type].
 	//! NOTE: UnblockAll might result in new anims being added
-	for (std::list<AnimInfoIt>::const_iterator it = doneAnims.begin(); it != doneAnims.end(); ++it) {
-		AnimInfoIt animInfoIt = *it;
-		AnimInfo* animInfo = *animInfoIt;
+	for (size_t i = 0; i < doneAnims.size(); i++) {
+		AnimInfo* animInfo = doneAnims[i];
+		DetachAnim(animInfo->type, FindAnim(animInfo->type, animInfo->piece, animInfo->axis));
+	}
 
-		anims[animInfo->type].erase(animInfoIt);
-		UnblockAll(animInfo);
-		delete animInfo;
+	for (size_t i = 0; i < doneAnims.size(); i++) {
+		UnblockAll(doneAnims[i]);
+		delete doneAnims[i];
 	}
 
 	return (HaveAnimations());
@@ -303,21 +301,38 @@ bool CUnitScript::Tick(int deltaTime)
 
 
 
-std::list<CUnitScript::AnimInfo*>::iterator CUnitScript::FindAnim(AnimType type, int piece, int axis)
+int CUnitScript::FindAnim(AnimType type, int piece, int axis) const
 {
-	for (std::list<AnimInfo*>::iterator i = anims[type].begin(); i != anims[type].end(); ++i) {
-		if (((*i)->piece == piece) && ((*i)->axis == axis))
-			return i;
-	}
+	const unsigned int key = piece * 3 + axis;
+
+	if (piece < 0 || axis < 0 || axis > 2 || key >= animIndices[type].size())
+		return -1;
+
+	return animIndices[type][key];
+}
+
+/**
+ * @brief Takes an animation out of the table without deleting it
+ * The last animation of the same type is moved into its place.
+ */
+CUnitScript::AnimInfo* CUnitScript::DetachAnim(AnimType type, int animIdx)
+{
+	std::vector<AnimInfo*>& typeAnims = anims[type];
+	AnimInfo* ai = typeAnims[animIdx];
+	AnimInfo* last = typeAnims.back();
+
+	typeAnims[animIdx] = last;
+	typeAnims.pop_back();
 
-	return anims[type].end();
+	animIndices[type][last->piece * 3 + last->axis] = animIdx;
+	animIndices[type][ai->piece * 3 + ai->axis] = -1;
+	return ai;
 }
 
-void CUnitScript::RemoveAnim(AnimType type, const std::list<AnimInfo*>::iterator& animInfoIt)
+void CUnitScript::RemoveAnim(AnimType type, int animIdx)
 {
-	if (animInfoIt != anims[type].end()) {
-		AnimInfo* ai = *animInfoIt;
-		anims[type].erase(animInfoIt);
+	if (animIdx != -1) {
+		AnimInfo* ai = DetachAnim(type, animIdx);
 
 		// If this was the last animation, remove from currently animating list
 		// FIXME: this could be done in a cleaner way
@@ -343,6 +358,10 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 		ShowScriptError("Invalid piecenumber");
 		return;
 	}
+	if (axis < 0 || axis > 2) {
+		ShowScriptError("Invalid axis");
+		return;
+	}
 
 	float destf = 0.0f;
 
@@ -355,7 +374,7 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 		}
 	}
 
-	std::list<AnimInfo*>::iterator animInfoIt;
+	int animIdx = -1;
 	AnimInfo* ai = NULL;
 	AnimType overrideType = ANone;
 
@@ -366,28 +385,28 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 	switch (type) {
 		case ATurn: {
 			overrideType = ASpin;
-			animInfoIt = FindAnim(overrideType, piece, axis);
+			animIdx = FindAnim(overrideType, piece, axis);
 		} break;
 		case ASpin: {
 			overrideType = ATurn;
-			animInfoIt = FindAnim(overrideType, piece, axis);
+			animIdx = FindAnim(overrideType, piece, axis);
 		} break;
 		case AMove: {
 			// ensure we never remove an animation of this type
 			overrideType = AMove;
-			animInfoIt = anims[overrideType].end();
+			animIdx = -1;
 		} break;
 		default: {
 		} break;
 	}
 
-	if (animInfoIt != anims[overrideType].end())
-		RemoveAnim(overrideType, animInfoIt);
+	if (animIdx != -1)
+		RemoveAnim(overrideType, animIdx);
 
 	// now find an animation of our own type
-	animInfoIt = FindAnim(type, piece, axis);
+	animIdx = FindAnim(type, piece, axis);
 
-	if (animInfoIt == anims[type].end()) {
+	if (animIdx == -1) {
 		// If we were not animating before, inform the engine of this so it can schedule us
 		// FIXME: this could be done in a cleaner way
 		if (!HaveAnimations()) {
@@ -398,9 +417,14 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 		ai->type = type;
 		ai->piece = piece;
 		ai->axis = axis;
+
+		if (animIndices[type].size() < (pieces.size() * 3))
+			animIndices[type].resize(pieces.size() * 3, -1);
+
+		animIndices[type][piece * 3 + axis] = anims[type].size();
 		anims[type].push_back(ai);
 	} else {
-		ai = *animInfoIt;
+		ai = anims[type][animIdx];
 	}
 
 	ai->dest  = destf;
@@ -412,11 +436,11 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 
 void CUnitScript::Spin(int piece, int axis, float speed, float accel)
 {
-	std::list<AnimInfo*>::iterator animInfoIt = FindAnim(ASpin, piece, axis);
+	const int animIdx = FindAnim(ASpin, piece, axis);
 
 	//If we are already spinning, we may have to decelerate to the new speed
-	if (animInfoIt != anims[ASpin].end()) {
-		AnimInfo* ai = *animInfoIt;
+	if (animIdx != -1) {
+		AnimInfo* ai = anims[ASpin][animIdx];
 		ai->dest = speed;
 
 		if (accel > 0) {
@@ -438,15 +462,15 @@ void CUnitScript::Spin(int piece, int axis, float speed, float accel)
 
 void CUnitScript::StopSpin(int piece, int axis, float decel)
 {
-	std::list<AnimInfo*>::iterator animInfoIt = FindAnim(ASpin, piece, axis);
+	const int animIdx = FindAnim(ASpin, piece, axis);
 
 	if (decel <= 0) {
-		RemoveAnim(ASpin, animInfoIt);
+		RemoveAnim(ASpin, animIdx);
 	} else {
-		if (animInfoIt == anims[ASpin].end())
+		if (animIdx == -1)
 			return;
 
-		AnimInfo* ai = *animInfoIt;
+		AnimInfo* ai = anims[ASpin][animIdx];
 		ai->dest = 0;
 		ai->accel = decel;
 	}
@@ -479,7 +503,7 @@ void CUnitScript::MoveNow(int piece, int axis, float destination)
 	pos[axis] = pieces[piece]->original->offset[axis] + destination;
 
 	p->SetPosition(pos);
-	m->PieceUpdated(piece);
+	m->PieceUpdated(p);
 }
 
 
@@ -497,7 +521,7 @@ void CUnitScript::TurnNow(int piece, int axis, float destination)
 	rot[axis] = destination;
 
 	p->SetRotation(rot);
-	m->PieceUpdated(piece);
+	m->PieceUpdated(p);
 }
 
 
@@ -721,10 +745,10 @@ void CUnitScript::DropUnit(int u)
 //Returns true if there was an animation to listen to
 bool CUnitScript::AddAnimListener(AnimType type, int piece, int axis, IAnimListener *listener)
 {
-	std::list<AnimInfo*>::iterator animInfoIt = FindAnim(type, piece, axis);
+	const int animIdx = FindAnim(type, piece, axis);
 
-	if (animInfoIt != anims[type].end()) {
-		AnimInfo* ai = *animInfoIt;
+	if (animIdx != -1) {
+		AnimInfo* ai = anims[type][animIdx];
 
 		if (!ai->done) {
 			ai->listeners.push_back(listener);
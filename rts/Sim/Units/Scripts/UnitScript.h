@@ -74,7 +74,10 @@ protected:
 		std::list<IAnimListener*> listeners;
 	};
 
-	std::list<AnimInfo*> anims[AMove + 1];
+	/// active animations per type, unordered (removal swaps in the last one)
+	std::vector<AnimInfo*> anims[AMove + 1];
+	/// index into anims[type] for each (piece * 3 + axis), -1 if not animated
+	std::vector<int> animIndices[AMove + 1];
 
 	bool hasSetSFXOccupy;
 	bool hasRockUnit;
@@ -86,8 +89,9 @@ protected:
 	bool TurnToward(float& cur, float dest, float speed);
 	bool DoSpin(float& cur, float dest, float& speed, float accel, int divisor);
 
-	std::list<AnimInfo*>::iterator FindAnim(AnimType anim, int piece, int axis);
-	void RemoveAnim(AnimType type, const std::list<AnimInfo*>::iterator& animInfoIt);
+	int FindAnim(AnimType type, int piece, int axis) const;
+	AnimInfo* DetachAnim(AnimType type, int animIdx);
+	void RemoveAnim(AnimType type, int animIdx);
 	void AddAnim(AnimType type, int piece, int axis, float speed, float dest, float accel);
 
 	virtual void ShowScriptError(const std::string& msg) = 0;
@@ -139,7 +143,7 @@ public:
 	const CUnit* GetUnit() const { return unit; }
 
 	bool Tick(int deltaTime);
-	void TickAnims(int deltaTime, AnimType type, std::list< std::list<AnimInfo*>::iterator >& doneAnims);
+	void TickAnims(int deltaTime, AnimType type, std::vector<AnimInfo*>& doneAnims);
 
 	// animation, used by CCobThread
 	void Spin(int piece, int axis, float speed, float accel);
@@ -163,7 +167,7 @@ public:
 	void SetUnitVal(int val, int param);
 
 	bool IsInAnimation(AnimType type, int piece, int axis) {
-		return (FindAnim(type, piece, axis) != anims[type].end());
+		return (FindAnim(type, piece, axis) != -1);
 	}
 	bool HaveAnimations() const {
 		return (!anims[ATurn].empty() || !anims[ASpin].empty() || !anims[AMove].empty());
@@ -226,8 +230,8 @@ public:
 
 inline bool CUnitScript::HaveListeners() const {
 	for (int animType = ATurn; animType <= AMove; animType++) {
-		for (std::list<AnimInfo *>::const_iterator i = anims[animType].begin(); i != anims[animType].end(); ++i) {
-			if (!(*i)->listeners.empty()) {
+		for (size_t i = 0; i < anims[animType].size(); i++) {
+			if (!anims[animType][i]->listeners.empty()) {
 				return true;
 			}
 		}
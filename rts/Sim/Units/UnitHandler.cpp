@@ -10,6 +10,7 @@
 #include "Sim/Misc/AirBaseHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/MoveTypes/MoveType.h"
+#include "Sim/MoveTypes/UnitCollisionBroadPhase.h"
 #include "System/EventHandler.h"
 #include "System/EventBatchHandler.h"
 #include "System/Log/ILog.h"
@@ -124,6 +125,10 @@ bool CUnitHandler::AddUnit(CUnit* unit)
 	unitsByDefs[unit->team][unit->unitDef->id].insert(unit);
 
 	maxUnitRadius = std::max(unit->radius, maxUnitRadius);
+
+	if (unitCollisionBroadPhase != NULL)
+		unitCollisionBroadPhase->UnitAdded(unit);
+
 	return true;
 }
 
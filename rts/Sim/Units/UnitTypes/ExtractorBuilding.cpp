@@ -90,10 +90,10 @@ void CExtractorBuilding::SetExtractionRangeAndDepth(float range, float depth)
 	extractionDepth = std::max(depth, 0.0f);
 
 	// find any neighbouring extractors
-	const std::vector<CUnit*> &cu = quadField->GetUnits(pos, extractionRange + maxExtractionRange);
+	const CQuadField::UnitVector& cu = quadField->GetUnits(pos, extractionRange + maxExtractionRange);
 	maxExtractionRange = std::max(extractionRange, maxExtractionRange);
 
-	for (std::vector<CUnit*>::const_iterator ui = cu.begin(); ui != cu.end(); ++ui) {
+	for (CQuadField::UnitVector::const_iterator ui = cu.begin(); ui != cu.end(); ++ui) {
 		if (typeid(**ui) == typeid(CExtractorBuilding) && *ui != this) {
 			CExtractorBuilding* eb = (CExtractorBuilding*) *ui;
 
@@ -3,10 +3,14 @@
 
 #include <list>
 #include <algorithm>
+#include <cstring>
+#include <ctime>
 #include <stdio.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <boost/cstdint.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "ArchiveScanner.h"
 #include "ArchiveLoader.h"
@@ -47,6 +51,18 @@ LOG_REGISTER_SECTION_GLOBAL(LOG_SECTION_ARCHIVESCANNER)
 const int INTERNAL_VER = 10;
 CArchiveScanner* archiveScanner = NULL;
 
+/*
+ * Layout of ArchiveCache%i.bin, all integers 32bit in native byte order:
+ *   header:  magic "SPAC", BINARY_CACHE_VER, payload size, payload CRC
+ *   payload: archives, broken archives, directory listings and per-file
+ *            CRCs, each as a count followed by flat records; strings are
+ *            stored as length
+ *            plus bytes (no terminator)
+ * The whole file is read with a single call and parsed in place.
+ */
+static const char BINARY_CACHE_MAGIC[4] = {'S', 'P', 'A', 'C'};
+static const boost::uint32_t BINARY_CACHE_VER = 2;
+
 
 
 /*
@@ -342,11 +358,16 @@ CArchiveScanner::CArchiveScanner()
 {
 	// the "cache" dir is created in DataDirLocater
 	const std:: string cacheFolder = dataDirLocater.GetWriteDirPath() + FileSystem::EnsurePathSepAtEnd(FileSystem::GetCacheBaseDir());
-	cachefile = cacheFolder + IntToString(INTERNAL_VER, "ArchiveCache%i.lua");
-	ReadCacheData(GetFilepath());
-	if (archiveInfos.empty()) {
-		// when versioned ArchiveCache%i.lua is missing or empty, try old unversioned filename
-		ReadCacheData(cacheFolder + "ArchiveCache.lua");
+	cachefile = cacheFolder + IntToString(INTERNAL_VER, "ArchiveCache%i.bin");
+
+	if (!ReadBinaryCacheData(GetFilepath())) {
+		// no (valid) binary cache yet, migrate from the Lua ones
+		ReadCacheData(cacheFolder + IntToString(INTERNAL_VER, "ArchiveCache%i.lua"));
+
+		if (archiveInfos.empty()) {
+			// when versioned ArchiveCache%i.lua is missing or empty, try old unversioned filename
+			ReadCacheData(cacheFolder + "ArchiveCache.lua");
+		}
 	}
 
 	const std::vector<std::string>& datadirs = dataDirLocater.GetDataDirPaths();
@@ -408,7 +429,7 @@ void CArchiveScanner::ScanDirs(const std::vector<std::string>& scanDirs, bool do
 
 	// Create archiveInfos etc. when not being in cache already
 	for (const std::string& archive: foundArchives) {
-		ScanArchive(archive, doChecksum);
+		ScanArchive(archive, false);
 	#if !defined(DEDICATED) && !defined(UNITSYNC)
 		Watchdog::ClearTimer(WDT_MAIN);
 	#endif
@@ -428,6 +449,31 @@ void CArchiveScanner::ScanDirs(const std::vector<std::string>& scanDirs, bool do
 			ai.replaced = aii.first;
 		}
 	}
+
+	if (!doChecksum)
+		return;
+
+	// checksum every archive lacking one in a single go, so
+	// the files of different archives get hashed in parallel
+	std::vector<std::string> checksumNames;
+	std::vector<ArchiveInfo*> checksumInfos;
+
+	for (auto& aii: archiveInfos) {
+		ArchiveInfo& ai = aii.second;
+
+		if (!ai.updated || !ai.replaced.empty() || ai.checksum != 0)
+			continue;
+
+		checksumNames.push_back(ai.path + ai.origName);
+		checksumInfos.push_back(&ai);
+	}
+
+	std::vector<unsigned int> checksums;
+	GetCRCs(checksumNames, checksums);
+
+	for (size_t n = 0; n < checksumInfos.size(); n++) {
+		checksumInfos[n]->checksum = checksums[n];
+	}
 }
 
 
@@ -438,27 +484,54 @@ void CArchiveScanner::ScanDir(const std::string& curPath, std::list<std::string>
 	subDirs.push_back(curPath);
 
 	while (!subDirs.empty()) {
-		FileSystem::EnsurePathSepAtEnd(subDirs.front());
-		const std::vector<std::string>& found = dataDirsAccess.FindFiles(subDirs.front(), "*", FileQueryFlags::INCLUDE_DIRS);
+		const std::string dirPath = FileSystem::EnsureNoPathSepAtEnd(std::string(subDirs.front()));
 		subDirs.pop_front();
 
-		for (std::string fullName: found) {
-			FileSystem::EnsureNoPathSepAtEnd(fullName);
-			const std::string lcfpath = StringToLower(FileSystem::GetDirectory(fullName));
+		struct stat info = {0};
+		const bool statfailed = (stat(dirPath.c_str(), &info) != 0);
 
-			// Exclude archivefiles found inside directory archives (.sdd)
-			if (lcfpath.find(".sdd") != std::string::npos) {
-				continue;
-			}
+		DirInfo& di = dirInfos[dirPath];
+
+		// adding, removing or renaming entries changes the mtime of a
+		// directory, so its cached listing stays valid while that is the
+		// same (and was not modified within the second it was listed in)
+		const bool cached = (!statfailed && di.listed != 0 && (unsigned)info.st_mtime == di.modified && di.modified < di.listed);
+
+		if (!cached) {
+			di.archives.clear();
+			di.subDirs.clear();
+			di.modified = (statfailed)? 0: info.st_mtime;
+			di.listed = time(NULL);
 
-			// Is this an archive we should look into?
-			if (archiveLoader.IsArchiveFile(fullName)) {
-				foundArchives->push_front(fullName); // push by reversed order!
-			} else
-			if (FileSystem::DirExists(fullName)) {
-				subDirs.push_back(fullName);
+			const std::vector<std::string>& found = dataDirsAccess.FindFiles(FileSystem::EnsurePathSepAtEnd(std::string(dirPath)), "*", FileQueryFlags::INCLUDE_DIRS);
+
+			for (std::string fullName: found) {
+				FileSystem::EnsureNoPathSepAtEnd(fullName);
+				const std::string lcfpath = StringToLower(FileSystem::GetDirectory(fullName));
+
+				// Exclude archivefiles found inside directory archives (.sdd)
+				if (lcfpath.find(".sdd") != std::string::npos) {
+					continue;
+				}
+
+				// Is this an archive we should look into?
+				if (archiveLoader.IsArchiveFile(fullName)) {
+					di.archives.push_back(fullName);
+				} else
+				if (FileSystem::DirExists(fullName)) {
+					di.subDirs.push_back(fullName);
+				}
 			}
 		}
+
+		di.updated = true;
+
+		for (const std::string& archive: di.archives) {
+			foundArchives->push_front(archive); // push by reversed order!
+		}
+		for (const std::string& subDir: di.subDirs) {
+			subDirs.push_back(subDir);
+		}
 	}
 }
 
@@ -694,13 +767,20 @@ IFileFilter* CArchiveScanner::CreateIgnoreFilter(IArchive* ar)
 }
 
 
-/// used below
-struct CRCPair {
-	std::string* filename;
+/// one file to hash, used below
+struct CRCJob {
+	IArchive* archive;
+	std::string filename; ///< lower-case
+	unsigned int fid;
+	unsigned int size;
+	unsigned int modified;
 	unsigned int nameCRC;
 	unsigned int dataCRC;
+	bool cached;
 };
 
+/// bounds the number of archives GetCRCs keeps open at the same time
+static const size_t CRC_BATCH_SIZE = 32;
 
 
 /**
@@ -709,75 +789,142 @@ struct CRCPair {
  */
 unsigned int CArchiveScanner::GetCRC(const std::string& arcName)
 {
-	CRC crc;
-	std::list<std::string> files;
+	std::vector<std::string> arcNames(1, arcName);
+	std::vector<unsigned int> crcs;
 
-	// Try to open an archive
-	boost::scoped_ptr<IArchive> ar(archiveLoader.OpenArchive(arcName));
-	if (!ar) {
-		return 0; // It wasn't an archive
-	}
+	GetCRCs(arcNames, crcs);
+	return crcs[0];
+}
 
-	// Load ignore list.
-	boost::scoped_ptr<IFileFilter> ignore(CreateIgnoreFilter(ar.get()));
+void CArchiveScanner::GetCRCs(const std::vector<std::string>& arcNames, std::vector<unsigned int>& crcs)
+{
+	crcs.clear();
+	crcs.resize(arcNames.size(), 0);
 
-	// Insert all files to check in lowercase format
-	for (unsigned fid = 0; fid != ar->NumFiles(); ++fid) {
-		std::string name;
-		int size;
-		ar->FileInfo(fid, name, size);
+	// a file modified in the second it is hashed in could change
+	// again without changing its modification time, never cache it
+	const unsigned int scanTime = time(NULL);
 
-		if (ignore->Match(name)) {
-			continue;
+	for (size_t batchStart = 0; batchStart < arcNames.size(); batchStart += CRC_BATCH_SIZE) {
+		const size_t batchSize = std::min(CRC_BATCH_SIZE, arcNames.size() - batchStart);
+
+		std::vector< boost::shared_ptr<IArchive> > archives(batchSize);
+		std::vector<size_t> jobOffsets(batchSize + 1, 0);
+		std::vector<CRCJob> jobs;
+
+		for (size_t a = 0; a < batchSize; a++) {
+			const std::string lcArcName = StringToLower(FileSystem::GetFilename(arcNames[batchStart + a]));
+
+			jobOffsets[a] = jobs.size();
+
+			// Try to open an archive
+			archives[a].reset(archiveLoader.OpenArchive(arcNames[batchStart + a]));
+
+			IArchive* ar = archives[a].get();
+			if (ar == NULL) {
+				continue; // It wasn't an archive
+			}
+
+			// Load ignore list.
+			boost::scoped_ptr<IFileFilter> ignore(CreateIgnoreFilter(ar));
+
+			const std::map<std::string, std::map<std::string, FileCRC> >::const_iterator cachedIt = fileCRCs.find(lcArcName);
+
+			// Insert all files to check in lowercase format
+			for (unsigned fid = 0; fid != ar->NumFiles(); ++fid) {
+				std::string name;
+				int size;
+				ar->FileInfo(fid, name, size);
+
+				if (ignore->Match(name)) {
+					continue;
+				}
+
+				CRCJob job;
+				job.archive = ar;
+				job.filename = StringToLower(name); // case insensitive hash
+				job.fid = ar->FindFile(job.filename);
+				job.size = size;
+				job.modified = ar->GetFileModificationTime(job.fid);
+				job.nameCRC = 0;
+				job.dataCRC = 0;
+				job.cached = false;
+
+				if (job.modified != 0 && cachedIt != fileCRCs.end()) {
+					const std::map<std::string, FileCRC>::const_iterator fci = cachedIt->second.find(job.filename);
+
+					if (fci != cachedIt->second.end() && fci->second.size == job.size && fci->second.modified == job.modified) {
+						job.dataCRC = fci->second.crc;
+						job.cached = true;
+					}
+				}
+
+				jobs.push_back(job);
+			}
+
+			// Sort by FileName
+			std::sort(jobs.begin() + jobOffsets[a], jobs.end(), [](const CRCJob& j1, const CRCJob& j2) { return (j1.filename < j2.filename); });
 		}
 
-		StringToLowerInPlace(name); // case insensitive hash
-		files.push_back(name);
-	}
-
-	// Sort by FileName
-	files.sort();
-
-	// Push the filenames into a std::vector, cause OMP can better iterate over those
-	std::vector<CRCPair> crcs;
-	crcs.reserve(files.size());
-	CRCPair crcp;
-	for (std::string& f: files) {
-		crcp.filename = &f;
-		crcs.push_back(crcp);
-	}
-
-	// Compute CRCs of the files
-	// Hint: Multithreading only speedups `.sdd` loading. For those the CRC generation is extremely slow -
-	//       it has to load the full file to calc it! For the other formats (sd7, sdz, sdp) the CRC is saved
-	//       in the metainformation of the container and so the loading is much faster. Neither does any of our
-	//       current (2011) packing libraries support multithreading :/
-	for_mt(0, crcs.size(), [&](const int i) {
-		CRCPair& crcp = crcs[i];
-		const unsigned int nameCRC = CRC::GetCRC(crcp.filename->data(), crcp.filename->size());
-		const unsigned fid = ar->FindFile(*crcp.filename);
-		const unsigned int dataCRC = ar->GetCrc32(fid);
-		crcp.nameCRC = nameCRC;
-		crcp.dataCRC = dataCRC;
-	#if !defined(DEDICATED) && !defined(UNITSYNC)
-		Watchdog::ClearTimer(WDT_MAIN);
-	#endif
-	});
+		jobOffsets[batchSize] = jobs.size();
 
-	// Add file CRCs to the main archive CRC
-	for (CRCPair& crcp: crcs) {
-		crc.Update(crcp.nameCRC);
-		crc.Update(crcp.dataCRC);
-	#if !defined(DEDICATED) && !defined(UNITSYNC)
-		Watchdog::ClearTimer();
-	#endif
-	}
+		// Compute CRCs of the files of all archives in the batch
+		// Hint: For `.sdd` archives the CRC generation is extremely slow - it has to load the full file
+		//       to calc it, which is what the per-file cache avoids. For the other formats (sd7, sdz, sdp)
+		//       the CRC is saved in the metainformation of the container and so the loading is much faster.
+		for_mt(0, jobs.size(), [&](const int i) {
+			CRCJob& job = jobs[i];
+			job.nameCRC = CRC::GetCRC(job.filename.data(), job.filename.size());
+
+			if (!job.cached) {
+				job.dataCRC = job.archive->GetCrc32(job.fid);
+			}
+		#if !defined(DEDICATED) && !defined(UNITSYNC)
+			Watchdog::ClearTimer(WDT_MAIN);
+		#endif
+		});
+
+		// Add file CRCs to the main archive CRCs
+		for (size_t a = 0; a < batchSize; a++) {
+			if (archives[a] == NULL) {
+				continue;
+			}
+
+			const std::string lcArcName = StringToLower(FileSystem::GetFilename(arcNames[batchStart + a]));
+			std::map<std::string, FileCRC>& archiveCRCs = fileCRCs[lcArcName];
 
-	// A value of 0 is used to indicate no crc.. so never return that
-	// Shouldn't happen all that often
-	unsigned int digest = crc.GetDigest();
-	if (digest == 0) digest = 4711;
-	return digest;
+			CRC crc;
+			archiveCRCs.clear();
+
+			for (size_t j = jobOffsets[a]; j < jobOffsets[a + 1]; j++) {
+				const CRCJob& job = jobs[j];
+
+				crc.Update(job.nameCRC);
+				crc.Update(job.dataCRC);
+
+				if (job.modified != 0 && job.modified < scanTime) {
+					FileCRC& fc = archiveCRCs[job.filename];
+					fc.size = job.size;
+					fc.modified = job.modified;
+					fc.crc = job.dataCRC;
+				}
+			}
+
+			if (archiveCRCs.empty()) {
+				fileCRCs.erase(lcArcName);
+			}
+
+			// A value of 0 is used to indicate no crc.. so never return that
+			// Shouldn't happen all that often
+			unsigned int digest = crc.GetDigest();
+			if (digest == 0) digest = 4711;
+			crcs[batchStart + a] = digest;
+
+		#if !defined(DEDICATED) && !defined(UNITSYNC)
+			Watchdog::ClearTimer();
+		#endif
+		}
+	}
 }
 
 void CArchiveScanner::ReadCacheData(const std::string& filename)
@@ -841,22 +988,215 @@ void CArchiveScanner::ReadCacheData(const std::string& filename)
 	isDirty = false;
 }
 
-static inline void SafeStr(FILE* out, const char* prefix, const std::string& str)
+namespace {
+	class CacheWriter
+	{
+	public:
+		void PutByte(boost::uint8_t v) { buf.push_back(v); }
+		void PutInt(boost::uint32_t v) { PutRaw(&v, sizeof(v)); }
+		void PutFloat(float v) { PutRaw(&v, sizeof(v)); }
+		void PutString(const std::string& str) {
+			PutInt(str.size());
+			PutRaw(str.data(), str.size());
+		}
+		void PutStrings(const std::vector<std::string>& strs) {
+			PutInt(strs.size());
+			for (const std::string& str: strs) {
+				PutString(str);
+			}
+		}
+
+		const std::vector<boost::uint8_t>& GetBuffer() const { return buf; }
+
+	private:
+		void PutRaw(const void* data, size_t size) {
+			const boost::uint8_t* bytes = reinterpret_cast<const boost::uint8_t*>(data);
+			buf.insert(buf.end(), bytes, bytes + size);
+		}
+
+	private:
+		std::vector<boost::uint8_t> buf;
+	};
+
+	/// bounds-checked reader, every Get after an overrun returns 0 / empty
+	class CacheReader
+	{
+	public:
+		CacheReader(const boost::uint8_t* data, size_t size)
+			: cur(data)
+			, end(data + size)
+			, failed(false)
+		{}
+
+		bool Failed() const { return failed; }
+
+		boost::uint8_t GetByte() {
+			boost::uint8_t v = 0;
+			GetRaw(&v, sizeof(v));
+			return v;
+		}
+		boost::uint32_t GetInt() {
+			boost::uint32_t v = 0;
+			GetRaw(&v, sizeof(v));
+			return v;
+		}
+		float GetFloat() {
+			float v = 0.0f;
+			GetRaw(&v, sizeof(v));
+			return v;
+		}
+		std::string GetString() {
+			const boost::uint32_t size = GetInt();
+
+			if (failed || size > size_t(end - cur)) {
+				failed = true;
+				return "";
+			}
+
+			const std::string str(reinterpret_cast<const char*>(cur), size);
+			cur += size;
+			return str;
+		}
+		void GetStrings(std::vector<std::string>& strs) {
+			const boost::uint32_t count = GetInt();
+
+			for (boost::uint32_t n = 0; n < count && !failed; n++) {
+				strs.push_back(GetString());
+			}
+		}
+
+	private:
+		void GetRaw(void* data, size_t size) {
+			if (failed || size > size_t(end - cur)) {
+				failed = true;
+				return;
+			}
+
+			memcpy(data, cur, size);
+			cur += size;
+		}
+
+	private:
+		const boost::uint8_t* cur;
+		const boost::uint8_t* end;
+		bool failed;
+	};
+}
+
+
+bool CArchiveScanner::ReadBinaryCacheData(const std::string& filename)
 {
-	if (str.empty()) {
-		return;
+	FILE* in = fopen(filename.c_str(), "rb");
+	if (in == NULL) {
+		LOG_L(L_INFO, "Archive cache doesn't exist: %s", filename.c_str());
+		return false;
 	}
-	if ( (str.find_first_of("\\\"") != std::string::npos) || (str.find_first_of("\n") != std::string::npos )) {
-		fprintf(out, "%s[[%s]],\n", prefix, str.c_str());
-	} else {
-		fprintf(out, "%s\"%s\",\n", prefix, str.c_str());
+
+	std::vector<boost::uint8_t> data;
+
+	boost::uint8_t header[16] = {0};
+	if (fread(header, sizeof(header), 1, in) == 1) {
+		boost::uint32_t version = 0;
+		boost::uint32_t payloadSize = 0;
+		memcpy(&version, &header[4], sizeof(version));
+		memcpy(&payloadSize, &header[8], sizeof(payloadSize));
+
+		// Do not load caches of other versions
+		if (memcmp(header, BINARY_CACHE_MAGIC, sizeof(BINARY_CACHE_MAGIC)) == 0 && version == BINARY_CACHE_VER) {
+			data.resize(payloadSize);
+
+			if (payloadSize > 0 && fread(&data[0], payloadSize, 1, in) != 1) {
+				data.clear();
+			}
+		}
 	}
-}
 
-void FilterDep(std::vector<std::string>& deps, const std::string& exclude)
-{
-	auto it = std::remove_if(deps.begin(), deps.end(), [&](const std::string& dep) { return (dep == exclude); });
-	deps.erase(it, deps.end());
+	fclose(in);
+
+	boost::uint32_t payloadCRC = 0;
+	memcpy(&payloadCRC, &header[12], sizeof(payloadCRC));
+
+	if (data.empty() || CRC::GetCRC(&data[0], data.size()) != payloadCRC) {
+		LOG_L(L_WARNING, "Ignoring outdated or damaged archive cache: %s", filename.c_str());
+		return false;
+	}
+
+	CacheReader reader(&data[0], data.size());
+
+	const boost::uint32_t numArchives = reader.GetInt();
+	for (boost::uint32_t i = 0; i < numArchives && !reader.Failed(); i++) {
+		const std::string name = reader.GetString();
+
+		ArchiveInfo& ai = archiveInfos[StringToLower(name)];
+		ai.origName = name;
+		ai.path     = reader.GetString();
+		ai.replaced = reader.GetString();
+		ai.modified = reader.GetInt();
+		ai.checksum = reader.GetInt();
+		ai.updated  = false;
+
+		ArchiveData& ad = ai.archiveData;
+
+		const boost::uint32_t numInfoItems = reader.GetInt();
+		for (boost::uint32_t n = 0; n < numInfoItems && !reader.Failed(); n++) {
+			const std::string key = reader.GetString();
+
+			switch (reader.GetByte()) {
+				case INFO_VALUE_TYPE_STRING:  { ad.SetInfoItemValueString(key, reader.GetString()); } break;
+				case INFO_VALUE_TYPE_INTEGER: { ad.SetInfoItemValueInteger(key, reader.GetInt()); } break;
+				case INFO_VALUE_TYPE_FLOAT:   { ad.SetInfoItemValueFloat(key, reader.GetFloat()); } break;
+				case INFO_VALUE_TYPE_BOOL:    { ad.SetInfoItemValueBool(key, reader.GetByte() != 0); } break;
+			}
+		}
+
+		reader.GetStrings(ad.GetDependencies());
+		reader.GetStrings(ad.GetReplaces());
+	}
+
+	const boost::uint32_t numBroken = reader.GetInt();
+	for (boost::uint32_t i = 0; i < numBroken && !reader.Failed(); i++) {
+		BrokenArchive& ba = brokenArchives[reader.GetString()];
+		ba.path = reader.GetString();
+		ba.modified = reader.GetInt();
+		ba.updated = false;
+		ba.problem = reader.GetString();
+	}
+
+	const boost::uint32_t numDirs = reader.GetInt();
+	for (boost::uint32_t i = 0; i < numDirs && !reader.Failed(); i++) {
+		DirInfo& di = dirInfos[reader.GetString()];
+		di.modified = reader.GetInt();
+		di.listed = reader.GetInt();
+		di.updated = false;
+		reader.GetStrings(di.archives);
+		reader.GetStrings(di.subDirs);
+	}
+
+	const boost::uint32_t numCRCArchives = reader.GetInt();
+	for (boost::uint32_t i = 0; i < numCRCArchives && !reader.Failed(); i++) {
+		std::map<std::string, FileCRC>& archiveCRCs = fileCRCs[reader.GetString()];
+
+		const boost::uint32_t numFiles = reader.GetInt();
+		for (boost::uint32_t n = 0; n < numFiles && !reader.Failed(); n++) {
+			FileCRC& fc = archiveCRCs[reader.GetString()];
+			fc.size = reader.GetInt();
+			fc.modified = reader.GetInt();
+			fc.crc = reader.GetInt();
+		}
+	}
+
+	if (reader.Failed()) {
+		LOG_L(L_WARNING, "Ignoring damaged archive cache: %s", filename.c_str());
+
+		archiveInfos.clear();
+		brokenArchives.clear();
+		dirInfos.clear();
+		fileCRCs.clear();
+		return false;
+	}
+
+	isDirty = false;
+	return true;
 }
 
 void CArchiveScanner::WriteCacheData(const std::string& filename)
@@ -865,12 +1205,6 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 		return;
 	}
 
-	FILE* out = fopen(filename.c_str(), "wt");
-	if (!out) {
-		LOG_L(L_ERROR, "Failed to write to \"%s\"!", filename.c_str());
-		return;
-	}
-
 	// First delete all outdated information
 	// TODO: this pattern should be moved into an utility function..
 	for (std::map<std::string, ArchiveInfo>::iterator i = archiveInfos.begin(); i != archiveInfos.end(); ) {
@@ -887,88 +1221,97 @@ void CArchiveScanner::WriteCacheData(const std::string& filename)
 			++i;
 		}
 	}
+	for (std::map<std::string, DirInfo>::iterator i = dirInfos.begin(); i != dirInfos.end(); ) {
+		if (!i->second.updated) {
+			i = set_erase(dirInfos, i);
+		} else {
+			++i;
+		}
+	}
+	for (std::map<std::string, std::map<std::string, FileCRC> >::iterator i = fileCRCs.begin(); i != fileCRCs.end(); ) {
+		if (archiveInfos.find(i->first) == archiveInfos.end()) {
+			i = set_erase(fileCRCs, i);
+		} else {
+			++i;
+		}
+	}
 
-	fprintf(out, "local archiveCache = {\n\n");
-	fprintf(out, "\tinternalver = %i,\n\n", INTERNAL_VER);
-	fprintf(out, "\tarchives = {  -- count = " _STPF_ "\n", archiveInfos.size());
+	CacheWriter writer;
 
-	std::map<std::string, ArchiveInfo>::const_iterator arcIt;
-	for (arcIt = archiveInfos.begin(); arcIt != archiveInfos.end(); ++arcIt) {
+	writer.PutInt(archiveInfos.size());
+	for (std::map<std::string, ArchiveInfo>::const_iterator arcIt = archiveInfos.begin(); arcIt != archiveInfos.end(); ++arcIt) {
 		const ArchiveInfo& arcInfo = arcIt->second;
-
-		fprintf(out, "\t\t{\n");
-		SafeStr(out, "\t\t\tname = ",              arcInfo.origName);
-		SafeStr(out, "\t\t\tpath = ",              arcInfo.path);
-		fprintf(out, "\t\t\tmodified = \"%u\",\n", arcInfo.modified);
-		fprintf(out, "\t\t\tchecksum = \"%u\",\n", arcInfo.checksum);
-		SafeStr(out, "\t\t\treplaced = ",          arcInfo.replaced);
-
-		// mod info?
 		const ArchiveData& archData = arcInfo.archiveData;
-		if (!archData.GetName().empty()) {
-			fprintf(out, "\t\t\tarchivedata = {\n");
-
-			const std::map<std::string, InfoItem>& info = archData.GetInfo();
-			std::map<std::string, InfoItem>::const_iterator ii;
-			for (ii = info.begin(); ii != info.end(); ++ii) {
-				switch (ii->second.valueType) {
-					case INFO_VALUE_TYPE_STRING: {
-						SafeStr(out, std::string("\t\t\t\t" + ii->first + " = ").c_str(), ii->second.valueTypeString);
-					} break;
-					case INFO_VALUE_TYPE_INTEGER: {
-						fprintf(out, "\t\t\t\t%s = %d,\n", ii->first.c_str(), ii->second.value.typeInteger);
-					} break;
-					case INFO_VALUE_TYPE_FLOAT: {
-						fprintf(out, "\t\t\t\t%s = %f,\n", ii->first.c_str(), ii->second.value.typeFloat);
-					} break;
-					case INFO_VALUE_TYPE_BOOL: {
-						fprintf(out, "\t\t\t\t%s = %d,\n", ii->first.c_str(), (int)ii->second.value.typeBool);
-					} break;
-				}
+		const std::map<std::string, InfoItem>& info = archData.GetInfo();
+
+		writer.PutString(arcInfo.origName);
+		writer.PutString(arcInfo.path);
+		writer.PutString(arcInfo.replaced);
+		writer.PutInt(arcInfo.modified);
+		writer.PutInt(arcInfo.checksum);
+
+		writer.PutInt(info.size());
+		for (std::map<std::string, InfoItem>::const_iterator ii = info.begin(); ii != info.end(); ++ii) {
+			writer.PutString(ii->second.key);
+			writer.PutByte(ii->second.valueType);
+
+			switch (ii->second.valueType) {
+				case INFO_VALUE_TYPE_STRING:  { writer.PutString(ii->second.valueTypeString); } break;
+				case INFO_VALUE_TYPE_INTEGER: { writer.PutInt(ii->second.value.typeInteger); } break;
+				case INFO_VALUE_TYPE_FLOAT:   { writer.PutFloat(ii->second.value.typeFloat); } break;
+				case INFO_VALUE_TYPE_BOOL:    { writer.PutByte(ii->second.value.typeBool); } break;
 			}
-
-			std::vector<std::string> deps = archData.GetDependencies();
-			if (archData.GetModType() == modtype::map) {
-				FilterDep(deps, "Map Helper v1");
-			} else if (archData.GetModType() == modtype::primary) {
-				FilterDep(deps, "Spring content v1");
-			}
-
-			if (!deps.empty()) {
-				fprintf(out, "\t\t\t\tdepend = {\n");
-				for (unsigned d = 0; d < deps.size(); d++) {
-					SafeStr(out, "\t\t\t\t\t", deps[d]);
-				}
-				fprintf(out, "\t\t\t\t},\n");
-			}
-			fprintf(out, "\t\t\t},\n");
 		}
 
-		fprintf(out, "\t\t},\n");
+		writer.PutStrings(archData.GetDependencies());
+		writer.PutStrings(archData.GetReplaces());
 	}
 
-	fprintf(out, "\t},\n\n"); // close 'archives'
+	writer.PutInt(brokenArchives.size());
+	for (std::map<std::string, BrokenArchive>::const_iterator bai = brokenArchives.begin(); bai != brokenArchives.end(); ++bai) {
+		writer.PutString(bai->first);
+		writer.PutString(bai->second.path);
+		writer.PutInt(bai->second.modified);
+		writer.PutString(bai->second.problem);
+	}
 
-	fprintf(out, "\tbrokenArchives = {  -- count = " _STPF_ "\n", brokenArchives.size());
+	writer.PutInt(dirInfos.size());
+	for (std::map<std::string, DirInfo>::const_iterator dii = dirInfos.begin(); dii != dirInfos.end(); ++dii) {
+		writer.PutString(dii->first);
+		writer.PutInt(dii->second.modified);
+		writer.PutInt(dii->second.listed);
+		writer.PutStrings(dii->second.archives);
+		writer.PutStrings(dii->second.subDirs);
+	}
 
-	std::map<std::string, BrokenArchive>::const_iterator bai;
-	for (bai = brokenArchives.begin(); bai != brokenArchives.end(); ++bai) {
-		const BrokenArchive& ba = bai->second;
+	writer.PutInt(fileCRCs.size());
+	for (std::map<std::string, std::map<std::string, FileCRC> >::const_iterator aci = fileCRCs.begin(); aci != fileCRCs.end(); ++aci) {
+		writer.PutString(aci->first);
+		writer.PutInt(aci->second.size());
 
-		fprintf(out, "\t\t{\n");
-		SafeStr(out, "\t\t\tname = ", bai->first);
-		SafeStr(out, "\t\t\tpath = ", ba.path);
-		fprintf(out, "\t\t\tmodified = \"%u\",\n", ba.modified);
-		SafeStr(out, "\t\t\tproblem = ", ba.problem);
-		fprintf(out, "\t\t},\n");
+		for (std::map<std::string, FileCRC>::const_iterator fci = aci->second.begin(); fci != aci->second.end(); ++fci) {
+			writer.PutString(fci->first);
+			writer.PutInt(fci->second.size);
+			writer.PutInt(fci->second.modified);
+			writer.PutInt(fci->second.crc);
+		}
 	}
 
-	fprintf(out, "\t},\n"); // close 'brokenArchives'
+	const std::vector<boost::uint8_t>& payload = writer.GetBuffer();
+	const boost::uint32_t header[3] = {BINARY_CACHE_VER, boost::uint32_t(payload.size()), CRC::GetCRC(&payload[0], payload.size())};
+
+	FILE* out = fopen(filename.c_str(), "wb");
+	if (!out) {
+		LOG_L(L_ERROR, "Failed to write to \"%s\"!", filename.c_str());
+		return;
+	}
 
-	fprintf(out, "}\n\n"); // close 'archiveCache'
-	fprintf(out, "return archiveCache\n");
+	bool written = true;
+	written = written && (fwrite(BINARY_CACHE_MAGIC, sizeof(BINARY_CACHE_MAGIC), 1, out) == 1);
+	written = written && (fwrite(header, sizeof(header), 1, out) == 1);
+	written = written && (fwrite(&payload[0], payload.size(), 1, out) == 1);
 
-	if (fclose(out) == EOF)
+	if ((fclose(out) == EOF) || !written)
 		LOG_L(L_ERROR, "Failed to write to \"%s\"!", filename.c_str());
 
 	isDirty = false;
@@ -154,6 +154,32 @@ private:
 		bool updated;
 		std::string problem;
 	};
+	/// cached listing of a scanned directory, valid as long as its mtime is unchanged
+	struct DirInfo
+	{
+		DirInfo()
+			: modified(0)
+			, listed(0)
+			, updated(false)
+			{}
+		std::vector<std::string> archives;
+		std::vector<std::string> subDirs;
+		unsigned int modified;
+		unsigned int listed;      ///< time the listing was made at
+		bool updated;
+	};
+	/// cached CRC of a file inside an archive, see IArchive::GetFileModificationTime
+	struct FileCRC
+	{
+		FileCRC()
+			: size(0)
+			, modified(0)
+			, crc(0)
+			{}
+		unsigned int size;
+		unsigned int modified;
+		unsigned int crc;
+	};
 
 private:
 	void ScanDirs(const std::vector<std::string>& dirs, bool checksum = false);
@@ -169,7 +195,9 @@ private:
 	std::string SearchMapFile(const IArchive* ar, std::string& error);
 
 
+	/// reads the legacy ArchiveCache.lua format, only used to migrate it
 	void ReadCacheData(const std::string& filename);
+	bool ReadBinaryCacheData(const std::string& filename);
 	void WriteCacheData(const std::string& filename);
 
 	IFileFilter* CreateIgnoreFilter(IArchive* ar);
@@ -179,6 +207,11 @@ private:
 	 * Returns 0 if file could not be opened.
 	 */
 	unsigned int GetCRC(const std::string& filename);
+	/**
+	 * Like GetCRC, for many archives at once; the files of all
+	 * archives of a batch are hashed in parallel.
+	 */
+	void GetCRCs(const std::vector<std::string>& filenames, std::vector<unsigned int>& crcs);
 
 	/**
 	 * Returns a value > 0 if the file is rated as a meta-file.
@@ -204,6 +237,9 @@ private:
 private:
 	std::map<std::string, ArchiveInfo> archiveInfos;
 	std::map<std::string, BrokenArchive> brokenArchives;
+	std::map<std::string, DirInfo> dirInfos;
+	/// lower-case archive filename -> lower-case file path -> CRC
+	std::map<std::string, std::map<std::string, FileCRC> > fileCRCs;
 
 	bool isDirty;
 	std::string cachefile;
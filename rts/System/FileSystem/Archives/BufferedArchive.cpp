@@ -23,15 +23,41 @@ bool CBufferedArchive::GetFile(unsigned int fid, std::vector<boost::uint8_t>& bu
 		return GetFileImpl(fid,buffer);
 	}
 
+	CFileView view;
+	const bool exists = GetCachedFileView(fid, view);
+
+	view.CopyTo(buffer);
+	return exists;
+}
+
+bool CBufferedArchive::GetFileView(unsigned int fid, CFileView& view)
+{
+	boost::mutex::scoped_lock lck(archiveLock);
+	assert(IsFileId(fid));
+
+	return GetCachedFileView(fid, view);
+}
+
+bool CBufferedArchive::GetCachedFileView(unsigned int fid, CFileView& view)
+{
+	if (!caching) {
+		boost::shared_ptr< std::vector<boost::uint8_t> > buffer(new std::vector<boost::uint8_t>());
+		const bool exists = GetFileImpl(fid, *buffer);
+
+		view = CFileView(buffer);
+		return exists;
+	}
+
 	if (fid >= cache.size()) {
 		cache.resize(fid + 1);
 	}
-	
+
 	if (!cache[fid].populated) {
-		cache[fid].exists = GetFileImpl(fid, cache[fid].data);
+		cache[fid].data.reset(new std::vector<boost::uint8_t>());
+		cache[fid].exists = GetFileImpl(fid, *cache[fid].data);
 		cache[fid].populated = true;
 	}
 
-	buffer = cache[fid].data;
+	view = CFileView(cache[fid].data);
 	return cache[fid].exists;
 }
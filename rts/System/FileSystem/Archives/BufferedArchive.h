@@ -4,6 +4,7 @@
 #define _BUFFERED_ARCHIVE_H
 
 #include <map>
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 
 #include "IArchive.h"
@@ -19,9 +20,13 @@ public:
 	virtual ~CBufferedArchive();
 
 	virtual bool GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer);
+	/// shares the cached buffer instead of copying it
+	virtual bool GetFileView(unsigned int fid, CFileView& view);
 
 protected:
 	virtual bool GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buffer) = 0;
+	/// GetFileView without locking <archiveLock>
+	bool GetCachedFileView(unsigned int fid, CFileView& view);
 
 	boost::mutex archiveLock; // neither 7zip nor zlib are threadsafe
 	struct FileBuffer
@@ -29,7 +34,8 @@ protected:
 		FileBuffer() : populated(false), exists(false) {};
 		bool populated; // cause a file may be 0 bytes big
 		bool exists;
-		std::vector<boost::uint8_t> data;
+		// shared with the views handed out by GetFileView
+		boost::shared_ptr< std::vector<boost::uint8_t> > data;
 	};
 	std::vector<FileBuffer> cache; // cache[fileId]
 private:
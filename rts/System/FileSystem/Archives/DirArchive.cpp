@@ -5,6 +5,8 @@
 
 #include <assert.h>
 #include <fstream>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileSystem.h"
@@ -77,6 +79,14 @@ bool CDirArchive::GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer)
 	}
 }
 
+bool CDirArchive::GetFileView(unsigned int fid, CFileView& view)
+{
+	assert(IsFileId(fid));
+
+	const std::string rawpath = dataDirsAccess.LocateFile(dirName + searchFiles[fid]);
+	return CFileView::MapFile(rawpath, view);
+}
+
 void CDirArchive::FileInfo(unsigned int fid, std::string& name, int& size) const
 {
 	assert(IsFileId(fid));
@@ -91,3 +101,17 @@ void CDirArchive::FileInfo(unsigned int fid, std::string& name, int& size) const
 		size = 0;
 	}
 }
+
+unsigned int CDirArchive::GetFileModificationTime(unsigned int fid) const
+{
+	assert(IsFileId(fid));
+
+	const std::string rawPath = dataDirsAccess.LocateFile(dirName + searchFiles[fid]);
+
+	struct stat info;
+	if (stat(rawPath.c_str(), &info) != 0) {
+		return 0;
+	}
+
+	return info.st_mtime;
+}
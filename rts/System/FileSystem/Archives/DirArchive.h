@@ -36,7 +36,10 @@ public:
 	
 	virtual unsigned int NumFiles() const;
 	virtual bool GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer);
+	/// memory-maps the file
+	virtual bool GetFileView(unsigned int fid, CFileView& view);
 	virtual void FileInfo(unsigned int fid, std::string& name, int& size) const;
+	virtual unsigned int GetFileModificationTime(unsigned int fid) const;
 	
 private:
 	/// "ExampleArchive.sdd/"
@@ -0,0 +1,104 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "FileView.h"
+
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+
+CMappedFile::CMappedFile(const std::string& filePath)
+	: data(NULL)
+	, size(0)
+	, isOpen(false)
+#ifdef WIN32
+	, fileHandle(INVALID_HANDLE_VALUE)
+	, mappingHandle(NULL)
+#endif
+{
+#ifdef WIN32
+	fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+		return;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize))
+		return;
+
+	size = fileSize.QuadPart;
+	isOpen = (size == 0);
+
+	if (isOpen)
+		return;
+
+	mappingHandle = CreateFileMapping(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+	if (mappingHandle == NULL)
+		return;
+
+	data = static_cast<const boost::uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+	isOpen = (data != NULL);
+#else
+	const int fd = open(filePath.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+		close(fd);
+		return;
+	}
+
+	size = info.st_size;
+	isOpen = (size == 0);
+
+	if (!isOpen) {
+		void* mem = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (mem != MAP_FAILED) {
+			data = static_cast<const boost::uint8_t*>(mem);
+			isOpen = true;
+		}
+	}
+
+	// the mapping stays valid after closing the descriptor
+	close(fd);
+#endif
+
+	if (!isOpen)
+		size = 0;
+}
+
+CMappedFile::~CMappedFile()
+{
+#ifdef WIN32
+	if (data != NULL)
+		UnmapViewOfFile(data);
+	if (mappingHandle != NULL)
+		CloseHandle(mappingHandle);
+	if (fileHandle != INVALID_HANDLE_VALUE)
+		CloseHandle(fileHandle);
+#else
+	if (data != NULL)
+		munmap(const_cast<boost::uint8_t*>(data), size);
+#endif
+}
+
+
+bool CFileView::MapFile(const std::string& filePath, CFileView& view)
+{
+	boost::shared_ptr<const CMappedFile> file(new CMappedFile(filePath));
+
+	if (!file->IsOpen())
+		return false;
+
+	view = CFileView(file, 0, file->GetSize());
+	return true;
+}
@@ -0,0 +1,90 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _FILE_VIEW_H
+#define _FILE_VIEW_H
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+
+/**
+ * Read-only memory mapping of a whole file.
+ * A file of size zero is open, but has no data.
+ */
+class CMappedFile : boost::noncopyable
+{
+public:
+	CMappedFile(const std::string& filePath);
+	~CMappedFile();
+
+	bool IsOpen() const { return isOpen; }
+
+	const boost::uint8_t* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+
+private:
+	const boost::uint8_t* data;
+	size_t size;
+	bool isOpen;
+
+#ifdef WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#endif
+};
+
+
+/**
+ * Read-only view of the contents of a file, pointing either into a
+ * memory-mapped file or into a buffer. The view shares ownership of
+ * the memory it points into, so copying it does not copy the data.
+ */
+class CFileView
+{
+public:
+	CFileView()
+		: data(NULL)
+		, size(0)
+	{}
+
+	/// view of a whole buffer
+	CFileView(boost::shared_ptr<const std::vector<boost::uint8_t> > buffer)
+		: owner(buffer)
+		, data(buffer->empty()? NULL: &(*buffer)[0])
+		, size(buffer->size())
+	{}
+
+	/// view of <length> bytes at <offset> in a buffer
+	CFileView(boost::shared_ptr<const std::vector<boost::uint8_t> > buffer, size_t offset, size_t length)
+		: owner(buffer)
+		, data((length == 0)? NULL: &(*buffer)[offset])
+		, size(length)
+	{}
+
+	/// view of <length> bytes at <offset> in a mapped file
+	CFileView(boost::shared_ptr<const CMappedFile> file, size_t offset, size_t length)
+		: owner(file)
+		, data(file->GetData() + offset)
+		, size(length)
+	{}
+
+	/// maps the file at <filePath>, returns false if that fails
+	static bool MapFile(const std::string& filePath, CFileView& view);
+
+	const boost::uint8_t* GetData() const { return data; }
+	size_t GetSize() const { return size; }
+	bool Empty() const { return (size == 0); }
+
+	void CopyTo(std::vector<boost::uint8_t>& buffer) const { buffer.assign(data, data + size); }
+
+private:
+	boost::shared_ptr<const void> owner;
+
+	const boost::uint8_t* data;
+	size_t size;
+};
+
+#endif // _FILE_VIEW_H
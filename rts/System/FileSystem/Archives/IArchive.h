@@ -8,6 +8,8 @@
 #include <map>
 #include <boost/cstdint.hpp>
 
+#include "FileView.h"
+
 /**
  * @brief Abstraction of different archive types
  *
@@ -72,6 +74,19 @@ public:
 	 * @see GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer)
 	 */
 	bool GetFile(const std::string& name, std::vector<boost::uint8_t>& buffer);
+	/**
+	 * Fetches a read-only view of the content of a file by its ID.
+	 * Archives that can expose the data without copying it (from a
+	 * memory-mapped file or their own cache) override this; the default
+	 * implementation reads the file via GetFile.
+	 * @see GetFile(unsigned int fid, std::vector<boost::uint8_t>& buffer)
+	 */
+	virtual bool GetFileView(unsigned int fid, CFileView& view);
+	/**
+	 * Fetches a read-only view of the content of a file by its name.
+	 * @see GetFileView(unsigned int fid, CFileView& view)
+	 */
+	bool GetFileView(const std::string& name, CFileView& view);
 	/**
 	 * Fetches the name and size in bytes of a file by its ID.
 	 */
@@ -97,6 +112,19 @@ public:
 	 * Fetches the CRC32 hash of a file by its ID.
 	 */
 	virtual unsigned int GetCrc32(unsigned int fid);
+	/**
+	 * Fetches the modification time of a file by its ID, 0 if unknown.
+	 * Only archives which have to read the whole file in GetCrc32 report
+	 * it, the CRC can then be cached for as long as name, size and
+	 * modification time of the file stay the same.
+	 */
+	virtual unsigned int GetFileModificationTime(unsigned int fid) const { return 0; }
+	/**
+	 * Unpacks the contents ahead of use, for formats where reading single
+	 * files is expensive (solid archives); meant to be called while loading.
+	 * Most implementations do nothing.
+	 */
+	virtual void DecompressAhead() {}
 
 
 protected:
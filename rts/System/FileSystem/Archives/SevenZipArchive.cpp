@@ -3,7 +3,10 @@
 #include "SevenZipArchive.h"
 
 #include <algorithm>
+#include <list>
+#include <map>
 #include <boost/system/error_code.hpp>
+#include <boost/thread/mutex.hpp>
 #include <stdexcept>
 #include <string.h> //memcpy
 
@@ -13,9 +16,146 @@ extern "C" {
 #include "lib/7z/7zCrc.h"
 }
 
+#include "FileView.h"
+#include "System/ThreadPool.h"
+#include "System/Misc/SpringTime.h"
 #include "System/Util.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
 
+CONFIG(int, SevenZipBlockCacheSize).defaultValue(128).minimumValue(0)
+	.description("Maximum size in MB of decompressed solid blocks of 7zip archives (.sd7) kept in memory.");
+CONFIG(bool, SevenZipDecompressAhead).defaultValue(true)
+	.description("Decompress the solid blocks of 7zip archives (.sd7) on all cores while loading a game, as far as they fit into SevenZipBlockCacheSize.");
+
+
+namespace {
+
+/**
+ * LRU cache of the decompressed solid blocks of all open 7zip archives.
+ * The least recently used blocks are dropped when the total size exceeds
+ * SevenZipBlockCacheSize, except for the block each archive used last and
+ * blocks still referenced by file-views. Like the old one-block-per-archive
+ * cache this keeps interleaved reads from several archives from decoding
+ * the same large blocks over and over.
+ */
+class CSevenZipBlockCache
+{
+public:
+	typedef boost::shared_ptr<const std::vector<boost::uint8_t> > Block;
+
+	CSevenZipBlockCache()
+		: budget(size_t(configHandler->GetInt("SevenZipBlockCacheSize")) * 1024 * 1024)
+		, totalSize(0)
+	{}
+
+	Block Get(const void* archive, unsigned int folderIndex)
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		const BlockIndex::iterator it = index.find(BlockKey(archive, folderIndex));
+
+		if (it == index.end())
+			return Block();
+
+		// move to the front of the LRU list
+		blocks.splice(blocks.begin(), blocks, it->second);
+		lastBlocks[archive] = folderIndex;
+		return it->second->second;
+	}
+
+	bool Contains(const void* archive, unsigned int folderIndex)
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		return (index.find(BlockKey(archive, folderIndex)) != index.end());
+	}
+
+	void Insert(const void* archive, unsigned int folderIndex, const Block& block)
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		const BlockKey key(archive, folderIndex);
+
+		if (index.find(key) != index.end())
+			return;
+
+		blocks.push_front(std::make_pair(key, block));
+		index[key] = blocks.begin();
+		lastBlocks[archive] = folderIndex;
+		totalSize += block->size();
+
+		for (BlockList::iterator it = blocks.end(); it != blocks.begin() && totalSize > budget; ) {
+			--it;
+
+			if (!CanEvict(*it))
+				continue;
+
+			totalSize -= it->second->size();
+			index.erase(it->first);
+			it = blocks.erase(it);
+		}
+	}
+
+	/// drops all blocks of <archive>
+	void Remove(const void* archive)
+	{
+		boost::mutex::scoped_lock lock(mutex);
+
+		for (BlockList::iterator it = blocks.begin(); it != blocks.end(); ) {
+			if (it->first.first != archive) {
+				++it; continue;
+			}
+
+			totalSize -= it->second->size();
+			index.erase(it->first);
+			it = blocks.erase(it);
+		}
+
+		lastBlocks.erase(archive);
+	}
+
+	/// how much more can be inserted without evicting anything
+	size_t GetFreeSpace()
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		return (budget - std::min(totalSize, budget));
+	}
+
+private:
+	typedef std::pair<const void*, unsigned int> BlockKey;
+	typedef std::list< std::pair<BlockKey, Block> > BlockList;
+	typedef std::map<BlockKey, BlockList::iterator> BlockIndex;
+
+	bool CanEvict(const std::pair<BlockKey, Block>& entry) const
+	{
+		// a block referenced outside the cache would stay in memory anyway
+		if (!entry.second.unique())
+			return false;
+
+		const std::map<const void*, unsigned int>::const_iterator it = lastBlocks.find(entry.first.first);
+		return (it == lastBlocks.end() || it->second != entry.first.second);
+	}
+
+private:
+	BlockList blocks; // most recently used first
+	BlockIndex index;
+	/// folder-index of the block each archive used last
+	std::map<const void*, unsigned int> lastBlocks;
+
+	const size_t budget;
+	size_t totalSize;
+	boost::mutex mutex;
+};
+
+/// constructed on first use, after the config has been loaded
+static CSevenZipBlockCache& GetBlockCache()
+{
+	static CSevenZipBlockCache blockCache;
+	return blockCache;
+}
+
+}
+
 static Byte kUtf8Limits[5] = { 0xC0, 0xE0, 0xF0, 0xF8, 0xFC };
 static Bool Utf16_To_Utf8(char *dest, size_t *destLen, const UInt16 *src, size_t srcLen)
 {
@@ -110,9 +250,6 @@ const char* CSevenZipArchive::GetErrorStr(int err)
 
 CSevenZipArchive::CSevenZipArchive(const std::string& name):
 	CBufferedArchive(name, false),
-	blockIndex(0xFFFFFFFF),
-	outBuffer(NULL),
-	outBufferSize(0),
 	tempBuf(NULL),
 	tempBufSize(0),
 	isOpen(false)
@@ -122,6 +259,9 @@ CSevenZipArchive::CSevenZipArchive(const std::string& name):
 	allocTempImp.Alloc = SzAllocTemp;
 	allocTempImp.Free = SzFreeTemp;
 
+	// make sure the cache exists before ~CSevenZipArchive needs it
+	GetBlockCache();
+
 	SzArEx_Init(&db);
 
 	WRes wres = InFile_Open(&archiveStream.file, name.c_str());
@@ -156,6 +296,9 @@ CSevenZipArchive::CSevenZipArchive(const std::string& name):
 		folderUnpackSizes[fi] = SzFolder_GetUnpackSize(db.db.Folders + fi);
 	}
 
+	// files are stored back to back in their solid block
+	std::vector<size_t> folderOffsets(db.db.NumFolders, 0);
+
 	// Get contents of archive and store name->int mapping
 	for (unsigned int i = 0; i < db.db.NumFiles; ++i) {
 		CSzFileItem* f = db.db.Files + i;
@@ -179,6 +322,9 @@ CSevenZipArchive::CSevenZipArchive(const std::string& name):
 			fd.crc = (f->Size > 0) ? f->Crc: 0;
 
 			const UInt32 folderIndex = db.FileIndexToFolderIndexMap[i];
+			fd.folderIndex = folderIndex;
+			fd.folderOffset = 0;
+
 			if (folderIndex == ((UInt32)-1)) {
 				// file has no folder assigned
 				fd.unpackedSize = f->Size;
@@ -186,12 +332,18 @@ CSevenZipArchive::CSevenZipArchive(const std::string& name):
 			} else {
 				fd.unpackedSize = folderUnpackSizes[folderIndex];
 				fd.packedSize   = db.db.PackSizes[folderIndex];
+				fd.folderOffset = folderOffsets[folderIndex];
 			}
 			std::string fileName = fd.origName;
 			StringToLowerInPlace(fileName);
 			fileData.push_back(fd);
 			lcNameIndex[fileName] = fileData.size()-1;
 		}
+
+		const UInt32 folderIndex = db.FileIndexToFolderIndexMap[i];
+		if (folderIndex != ((UInt32)-1)) {
+			folderOffsets[folderIndex] += f->Size;
+		}
 	}
 
 	delete [] folderUnpackSizes;
@@ -200,9 +352,8 @@ CSevenZipArchive::CSevenZipArchive(const std::string& name):
 
 CSevenZipArchive::~CSevenZipArchive()
 {
-	if (outBuffer) {
-		IAlloc_Free(&allocImp, outBuffer);
-	}
+	GetBlockCache().Remove(this);
+
 	if (isOpen) {
 		File_Close(&archiveStream.file);
 	}
@@ -223,22 +374,162 @@ unsigned int CSevenZipArchive::NumFiles() const
 }
 
 bool CSevenZipArchive::GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buffer)
+{
+	CFileView view;
+
+	if (!GetFileViewImpl(fid, view))
+		return false;
+
+	view.CopyTo(buffer);
+	return true;
+}
+
+bool CSevenZipArchive::GetFileView(unsigned int fid, CFileView& view)
+{
+	boost::mutex::scoped_lock lck(archiveLock);
+	return GetFileViewImpl(fid, view);
+}
+
+bool CSevenZipArchive::GetFileViewImpl(unsigned int fid, CFileView& view)
 {
 	assert(IsFileId(fid));
-	
-	// Get 7zip to decompress it
-	size_t offset;
-	size_t outSizeProcessed;
-	SRes res;
 
-	res = SzArEx_Extract(&db, &lookStream.s, fileData[fid].fp, &blockIndex, &outBuffer, &outBufferSize, &offset, &outSizeProcessed, &allocImp, &allocTempImp);
-	if (res == SZ_OK) {
-		buffer.resize(outSizeProcessed);
-		memcpy(&buffer[0], (char*)outBuffer+offset, outSizeProcessed);
+	const FileData& fd = fileData[fid];
+
+	// empty files are not stored in any block
+	if (fd.folderIndex == ((UInt32)-1)) {
+		view = CFileView();
 		return true;
-	} else {
+	}
+
+	const Block block = GetBlock(fd.folderIndex);
+
+	if (block == NULL || !CheckFileInBlock(fid, block))
+		return false;
+
+	view = CFileView(block, fd.folderOffset, fd.size);
+	return true;
+}
+
+
+CSevenZipArchive::Block CSevenZipArchive::GetBlock(unsigned int folderIndex)
+{
+	Block block = GetBlockCache().Get(this, folderIndex);
+
+	if (block != NULL)
+		return block;
+
+	boost::shared_ptr< std::vector<boost::uint8_t> > newBlock(new std::vector<boost::uint8_t>());
+	const SRes res = DecodeBlock(&lookStream.s, folderIndex, *newBlock);
+
+	if (res != SZ_OK) {
+		LOG_L(L_ERROR, "Error extracting from \"%s\": %s", GetArchiveName().c_str(), GetErrorStr(res));
+		return Block();
+	}
+
+	GetBlockCache().Insert(this, folderIndex, newBlock);
+	return newBlock;
+}
+
+SRes CSevenZipArchive::DecodeBlock(ILookInStream* inStream, unsigned int folderIndex, std::vector<boost::uint8_t>& block)
+{
+	// same as SzArEx_Extract, but decodes into a buffer we own
+	CSzFolder* folder = db.db.Folders + folderIndex;
+
+	const UInt64 unpackSize = SzFolder_GetUnpackSize(folder);
+	const UInt64 startOffset = SzArEx_GetFolderStreamPos(&db, folderIndex, 0);
+
+	if (unpackSize != (size_t)unpackSize)
+		return SZ_ERROR_MEM;
+
+	block.resize(unpackSize);
+
+	RINOK(LookInStream_SeekTo(inStream, startOffset));
+	RINOK(SzFolder_Decode(folder, db.db.PackSizes + db.FolderStartPackStreamIndex[folderIndex], inStream, startOffset, block.empty()? NULL: &block[0], unpackSize, &allocTempImp));
+
+	if (folder->UnpackCRCDefined && CrcCalc(block.empty()? NULL: &block[0], unpackSize) != folder->UnpackCRC)
+		return SZ_ERROR_CRC;
+
+	return SZ_OK;
+}
+
+bool CSevenZipArchive::CheckFileInBlock(unsigned int fid, const Block& block) const
+{
+	const FileData& fd = fileData[fid];
+	const CSzFileItem* f = db.db.Files + fd.fp;
+
+	if ((fd.folderOffset + fd.size) > block->size())
+		return false;
+	if (f->CrcDefined && CrcCalc(&(*block)[fd.folderOffset], fd.size) != f->Crc)
 		return false;
+
+	return true;
+}
+
+
+void CSevenZipArchive::DecompressAhead()
+{
+	if (!isOpen || !configHandler->GetBool("SevenZipDecompressAhead"))
+		return;
+	// nothing gained from doing it up front on a single core
+	if (ThreadPool::GetNumThreads() <= 1)
+		return;
+
+	// decompress what fits into the cache in archive order,
+	// blocks of archives added earlier are not evicted for it
+	std::vector<unsigned int> folders;
+
+	size_t freeSpace = GetBlockCache().GetFreeSpace();
+	size_t totalSize = 0;
+
+	for (unsigned int fi = 0; fi < db.db.NumFolders; fi++) {
+		const size_t unpackSize = SzFolder_GetUnpackSize(db.db.Folders + fi);
+
+		if (GetBlockCache().Contains(this, fi))
+			continue;
+		// leave blocks too large for the remaining space to be decoded on demand
+		if (unpackSize > freeSpace)
+			continue;
+
+		freeSpace -= unpackSize;
+		totalSize += unpackSize;
+		folders.push_back(fi);
 	}
+
+	if (folders.empty())
+		return;
+
+	const spring_time startTime = spring_gettime();
+	const int numTasks = std::min(int(folders.size()), ThreadPool::GetNumThreads());
+
+	for_mt(0, numTasks, [&](const int taskNum) {
+		// 7zip streams are not thread-safe, each task reads through its own
+		CFileInStream taskFileStream;
+		CLookToRead taskLookStream;
+
+		if (InFile_Open(&taskFileStream.file, GetArchiveName().c_str()) != 0)
+			return;
+
+		FileInStream_CreateVTable(&taskFileStream);
+		LookToRead_CreateVTable(&taskLookStream, False);
+
+		taskLookStream.realStream = &taskFileStream.s;
+		LookToRead_Init(&taskLookStream);
+
+		for (size_t n = taskNum; n < folders.size(); n += numTasks) {
+			boost::shared_ptr< std::vector<boost::uint8_t> > block(new std::vector<boost::uint8_t>());
+
+			if (DecodeBlock(&taskLookStream.s, folders[n], *block) == SZ_OK) {
+				GetBlockCache().Insert(this, folders[n], block);
+			}
+		}
+
+		File_Close(&taskFileStream.file);
+	});
+
+	LOG("[%s] decompressed %u solid blocks (%.1fMB) of \"%s\" in %ims", __FUNCTION__,
+		(unsigned int) folders.size(), totalSize / (1024.0f * 1024.0f), GetArchiveName().c_str(),
+		int(spring_tomsecs(spring_gettime() - startTime)));
 }
 
 void CSevenZipArchive::FileInfo(unsigned int fid, std::string& name, int& size) const
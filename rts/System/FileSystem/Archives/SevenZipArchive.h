@@ -12,6 +12,7 @@ extern "C" {
 #include "BufferedArchive.h"
 #include <vector>
 #include <string>
+#include <boost/shared_ptr.hpp>
 #include "IArchive.h"
 
 /**
@@ -29,6 +30,10 @@ private:
 
 /**
  * An LZMA/7zip compressed, single-file archive.
+ *
+ * Files are extracted from decompressed solid blocks, which are kept in
+ * a LRU cache shared by all 7zip archives, so reading the files of a
+ * block one after another only decompresses it once.
  */
 class CSevenZipArchive : public CBufferedArchive
 {
@@ -40,14 +45,24 @@ public:
 	
 	virtual unsigned int NumFiles() const;
 	virtual bool GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buffer);
+	/// points into the cached solid block instead of copying the file
+	virtual bool GetFileView(unsigned int fid, CFileView& view);
 	virtual void FileInfo(unsigned int fid, std::string& name, int& size) const;
 	virtual bool HasLowReadingCost(unsigned int fid) const;
 	virtual unsigned GetCrc32(unsigned int fid);
+	/// decompresses the solid blocks into the block cache on the thread pool
+	virtual void DecompressAhead();
 
 private:
-	UInt32 blockIndex;
-	Byte* outBuffer;
-	size_t outBufferSize;
+	typedef boost::shared_ptr<const std::vector<boost::uint8_t> > Block;
+
+	/// GetFileView without locking <archiveLock>
+	bool GetFileViewImpl(unsigned int fid, CFileView& view);
+	/// the block of <folderIndex>, decompressed if not cached yet
+	Block GetBlock(unsigned int folderIndex);
+	SRes DecodeBlock(ILookInStream* inStream, unsigned int folderIndex, std::vector<boost::uint8_t>& block);
+	/// checks the extents and CRC of file <fid> within its block
+	bool CheckFileInBlock(unsigned int fid, const Block& block) const;
 
 	/**
 	 * How much more unpacked data may be allowed in a solid block,
@@ -93,6 +108,13 @@ private:
 		 * @see #unpackedSize
 		 */
 		int packedSize;
+		/**
+		 * Solid block (7zip folder) containing this file,
+		 * -1 for files without contents.
+		 */
+		UInt32 folderIndex;
+		/// Position of this file in the unpacked solid block.
+		size_t folderOffset;
 	};
 	int GetFileName(const CSzArEx* db, int i);
 	const char* GetErrorStr(int res);
@@ -53,6 +53,8 @@ CZipArchive::CZipArchive(const std::string& archiveName)
 		fd.size = info.uncompressed_size;
 		fd.origName = fName;
 		fd.crc = info.crc;
+		fd.stored = (info.compression_method == 0 && (info.flag & 1) == 0);
+		fd.dataOffset = 0;
 		fileData.push_back(fd);
 		lcNameIndex[fLowerName] = fileData.size() - 1;
 	}
@@ -90,6 +92,40 @@ unsigned int CZipArchive::GetCrc32(unsigned int fid)
 	return fileData[fid].crc;
 }
 
+bool CZipArchive::GetFileView(unsigned int fid, CFileView& view)
+{
+	boost::mutex::scoped_lock lck(archiveLock);
+	assert(IsFileId(fid));
+
+	FileData& fd = fileData[fid];
+
+	if (zip == NULL || !fd.stored || fd.size == 0) {
+		return GetCachedFileView(fid, view);
+	}
+
+	if (mappedArchive == NULL) {
+		mappedArchive.reset(new CMappedFile(GetArchiveName()));
+	}
+
+	if (fd.dataOffset == 0) {
+		// the member data starts behind its local header, whose
+		// size is only known once minizip has parsed it
+		unzGoToFilePos(zip, &fd.fp);
+
+		if (unzOpenCurrentFile(zip) == UNZ_OK) {
+			fd.dataOffset = unzGetCurrentFileZStreamPos64(zip);
+			unzCloseCurrentFile(zip);
+		}
+	}
+
+	if (!mappedArchive->IsOpen() || fd.dataOffset == 0 || (fd.dataOffset + fd.size) > mappedArchive->GetSize()) {
+		return GetCachedFileView(fid, view);
+	}
+
+	view = CFileView(mappedArchive, fd.dataOffset, fd.size);
+	return true;
+}
+
 // To simplify things, files are always read completely into memory from
 // the zip-file, since zlib does not provide any way of reading more
 // than one file at a time
@@ -37,6 +37,8 @@ public:
 	virtual unsigned int NumFiles() const;
 	virtual void FileInfo(unsigned int fid, std::string& name, int& size) const;
 	virtual unsigned int GetCrc32(unsigned int fid);
+	/// maps stored (uncompressed) members directly from the archive file
+	virtual bool GetFileView(unsigned int fid, CFileView& view);
 
 protected:
 	unzFile zip;
@@ -46,8 +48,13 @@ protected:
 		int size;
 		std::string origName;
 		unsigned int crc;
+		bool stored;       ///< neither compressed nor encrypted
+		size_t dataOffset; ///< of a stored member in the archive file, 0 if not known yet
 	};
 	std::vector<FileData> fileData;
+
+	/// whole archive file, mapped on first GetFileView of a stored member
+	boost::shared_ptr<const CMappedFile> mappedArchive;
 	
 	virtual bool GetFileImpl(unsigned int fid, std::vector<boost::uint8_t>& buffer);
 };
@@ -10,6 +10,7 @@
 #include <boost/cstdint.hpp>
 
 #include "VFSModes.h"
+#include "Archives/FileView.h"
 
 /**
  * This is for direct VFS file content access.
@@ -72,7 +73,7 @@ private:
 
 	std::string fileName;
 	std::ifstream ifs;
-	std::vector<boost::uint8_t> fileBuffer;
+	CFileView fileView;
 	int filePos;
 	int fileSize;
 };
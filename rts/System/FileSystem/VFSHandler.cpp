@@ -30,28 +30,46 @@ CVFSHandler* vfsHandler = NULL;
 
 
 CVFSHandler::CVFSHandler()
+	: fileTable(new FileTable())
 {
 	LOG_L(L_DEBUG, "CVFSHandler::CVFSHandler()");
 }
 
 
-bool CVFSHandler::AddArchive(const std::string& archiveName, bool override, const std::string& type)
+CVFSHandler::FileTablePtr CVFSHandler::GetFileTable() const
+{
+	boost::mutex::scoped_lock lock(fileTableMutex);
+	return fileTable;
+}
+
+void CVFSHandler::SetFileTable(const FileTablePtr& table)
+{
+	// the previous table (and archives only it refers to) gets
+	// freed when the last reader still working with it is done
+	boost::mutex::scoped_lock lock(fileTableMutex);
+	fileTable = table;
+}
+
+
+bool CVFSHandler::AddArchiveToTable(FileTable& table, const std::string& archiveName, bool override, const std::string& type)
 {
 	LOG_L(L_DEBUG,
 		"AddArchive(arName = \"%s\", override = %s, type = \"%s\")",
 		archiveName.c_str(), override ? "true" : "false", type.c_str());
 
-	IArchive* ar = archives[archiveName];
+	boost::shared_ptr<IArchive>& arPtr = table.archives[archiveName];
 
-	if (ar == NULL) {
-		ar = archiveLoader.OpenArchive(archiveName, type);
-		if (!ar) {
+	if (arPtr == NULL) {
+		arPtr.reset(archiveLoader.OpenArchive(archiveName, type));
+		if (arPtr == NULL) {
 			LOG_L(L_ERROR, "AddArchive: Failed to open archive '%s'.", archiveName.c_str());
+			table.archives.erase(archiveName);
 			return false;
 		}
-		archives[archiveName] = ar;
 	}
 
+	IArchive* ar = arPtr.get();
+
 	for (unsigned fid = 0; fid != ar->NumFiles(); ++fid) {
 		std::string name;
 		int size;
@@ -59,7 +77,7 @@ bool CVFSHandler::AddArchive(const std::string& archiveName, bool override, cons
 		StringToLowerInPlace(name);
 
 		if (!override) {
-			if (files.find(name) != files.end()) {
+			if (table.files.find(name) != table.files.end()) {
 				LOG_L(L_DEBUG, "%s (skipping, exists)", name.c_str());
 				continue;
 			} else {
@@ -72,12 +90,25 @@ bool CVFSHandler::AddArchive(const std::string& archiveName, bool override, cons
 		FileData d;
 		d.ar = ar;
 		d.size = size;
-		files[name] = d;
+		table.files[name] = d;
+		table.index[name] = d;
 	}
 
 	return true;
 }
 
+bool CVFSHandler::AddArchive(const std::string& archiveName, bool override, const std::string& type)
+{
+	boost::mutex::scoped_lock lock(modifyMutex);
+	boost::shared_ptr<FileTable> table(new FileTable(*GetFileTable()));
+
+	if (!AddArchiveToTable(*table, archiveName, override, type))
+		return false;
+
+	SetFileTable(table);
+	return true;
+}
+
 bool CVFSHandler::AddArchiveWithDeps(const std::string& archiveName, bool override, const std::string& type)
 {
 	const std::vector<std::string> &ars = archiveScanner->GetAllArchivesUsedBy(archiveName);
@@ -85,48 +116,79 @@ bool CVFSHandler::AddArchiveWithDeps(const std::string& archiveName, bool overri
 	if (ars.empty())
 		throw content_error("Could not find any archives for '" + archiveName + "'.");
 
+	boost::mutex::scoped_lock lock(modifyMutex);
+	boost::shared_ptr<FileTable> table(new FileTable(*GetFileTable()));
+
 	std::vector<std::string>::const_iterator it;
 
 	for (it = ars.begin(); it != ars.end(); ++it) {
-		if (!AddArchive(*it, override, type))
+		if (!AddArchiveToTable(*table, *it, override, type)) {
+			// keep the dependencies added so far, as before
+			SetFileTable(table);
 			throw content_error("Failed loading archive '" + *it + "', dependency of '" + archiveName + "'.");
+		}
 	}
 
+	SetFileTable(table);
 	return true;
 }
 
+void CVFSHandler::DecompressArchivesAhead()
+{
+	const FileTablePtr table = GetFileTable();
+
+	std::map<std::string, boost::shared_ptr<IArchive> >::const_iterator it;
+
+	for (it = table->archives.begin(); it != table->archives.end(); ++it) {
+		it->second->DecompressAhead();
+	}
+}
+
 bool CVFSHandler::RemoveArchive(const std::string& archiveName)
 {
 	LOG_L(L_DEBUG, "RemoveArchive(archiveName = \"%s\")", archiveName.c_str());
 
-	IArchive* ar = archives[archiveName];
-	if (ar == NULL) {
+	boost::mutex::scoped_lock lock(modifyMutex);
+	const FileTablePtr oldTable = GetFileTable();
+
+	const std::map<std::string, boost::shared_ptr<IArchive> >::const_iterator ait = oldTable->archives.find(archiveName);
+	if (ait == oldTable->archives.end()) {
 		// archive is not loaded
 		return true;
 	}
-	
-	// remove the files loaded from the archive-to-remove
-	for (std::map<std::string, FileData>::iterator f = files.begin(); f != files.end();) {
+
+	const IArchive* ar = ait->second.get();
+	boost::shared_ptr<FileTable> table(new FileTable());
+
+	// copy all but the files loaded from the archive-to-remove
+	for (std::map<std::string, FileData>::const_iterator f = oldTable->files.begin(); f != oldTable->files.end(); ++f) {
 		if (f->second.ar == ar) {
 			LOG_L(L_DEBUG, "%s (removing)", f->first.c_str());
-			f = set_erase(files, f);
-		} else {
-			 ++f;
+			continue;
 		}
+
+		table->files.insert(table->files.end(), *f);
+		table->index.insert(*f);
 	}
-	delete ar;
-	archives.erase(archiveName);
 
+	table->archives = oldTable->archives;
+	table->archives.erase(archiveName);
+
+	// the archive is deleted once no reader uses the old table anymore
+	SetFileTable(table);
 	return true;
 }
 
 CVFSHandler::~CVFSHandler()
 {
-	LOG_L(L_INFO, "[%s] #archives=%lu", __FUNCTION__, archives.size());
+	const FileTablePtr table = GetFileTable();
+
+	LOG_L(L_INFO, "[%s] #archives=%lu", __FUNCTION__, (unsigned long) table->archives.size());
+
+	std::map<std::string, boost::shared_ptr<IArchive> >::const_iterator it;
 
-	for (std::map<std::string, IArchive*>::iterator i = archives.begin(); i != archives.end(); ++i) {
-		LOG_L(L_INFO, "\tarchive=%s (%p)", (i->first).c_str(), i->second);
-		delete i->second;
+	for (it = table->archives.begin(); it != table->archives.end(); ++it) {
+		LOG_L(L_INFO, "\tarchive=%s (%p)", (it->first).c_str(), it->second.get());
 	}
 }
 
@@ -137,12 +199,12 @@ std::string CVFSHandler::GetNormalizedPath(const std::string& rawPath)
 	return path;
 }
 
-const CVFSHandler::FileData* CVFSHandler::GetFileData(const std::string& normalizedFilePath)
+const CVFSHandler::FileData* CVFSHandler::GetFileData(const FileTable& table, const std::string& normalizedFilePath)
 {
 	const FileData* fileData = NULL;
 
-	const std::map<std::string, FileData>::const_iterator fi = files.find(normalizedFilePath);
-	if (fi != files.end()) {
+	const boost::unordered_map<std::string, FileData>::const_iterator fi = table.index.find(normalizedFilePath);
+	if (fi != table.index.end()) {
 		fileData = &(fi->second);
 	}
 
@@ -154,8 +216,9 @@ bool CVFSHandler::LoadFile(const std::string& filePath, std::vector<boost::uint8
 	LOG_L(L_DEBUG, "LoadFile(filePath = \"%s\", )", filePath.c_str());
 
 	const std::string normalizedPath = GetNormalizedPath(filePath);
+	const FileTablePtr table = GetFileTable();
 
-	const FileData* fileData = GetFileData(normalizedPath);
+	const FileData* fileData = GetFileData(*table, normalizedPath);
 	if (fileData == NULL) {
 		LOG_L(L_DEBUG, "LoadFile: File '%s' does not exist in VFS.", filePath.c_str());
 		return false;
@@ -169,13 +232,35 @@ bool CVFSHandler::LoadFile(const std::string& filePath, std::vector<boost::uint8
 	return true;
 }
 
+bool CVFSHandler::LoadFile(const std::string& filePath, CFileView& view)
+{
+	LOG_L(L_DEBUG, "LoadFile(filePath = \"%s\", )", filePath.c_str());
+
+	const std::string normalizedPath = GetNormalizedPath(filePath);
+	const FileTablePtr table = GetFileTable();
+
+	const FileData* fileData = GetFileData(*table, normalizedPath);
+	if (fileData == NULL) {
+		LOG_L(L_DEBUG, "LoadFile: File '%s' does not exist in VFS.", filePath.c_str());
+		return false;
+	}
+
+	if (!fileData->ar->GetFileView(normalizedPath, view))
+	{
+		LOG_L(L_DEBUG, "LoadFile: File '%s' does not exist in archive.", filePath.c_str());
+		return false;
+	}
+	return true;
+}
+
 bool CVFSHandler::FileExists(const std::string& filePath)
 {
 	LOG_L(L_DEBUG, "FileExists(filePath = \"%s\", )", filePath.c_str());
 
 	const std::string normalizedPath = GetNormalizedPath(filePath);
+	const FileTablePtr table = GetFileTable();
 
-	const FileData* fileData = GetFileData(normalizedPath);
+	const FileData* fileData = GetFileData(*table, normalizedPath);
 	if (fileData == NULL) {
 		// the file does not exist in the VFS
 		return false;
@@ -196,6 +281,9 @@ std::vector<std::string> CVFSHandler::GetFilesInDir(const std::string& rawDir)
 	std::vector<std::string> ret;
 	std::string dir = GetNormalizedPath(rawDir);
 
+	const FileTablePtr table = GetFileTable();
+	const std::map<std::string, FileData>& files = table->files;
+
 	std::map<std::string, FileData>::const_iterator filesStart = files.begin();
 	std::map<std::string, FileData>::const_iterator filesEnd   = files.end();
 
@@ -244,6 +332,9 @@ std::vector<std::string> CVFSHandler::GetDirsInDir(const std::string& rawDir)
 	std::vector<std::string> ret;
 	std::string dir = GetNormalizedPath(rawDir);
 
+	const FileTablePtr table = GetFileTable();
+	const std::map<std::string, FileData>& files = table->files;
+
 	std::map<std::string, FileData>::const_iterator filesStart = files.begin();
 	std::map<std::string, FileData>::const_iterator filesEnd   = files.end();
 
@@ -7,13 +7,22 @@
 #include <string>
 #include <vector>
 #include <boost/cstdint.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/thread/mutex.hpp>
 
 class IArchive;
+class CFileView;
 
 /**
  * Main API for accessing the Virtual File System (VFS).
  * This only allows accessing the VFS (stuff within archives registered with the
  * VFS), NOT the real file system.
+ *
+ * All methods are thread-safe. Readers work on an immutable snapshot of the
+ * file table, which adding or removing archives replaces as a whole, so
+ * lookups never block each other. Reading file contents is serialized per
+ * archive only, by archive types that need it (see CBufferedArchive).
  */
 class CVFSHandler
 {
@@ -37,6 +46,14 @@ public:
 	 * @return true if the file exists in the VFS and was successfully read
 	 */
 	bool LoadFile(const std::string& filePath, std::vector<boost::uint8_t>& buffer);
+	/**
+	 * Like LoadFile, but avoids copying the contents where the archive
+	 * allows it (e.g. memory-mapped files in directory archives).
+	 * @param filePath raw file path, for example "maps/myMap.smf",
+	 *   case-insensitive
+	 * @return true if the file exists in the VFS and was successfully read
+	 */
+	bool LoadFile(const std::string& filePath, CFileView& view);
 
 	/**
 	 * Returns all the files in the given (virtual) directory without the
@@ -65,6 +82,11 @@ public:
 	 *   entry in the VFS is overwritten or not.
 	 */
 	bool AddArchiveWithDeps(const std::string& archiveName, bool override, const std::string& type = "");
+	/**
+	 * Lets all loaded archives unpack their contents ahead of use.
+	 * @see IArchive::DecompressAhead
+	 */
+	void DecompressArchivesAhead();
 
 	/**
 	 * Removes an archive from the VFS.
@@ -78,12 +100,36 @@ protected:
 		IArchive* ar;
 		int size;
 	};
-	std::map<std::string, FileData> files; 
-	std::map<std::string, IArchive*> archives;
+
+	/// never modified once published, see GetFileTable
+	struct FileTable {
+		/// sorted, for listing directories
+		std::map<std::string, FileData> files;
+		/// the same entries, for looking up single files
+		boost::unordered_map<std::string, FileData> index;
+		/// keeps the archives alive as long as the table is in use
+		std::map<std::string, boost::shared_ptr<IArchive> > archives;
+	};
+	typedef boost::shared_ptr<const FileTable> FileTablePtr;
 
 private:
 	std::string GetNormalizedPath(const std::string& rawPath);
-	const FileData* GetFileData(const std::string& normalizedFilePath);
+	/// returns NULL if the file is not in <table>
+	const FileData* GetFileData(const FileTable& table, const std::string& normalizedFilePath);
+
+	/// the current snapshot of the file table
+	FileTablePtr GetFileTable() const;
+	void SetFileTable(const FileTablePtr& table);
+	/// adds an archive to <table>, which is not published yet
+	bool AddArchiveToTable(FileTable& table, const std::string& archiveName, bool override, const std::string& type);
+
+private:
+	FileTablePtr fileTable;
+
+	/// guards <fileTable> itself, not the table it points to
+	mutable boost::mutex fileTableMutex;
+	/// serializes the modifications of the file table
+	boost::mutex modifyMutex;
 };
 
 extern CVFSHandler* vfsHandler;
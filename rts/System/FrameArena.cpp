@@ -0,0 +1,77 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/FrameArena.h"
+
+#include <algorithm>
+#include <cassert>
+
+static __thread CFrameArena* threadArena = NULL;
+
+
+
+CFrameArena::CFrameArena(size_t chunkSize, size_t maxKeptChunks)
+	: chunkSize(chunkSize)
+	, maxKeptChunks(maxKeptChunks)
+	, curChunk(0)
+	, curOffset(0)
+	, numBytesUsed(0)
+{
+}
+
+CFrameArena::~CFrameArena()
+{
+	assert(threadArena != this);
+
+	for (size_t n = 0; n < chunks.size(); n++) {
+		::operator delete(chunks[n].mem);
+	}
+}
+
+
+void* CFrameArena::Alloc(size_t numBytes)
+{
+	numBytes = (numBytes + (ALIGNMENT - 1)) & ~(ALIGNMENT - 1);
+	numBytesUsed += numBytes;
+
+	// find the first chunk from the current one on with enough room
+	// (oversized requests get a chunk of their own)
+	while (curChunk < chunks.size() && (curOffset + numBytes) > chunks[curChunk].size) {
+		curChunk += 1;
+		curOffset = 0;
+	}
+
+	if (curChunk == chunks.size()) {
+		Chunk chunk;
+		chunk.size = std::max(chunkSize, numBytes);
+		chunk.mem = static_cast<char*>(::operator new(chunk.size));
+		chunks.push_back(chunk);
+	}
+
+	void* ptr = chunks[curChunk].mem + curOffset;
+	curOffset += numBytes;
+	return ptr;
+}
+
+void CFrameArena::Reset()
+{
+	for (size_t n = maxKeptChunks; n < chunks.size(); n++) {
+		::operator delete(chunks[n].mem);
+	}
+
+	chunks.resize(std::min(chunks.size(), maxKeptChunks));
+
+	curChunk = 0;
+	curOffset = 0;
+	numBytesUsed = 0;
+}
+
+
+CFrameArena* CFrameArena::GetThreadArena()
+{
+	return threadArena;
+}
+
+void CFrameArena::SetThreadArena(CFrameArena* arena)
+{
+	threadArena = arena;
+}
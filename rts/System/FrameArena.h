@@ -0,0 +1,110 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * Bump allocator for short-lived temporaries, eg. the results of quadfield
+ * searches. Memory is handed out linearly from large chunks and is never
+ * freed individually; Reset reclaims all of it at once and is called by
+ * the owning thread at points where no such temporaries are alive (the
+ * start of every sim- and draw-frame for the main thread). Reset keeps
+ * only the first few chunks, so a one-off peak (eg. while loading) does
+ * not stay resident.
+ *
+ * Arenas are per thread: only a thread that installed one with
+ * SetThreadArena uses it, FrameAllocator falls back to the heap on all
+ * other threads.
+ */
+class CFrameArena
+{
+public:
+	CFrameArena(size_t chunkSize = (1 << 20), size_t maxKeptChunks = 4);
+	~CFrameArena();
+
+	void* Alloc(size_t numBytes);
+	void Reset();
+
+	/// bytes handed out since the last Reset
+	size_t GetNumBytesUsed() const { return numBytesUsed; }
+	size_t GetNumChunks() const { return chunks.size(); }
+
+	static CFrameArena* GetThreadArena();
+	static void SetThreadArena(CFrameArena* arena);
+
+private:
+	struct Chunk {
+		char* mem;
+		size_t size;
+	};
+
+	static const size_t ALIGNMENT = 16;
+
+	std::vector<Chunk> chunks;
+
+	size_t chunkSize;
+	/// chunks beyond this many are freed by Reset
+	size_t maxKeptChunks;
+	size_t curChunk;
+	size_t curOffset;
+	size_t numBytesUsed;
+};
+
+
+
+/**
+ * STL allocator taking memory from the arena of the thread that
+ * constructed it (or the heap if that thread has none). Deallocation
+ * is a no-op for arena memory, so containers using this must not be
+ * kept past the next CFrameArena::Reset of that thread.
+ */
+template<typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+	typedef T* pointer;
+	typedef const T* const_pointer;
+	typedef T& reference;
+	typedef const T& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	template<typename U> struct rebind { typedef FrameAllocator<U> other; };
+
+	FrameAllocator(): arena(CFrameArena::GetThreadArena()) {}
+	template<typename U> FrameAllocator(const FrameAllocator<U>& a): arena(a.arena) {}
+
+	pointer address(reference x) const { return &x; }
+	const_pointer address(const_reference x) const { return &x; }
+
+	pointer allocate(size_type n, const void* = NULL) {
+		if (arena == NULL)
+			return static_cast<pointer>(::operator new(n * sizeof(T)));
+
+		return static_cast<pointer>(arena->Alloc(n * sizeof(T)));
+	}
+
+	void deallocate(pointer p, size_type) {
+		if (arena == NULL) {
+			::operator delete(p);
+		}
+	}
+
+	size_type max_size() const { return (size_t(-1) / sizeof(T)); }
+
+	void construct(pointer p, const T& val) { new (p) T(val); }
+	void destroy(pointer p) { p->~T(); }
+
+	template<typename U> bool operator == (const FrameAllocator<U>& a) const { return (arena == a.arena); }
+	template<typename U> bool operator != (const FrameAllocator<U>& a) const { return (arena != a.arena); }
+
+public:
+	CFrameArena* arena;
+};
+
+#endif // FRAME_ARENA_H
@@ -1,42 +1,181 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
 #include "System/MemPool.h"
-//#include "System/mmgr.h"
+
+#include <algorithm>
+#include <cassert>
+#include <boost/thread/tss.hpp>
 
 CMemPool mempool;
 
+__thread CMemPool::ThreadCache* CMemPool::threadCache = NULL;
+
+// id of the pool currently owning the per-thread caches (0 if none)
+static std::atomic<unsigned int> cacheOwnerID(0);
+static std::atomic<unsigned int> nextCacheID(1);
+
+
+struct CMemPool::ThreadCache {
+	/// pool the cached blocks belong to, stale caches are discarded
+	unsigned int cacheID;
+	CMemPool* pool;
+
+	void* freeList[NUM_SIZE_CLASSES];
+	size_t numFree[NUM_SIZE_CLASSES];
+};
+
+
+static inline void PushBlock(void*& head, void* blk)
+{
+	*(void**)blk = head;
+	head = blk;
+}
+
+static inline void* PopBlock(void*& head)
+{
+	void* blk = head;
+	head = *(void**)blk;
+	return blk;
+}
+
+static size_t GetSlabIndex(const std::vector<char*>& slabs, const void* blk)
+{
+	// slabs are sorted by address, blk lies in the last one starting at or before it
+	const std::vector<char*>::const_iterator it = std::upper_bound(slabs.begin(), slabs.end(), static_cast<const char*>(blk));
+	assert(it != slabs.begin());
+	return ((it - slabs.begin()) - 1);
+}
+
+
+
 CMemPool::CMemPool()
+	: cacheID(0)
+	, liveBytes(0)
+	, peakBytes(0)
+	, numExternalAllocs(0)
 {
-	for (size_t a = 0; a < (MAX_MEM_SIZE + 1); a++) {
-		nextFree[a] = NULL;
-		poolSize[a] = 10;
+	// 16-byte steps up to 128 bytes, then four classes per doubling
+	size_t blockSize = 0;
+	size_t stepSize = 16;
+
+	for (size_t classIdx = 0; classIdx < NUM_SIZE_CLASSES; classIdx++) {
+		if (blockSize >= 128 && (blockSize & (blockSize - 1)) == 0)
+			stepSize = blockSize / 4;
+
+		blockSize += stepSize;
+
+		SizeClass& sc = sizeClasses[classIdx];
+		sc.freeList = NULL;
+		sc.blockSize = blockSize;
+		sc.blocksPerSlab = SLAB_SIZE / blockSize;
+		sc.batchSize = std::max(size_t(4), std::min(size_t(32), sc.blocksPerSlab / 4));
+		sc.numAllocs = 0;
+		sc.numCacheHits = 0;
+		sc.numSlabAllocs = 0;
+	}
+
+	assert(blockSize == MAX_MEM_SIZE);
+
+	for (size_t n = 0, classIdx = 0; n <= (MAX_MEM_SIZE / 16); n++) {
+		while (sizeClasses[classIdx].blockSize < (n * 16))
+			classIdx++;
+
+		sizeClassIndices[n] = classIdx;
+	}
+
+	unsigned int noOwner = 0;
+	unsigned int newID = nextCacheID.fetch_add(1);
+
+	if (cacheOwnerID.compare_exchange_strong(noOwner, newID))
+		cacheID = newID;
+}
+
+CMemPool::~CMemPool()
+{
+	for (size_t classIdx = 0; classIdx < NUM_SIZE_CLASSES; classIdx++) {
+		const std::vector<char*>& slabs = sizeClasses[classIdx].slabs;
+
+		for (std::vector<char*>::const_iterator it = slabs.begin(); it != slabs.end(); ++it) {
+			::operator delete(*it);
+		}
 	}
+
+	// blocks still sitting in thread-caches are dropped along with the
+	// slabs; the caches notice the stale id the next time they are used
+	if (cacheID != 0)
+		cacheOwnerID.store(0);
 }
 
+
+
+CMemPool::ThreadCache* CMemPool::GetThreadCache()
+{
+	if (cacheID == 0)
+		return NULL;
+
+	if (threadCache == NULL) {
+		// deletes the cache (via ReleaseThreadCache) when the thread exits
+		static boost::thread_specific_ptr<ThreadCache> threadCacheOwner(&CMemPool::ReleaseThreadCache);
+
+		threadCache = new ThreadCache();
+		memset(threadCache, 0, sizeof(ThreadCache));
+		threadCacheOwner.reset(threadCache);
+	}
+
+	if (threadCache->cacheID != cacheID) {
+		memset(threadCache, 0, sizeof(ThreadCache));
+		threadCache->cacheID = cacheID;
+		threadCache->pool = this;
+	}
+
+	return threadCache;
+}
+
+void CMemPool::ReleaseThreadCache(ThreadCache* cache)
+{
+	// blocks left in the cache of an exited thread would pin their slabs
+	// forever, hand them back unless the pool is gone (stale id)
+	if (cache->cacheID != 0 && cache->cacheID == cacheOwnerID.load()) {
+		for (size_t classIdx = 0; classIdx < NUM_SIZE_CLASSES; classIdx++) {
+			if (cache->numFree[classIdx] != 0) {
+				cache->pool->DrainCache(classIdx, cache, cache->numFree[classIdx]);
+			}
+		}
+	}
+
+	if (threadCache == cache)
+		threadCache = NULL;
+
+	delete cache;
+}
+
+
 void* CMemPool::Alloc(size_t numBytes)
 {
 	if (UseExternalMemory(numBytes)) {
+		numExternalAllocs.fetch_add(1, std::memory_order_relaxed);
 		return ::operator new(numBytes);
-	} else {
-		void* pnt = nextFree[numBytes];
-
-		if (pnt) {
-			nextFree[numBytes] = (*(void**)pnt);
-		} else {
-			void* newBlock = ::operator new(numBytes * poolSize[numBytes]);
-			allocated.push_back(newBlock);
-			for (int i = 0; i < (poolSize[numBytes] - 1); ++i) {
-				*(void**)&((char*)newBlock)[(i) * numBytes] = (void*)&((char*)newBlock)[(i + 1) * numBytes];
-			}
+	}
 
-			*(void**)&((char*)newBlock)[(poolSize[numBytes] - 1) * numBytes] = 0;
+	const size_t classIdx = sizeClassIndices[(numBytes + 15) >> 4];
 
-			pnt = newBlock;
-			nextFree[numBytes] = (*(void**)pnt);
-			poolSize[numBytes] *= 2;
-		}
-		return pnt;
+	SizeClass& sc = sizeClasses[classIdx];
+	ThreadCache* cache = GetThreadCache();
+
+	void* pnt = NULL;
+
+	if (cache != NULL && cache->freeList[classIdx] != NULL) {
+		pnt = PopBlock(cache->freeList[classIdx]);
+		cache->numFree[classIdx] -= 1;
+
+		sc.numCacheHits.fetch_add(1, std::memory_order_relaxed);
+	} else {
+		pnt = AllocShared(classIdx, cache);
 	}
+
+	sc.numAllocs.fetch_add(1, std::memory_order_relaxed);
+	AddLiveBytes(sc.blockSize);
+	return pnt;
 }
 
 void CMemPool::Free(void* pnt, size_t numBytes)
@@ -47,14 +186,178 @@ void CMemPool::Free(void* pnt, size_t numBytes)
 
 	if (UseExternalMemory(numBytes)) {
 		::operator delete(pnt);
-	} else {
-		*(void**)pnt = nextFree[numBytes];
-		nextFree[numBytes] = pnt;
+		return;
 	}
+
+	const size_t classIdx = sizeClassIndices[(numBytes + 15) >> 4];
+
+	SizeClass& sc = sizeClasses[classIdx];
+	ThreadCache* cache = GetThreadCache();
+
+	liveBytes.fetch_sub(sc.blockSize, std::memory_order_relaxed);
+
+	if (cache != NULL) {
+		PushBlock(cache->freeList[classIdx], pnt);
+
+		if ((cache->numFree[classIdx] += 1) > (sc.batchSize * 2))
+			DrainCache(classIdx, cache, sc.batchSize);
+
+		return;
+	}
+
+	boost::mutex::scoped_lock lock(sc.mutex);
+	PushBlock(sc.freeList, pnt);
 }
 
-CMemPool::~CMemPool()
+
+
+void* CMemPool::AllocShared(size_t classIdx, ThreadCache* cache)
+{
+	SizeClass& sc = sizeClasses[classIdx];
+	boost::mutex::scoped_lock lock(sc.mutex);
+
+	if (sc.freeList == NULL)
+		AddSlab(sc);
+
+	void* pnt = PopBlock(sc.freeList);
+
+	if (cache == NULL)
+		return pnt;
+
+	// refill the cache so the next few allocations need no lock
+	for (size_t n = 0; n < sc.batchSize && sc.freeList != NULL; n++) {
+		PushBlock(cache->freeList[classIdx], PopBlock(sc.freeList));
+		cache->numFree[classIdx] += 1;
+	}
+
+	return pnt;
+}
+
+void CMemPool::DrainCache(size_t classIdx, ThreadCache* cache, size_t numBlocks)
+{
+	SizeClass& sc = sizeClasses[classIdx];
+	boost::mutex::scoped_lock lock(sc.mutex);
+
+	for (size_t n = 0; n < numBlocks && cache->freeList[classIdx] != NULL; n++) {
+		PushBlock(sc.freeList, PopBlock(cache->freeList[classIdx]));
+		cache->numFree[classIdx] -= 1;
+	}
+}
+
+void CMemPool::AddSlab(SizeClass& sc)
+{
+	char* slab = static_cast<char*>(::operator new(SLAB_SIZE));
+
+	sc.slabs.insert(std::upper_bound(sc.slabs.begin(), sc.slabs.end(), slab), slab);
+	sc.numSlabAllocs.fetch_add(1, std::memory_order_relaxed);
+
+	// push in reverse so blocks are handed out in address order
+	for (size_t n = sc.blocksPerSlab; n > 0; n--) {
+		PushBlock(sc.freeList, slab + (n - 1) * sc.blockSize);
+	}
+}
+
+
+void CMemPool::AddLiveBytes(size_t numBytes)
+{
+	const size_t curLiveBytes = liveBytes.fetch_add(numBytes, std::memory_order_relaxed) + numBytes;
+
+	size_t curPeakBytes = peakBytes.load(std::memory_order_relaxed);
+
+	while (curLiveBytes > curPeakBytes) {
+		if (peakBytes.compare_exchange_weak(curPeakBytes, curLiveBytes))
+			break;
+	}
+}
+
+
+
+size_t CMemPool::Trim()
 {
-	for(std::vector<void *>::iterator i = allocated.begin(); i != allocated.end(); ++i)
-		::operator delete(*i);
+	ThreadCache* cache = GetThreadCache();
+
+	size_t numBytesFreed = 0;
+
+	for (size_t classIdx = 0; classIdx < NUM_SIZE_CLASSES; classIdx++) {
+		SizeClass& sc = sizeClasses[classIdx];
+
+		// blocks cached by the calling thread would otherwise pin their slabs;
+		// those cached by other threads do, until they are drained
+		if (cache != NULL && cache->numFree[classIdx] != 0)
+			DrainCache(classIdx, cache, cache->numFree[classIdx]);
+
+		boost::mutex::scoped_lock lock(sc.mutex);
+
+		if (sc.slabs.empty())
+			continue;
+
+		std::vector<size_t> numFreeBlocks(sc.slabs.size(), 0);
+		std::vector<bool> releaseSlab(sc.slabs.size(), false);
+
+		for (void* blk = sc.freeList; blk != NULL; blk = *(void**)blk) {
+			numFreeBlocks[GetSlabIndex(sc.slabs, blk)] += 1;
+		}
+
+		size_t numReleased = 0;
+
+		for (size_t n = 0; n < sc.slabs.size(); n++) {
+			releaseSlab[n] = (numFreeBlocks[n] == sc.blocksPerSlab);
+			numReleased += releaseSlab[n];
+		}
+
+		if (numReleased == 0)
+			continue;
+
+		// unlink all blocks of the released slabs from the free-list
+		for (void** link = &sc.freeList; *link != NULL; ) {
+			if (releaseSlab[GetSlabIndex(sc.slabs, *link)]) {
+				*link = *(void**)(*link);
+			} else {
+				link = (void**)(*link);
+			}
+		}
+
+		std::vector<char*> keptSlabs;
+		keptSlabs.reserve(sc.slabs.size() - numReleased);
+
+		for (size_t n = 0; n < sc.slabs.size(); n++) {
+			if (releaseSlab[n]) {
+				::operator delete(sc.slabs[n]);
+			} else {
+				keptSlabs.push_back(sc.slabs[n]);
+			}
+		}
+
+		sc.slabs.swap(keptSlabs);
+		numBytesFreed += (numReleased * SLAB_SIZE);
+	}
+
+	return numBytesFreed;
 }
+
+void CMemPool::GetStats(Stats* stats) const
+{
+	stats->liveBytes = liveBytes.load();
+	stats->peakBytes = peakBytes.load();
+	stats->slabBytes = 0;
+	stats->numExternalAllocs = numExternalAllocs.load();
+	stats->classes.resize(NUM_SIZE_CLASSES);
+
+	for (size_t classIdx = 0; classIdx < NUM_SIZE_CLASSES; classIdx++) {
+		const SizeClass& sc = sizeClasses[classIdx];
+		ClassStats& cs = stats->classes[classIdx];
+
+		{
+			boost::mutex::scoped_lock lock(sc.mutex);
+			cs.numSlabs = sc.slabs.size();
+		}
+
+		cs.blockSize = sc.blockSize;
+		cs.numAllocs = sc.numAllocs.load();
+		cs.numCacheHits = sc.numCacheHits.load();
+		cs.numSlabAllocs = sc.numSlabAllocs.load();
+
+		stats->slabBytes += (cs.numSlabs * SLAB_SIZE);
+	}
+}
+
@@ -6,34 +6,115 @@
 #include <new>
 #include <cstring> // for size_t
 #include <vector>
+#include <atomic>
+#include <boost/thread/mutex.hpp>
 
-static const size_t MAX_MEM_SIZE = 200;
+static const size_t MAX_MEM_SIZE = 4096;
 
 /**
- * Speeds-up for memory-allocation of often allocated/deallocated structs
- * or classes, or other memory blocks of equal size.
- * You may think of this as something like a very primitive garbage collector.
- * Instead of actually freeing memory, it is kept allocated, and is just
- * reassigned next time an alloc of the same size is performed.
- * The maximum memory held by this class is approximately MAX_MEM_SIZE^2 bytes.
+ * Speeds-up memory-allocation of often allocated/deallocated structs
+ * or classes, or other memory blocks of (roughly) equal size.
+ *
+ * Requests are rounded up to one of NUM_SIZE_CLASSES block-sizes, and each
+ * size-class carves its blocks out of SLAB_SIZE byte slabs. Every thread
+ * keeps a small cache of free blocks per class, so most Alloc/Free pairs
+ * never take a lock; caches are refilled from and drained to the shared
+ * free-list of a class in batches, and drained completely when a thread
+ * exits. Only one pool (normally the global mempool) can use the per-thread
+ * caches at any time, other instances always go through the locked
+ * free-lists.
+ *
+ * Memory is not given back when blocks are freed, Trim releases all slabs
+ * that have no allocated blocks left and is called periodically.
  */
 class CMemPool
 {
 public:
+	struct ClassStats {
+		size_t blockSize;
+		size_t numSlabs;
+		size_t numAllocs;
+		/// allocations served from a thread-cache without locking
+		size_t numCacheHits;
+		/// allocations that required a new slab
+		size_t numSlabAllocs;
+	};
+
+	struct Stats {
+		/// bytes in allocated blocks (block-sizes, not requested sizes)
+		size_t liveBytes;
+		size_t peakBytes;
+		/// bytes held in slabs, allocated or not
+		size_t slabBytes;
+		/// requests not handled by the pool (too small or too large)
+		size_t numExternalAllocs;
+
+		std::vector<ClassStats> classes;
+	};
+
 	CMemPool();
 	~CMemPool();
 
 	void* Alloc(size_t numBytes);
 	void Free(void* pnt, size_t numBytes);
 
+	/// releases slabs without allocated blocks, returns the number of bytes freed
+	size_t Trim();
+
+	void GetStats(Stats* stats) const;
+
+	static const size_t NUM_SIZE_CLASSES = 28;
+	static const size_t SLAB_SIZE = 64 * 1024;
+
 private:
+	struct SizeClass {
+		mutable boost::mutex mutex;
+
+		/// singly-linked list of free blocks, excluding those in thread-caches
+		void* freeList;
+		/// slab addresses, sorted so Trim can map blocks to their slab
+		std::vector<char*> slabs;
+
+		size_t blockSize;
+		size_t blocksPerSlab;
+		/// blocks moved between a thread-cache and the free-list at once
+		size_t batchSize;
+
+		std::atomic<size_t> numAllocs;
+		std::atomic<size_t> numCacheHits;
+		std::atomic<size_t> numSlabAllocs;
+	};
+
+	struct ThreadCache;
+
 	static bool UseExternalMemory(size_t numBytes) {
-		return (numBytes > MAX_MEM_SIZE) || (numBytes < 4);
+		return (numBytes > MAX_MEM_SIZE) || (numBytes == 0);
 	}
 
-	void* nextFree[MAX_MEM_SIZE + 1];
-	int poolSize[MAX_MEM_SIZE + 1];
-	std::vector<void *> allocated;
+	ThreadCache* GetThreadCache();
+	/// thread-exit cleanup, returns the cached blocks to their pool
+	static void ReleaseThreadCache(ThreadCache* cache);
+
+	void* AllocShared(size_t classIdx, ThreadCache* cache);
+	void DrainCache(size_t classIdx, ThreadCache* cache, size_t numBlocks);
+	void AddSlab(SizeClass& sc);
+
+	void AddLiveBytes(size_t numBytes);
+
+private:
+	SizeClass sizeClasses[NUM_SIZE_CLASSES];
+	/// maps (numBytes + 15) / 16 to a size-class index
+	unsigned char sizeClassIndices[MAX_MEM_SIZE / 16 + 1];
+
+	/// non-zero if this pool owns the per-thread caches
+	unsigned int cacheID;
+
+	/// the calling thread's cache, owned by a thread_specific_ptr
+	static __thread ThreadCache* threadCache;
+
+	std::atomic<size_t> liveBytes;
+	std::atomic<size_t> peakBytes;
+	std::atomic<size_t> numExternalAllocs;
 };
 
 extern CMemPool mempool;
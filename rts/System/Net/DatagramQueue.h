@@ -0,0 +1,121 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _DATAGRAM_QUEUE_H
+#define _DATAGRAM_QUEUE_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <atomic>
+#include <cassert>
+#include <vector>
+
+#include "System/Misc/SpringTime.h"
+
+namespace netcode
+{
+
+struct Datagram
+{
+	boost::asio::ip::udp::endpoint endpoint;
+	std::vector<boost::uint8_t> data;
+};
+
+/**
+ * @brief Bounded single-producer single-consumer ring of UDP datagrams
+ * Push and Pop never take a lock; the mutex is only touched when the
+ * consumer went to sleep in WaitForData and has to be woken up again.
+ * Slot buffers are recycled, so a warmed-up queue does not allocate.
+ */
+class DatagramQueue : boost::noncopyable
+{
+public:
+	/// @param capacity number of slots, must be a power of two
+	DatagramQueue(unsigned capacity = 1024)
+		: slots(capacity)
+		, mask(capacity - 1)
+		, head(0)
+		, tail(0)
+		, sleeping(false)
+	{
+		assert((capacity & mask) == 0);
+	}
+
+	/// producer side, returns false (dropping the datagram) when full
+	bool Push(const boost::asio::ip::udp::endpoint& endpoint, const boost::uint8_t* data, size_t length)
+	{
+		const size_t t = tail.load(std::memory_order_relaxed);
+
+		if ((t - head.load(std::memory_order_acquire)) > mask)
+			return false;
+
+		Datagram& slot = slots[t & mask];
+		slot.endpoint = endpoint;
+		slot.data.assign(data, data + length);
+		tail.store(t + 1, std::memory_order_seq_cst);
+
+		if (sleeping.load(std::memory_order_seq_cst)) {
+			boost::mutex::scoped_lock lock(mutex);
+			cond.notify_one();
+		}
+
+		return true;
+	}
+
+	/// consumer side, swaps the front datagram into <dgram>
+	bool Pop(Datagram& dgram)
+	{
+		const size_t h = head.load(std::memory_order_relaxed);
+
+		if (h == tail.load(std::memory_order_acquire))
+			return false;
+
+		Datagram& slot = slots[h & mask];
+		dgram.endpoint = slot.endpoint;
+		dgram.data.swap(slot.data);
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool Empty() const { return (head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire)); }
+
+	/// consumer side, blocks until a datagram is queued or <timeout> elapsed
+	bool WaitForData(spring_time timeout)
+	{
+		if (!Empty())
+			return true;
+
+		boost::mutex::scoped_lock lock(mutex);
+		sleeping.store(true, std::memory_order_seq_cst);
+
+		if (Empty())
+			cond.timed_wait(lock, boost::posix_time::milliseconds(spring_tomsecs(timeout)));
+
+		sleeping.store(false, std::memory_order_relaxed);
+		return !Empty();
+	}
+
+	/// wake up a consumer blocked in WaitForData (e.g. for shutdown)
+	void Notify()
+	{
+		boost::mutex::scoped_lock lock(mutex);
+		cond.notify_all();
+	}
+
+private:
+	std::vector<Datagram> slots;
+	const size_t mask;
+
+	std::atomic<size_t> head;
+	std::atomic<size_t> tail;
+	std::atomic<bool> sleeping;
+
+	boost::mutex mutex;
+	boost::condition_variable cond;
+};
+
+}
+
+#endif // _DATAGRAM_QUEUE_H
@@ -3,6 +3,9 @@
 #include "Socket.h"
 
 #include <boost/system/error_code.hpp>
+#ifndef _WIN32
+	#include <sys/select.h>
+#endif
 #include "lib/streflop/streflop_cond.h"
 
 #include "System/Log/ILog.h"
@@ -113,5 +116,23 @@ boost::asio::ip::address GetAnyAddress(const bool IPv6)
 }
 
 
+bool WaitForReadable(boost::asio::ip::udp::socket& socket, int timeoutMs)
+{
+	// asio offers no synchronous wait with timeout, use select directly
+	// (on windows the first argument is ignored)
+	const boost::asio::ip::udp::socket::native_handle_type fd = socket.native_handle();
+
+	fd_set readSet;
+	FD_ZERO(&readSet);
+	FD_SET(fd, &readSet);
+
+	timeval tv;
+	tv.tv_sec = timeoutMs / 1000;
+	tv.tv_usec = (timeoutMs % 1000) * 1000;
+
+	return (select(int(fd) + 1, &readSet, NULL, NULL, &tv) > 0);
+}
+
+
 } // namespace netcode
 
@@ -52,6 +52,13 @@ boost::asio::ip::udp::resolver::iterator WrapResolve(
 
 boost::asio::ip::address GetAnyAddress(const bool IPv6);
 
+/**
+ * Blocks until data can be read from the socket without blocking,
+ * or until the timeout elapsed.
+ * @returns true if the socket is readable
+ */
+bool WaitForReadable(boost::asio::ip::udp::socket& socket, int timeoutMs);
+
 } // namespace netcode
 
 #endif // SOCKET_H
@@ -8,6 +8,7 @@
 
 
 #include "Socket.h"
+#include "DatagramQueue.h"
 #include "ProtocolDef.h"
 #include "Exception.h"
 #include "Net/Protocol/BaseNetProtocol.h"
@@ -306,6 +307,7 @@ void UDPConnection::Init()
 	resentChunks = 0;
 	sentPackets = recvPackets = 0;
 	droppedChunks = 0;
+	droppedPackets = 0;
 	mtu = globalConfig->mtu;
 	reconnectTime = globalConfig->reconnectTimeout;
 
@@ -329,12 +331,13 @@ void UDPConnection::ReconnectTo(CConnection& conn) {
 }
 
 void UDPConnection::CopyConnection(UDPConnection &conn) {
-	conn.InitConnection(addr, mySocket);
+	conn.InitConnection(addr, mySocket, sendQueue);
 }
 
-void UDPConnection::InitConnection(ip::udp::endpoint address, boost::shared_ptr<ip::udp::socket> socket) {
+void UDPConnection::InitConnection(ip::udp::endpoint address, boost::shared_ptr<ip::udp::socket> socket, boost::shared_ptr<DatagramQueue> queue) {
 	addr = address;
 	mySocket = socket;
+	sendQueue = queue;
 }
 
 UDPConnection::~UDPConnection()
@@ -735,6 +738,8 @@ std::string UDPConnection::Statistics() const
 			%SafeDivide(sentOverhead, dataSent) %SafeDivide(recvOverhead, dataRecv) );
 	msg += str( boost::format("%1% incoming chunks dropped, %2% outgoing chunks resent\n")
 			%droppedChunks %resentChunks);
+	msg += str( boost::format("%1% outgoing packets dropped (send-queue full)\n")
+			%droppedPackets);
 	return msg;
 }
 
@@ -947,7 +952,15 @@ void UDPConnection::SendPacket(Packet& pkt)
 	boost::system::error_code err;
 
 	EMULATE_LATENCY( !EMULATE_PACKET_LOSS( LOSS_COUNTER ) ) {
-		mySocket->send_to(buffer(data), addr, flags, err);
+		if (!sendQueue) {
+			mySocket->send_to(buffer(data), addr, flags, err);
+		} else {
+			// the sender thread must remain the only writer to the socket;
+			// if it can not keep up the datagram is dropped like one lost
+			// on the wire, and the chunks it carried are resent later
+			if (!sendQueue->Push(addr, &data[0], data.size()))
+				++droppedPackets;
+		}
 	}
 
 	if (CheckErrorCode(err))
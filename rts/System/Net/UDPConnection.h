@@ -17,6 +17,8 @@ class CRC;
 
 namespace netcode {
 
+class DatagramQueue;
+
 // for reliability testing, introduce fake packet loss with a percentage probability
 #define NETWORK_TEST 0                        // in [0, 1] // enable network reliability testing mode
 #define PACKET_LOSS_FACTOR 50                 // in [0, 100)
@@ -124,9 +126,19 @@ public:
 
 	const boost::asio::ip::udp::endpoint &GetEndpoint() const { return addr; }
 
+	/**
+	 * @brief Hand outgoing packets to a sender thread instead of the socket
+	 * Only meaningful for connections sharing the socket of an UDPListener,
+	 * pass an empty pointer to write to the socket directly again. While a
+	 * queue is set the connection never touches the socket itself, packets
+	 * that do not fit are dropped and recovered by the resend logic.
+	 */
+	void SetSendQueue(boost::shared_ptr<DatagramQueue> queue) { sendQueue = queue; }
+
 private:
 	void InitConnection(boost::asio::ip::udp::endpoint address,
-			boost::shared_ptr<boost::asio::ip::udp::socket> socket);
+			boost::shared_ptr<boost::asio::ip::udp::socket> socket,
+			boost::shared_ptr<DatagramQueue> queue);
 
 	void CopyConnection(UDPConnection& conn);
 
@@ -200,6 +212,8 @@ private:
 
 	/// Our socket
 	boost::shared_ptr<boost::asio::ip::udp::socket> mySocket;
+	/// if set, outgoing packets are written to mySocket by another thread
+	boost::shared_ptr<DatagramQueue> sendQueue;
 
 	RawPacket* fragmentBuffer;
 
@@ -219,6 +233,8 @@ private:
 	/// packets that are resent
 	unsigned int resentChunks;
 	unsigned int droppedChunks;
+	/// outgoing packets dropped because the send-queue was full
+	unsigned int droppedPackets;
 
 	unsigned int sentOverhead, recvOverhead;
 	unsigned int sentPackets, recvPackets;
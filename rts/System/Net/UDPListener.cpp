@@ -10,6 +10,8 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/asio.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 #include <list>
 #include <queue>
 
@@ -26,8 +28,15 @@ namespace netcode
 {
 using namespace boost::asio;
 
+/// largest datagram we expect to read in one go (see UDPConnection)
+static const size_t udpMaxPacketSize = 4096;
+
 UDPListener::UDPListener(int port, const std::string& ip)
 	: acceptNewConnections(false)
+	, recvThread(NULL)
+	, sendThread(NULL)
+	, stopIOThreads(false)
+	, droppedDatagrams(0)
 {
 	SocketPtr socket;
 
@@ -105,57 +114,34 @@ std::string UDPListener::TryBindSocket(int port, SocketPtr* socket, const std::s
 	return errorMsg;
 }
 
+UDPListener::~UDPListener()
+{
+	StopIOThreads();
+}
+
 void UDPListener::Update() {
 	netservice.poll();
 
-	size_t bytes_avail = 0;
-
-	while ((bytes_avail = mySocket->available()) > 0) {
-		std::vector<boost::uint8_t> buffer(bytes_avail);
-		ip::udp::endpoint sender_endpoint;
-		boost::asio::ip::udp::socket::message_flags flags = 0;
-		boost::system::error_code err;
-		size_t bytesReceived = mySocket->receive_from(boost::asio::buffer(buffer), sender_endpoint, flags, err);
-
-		ConnMap::iterator ci = conn.find(sender_endpoint);
-		bool knownConnection = (ci != conn.end());
-
-		if (knownConnection && ci->second.expired())
-			continue;
+	if (HasIOThreads()) {
+		Datagram dgram;
 
-		if (CheckErrorCode(err))
-			break;
+		while (incoming.Pop(dgram)) {
+			ProcessDatagram(dgram.endpoint, &dgram.data[0], dgram.data.size());
+		}
+	} else {
+		size_t bytes_avail = 0;
 
-		if (bytesReceived < Packet::headerSize)
-			continue;
+		while ((bytes_avail = mySocket->available()) > 0) {
+			std::vector<boost::uint8_t> buffer(bytes_avail);
+			ip::udp::endpoint sender_endpoint;
+			boost::asio::ip::udp::socket::message_flags flags = 0;
+			boost::system::error_code err;
+			size_t bytesReceived = mySocket->receive_from(boost::asio::buffer(buffer), sender_endpoint, flags, err);
 
-		Packet data(&buffer[0], bytesReceived);
+			if (CheckErrorCode(err))
+				break;
 
-		if (knownConnection) {
-			ci->second.lock()->ProcessRawPacket(data);
-		}
-		else { // still have the packet (means no connection with the sender's address found)
-			if (acceptNewConnections && data.lastContinuous == -1 && data.nakType == 0)	{
-				if (!data.chunks.empty() && (*data.chunks.begin())->chunkNumber == 0) {
-					// new client wants to connect
-					boost::shared_ptr<UDPConnection> incoming(new UDPConnection(mySocket, sender_endpoint));
-					waiting.push(incoming);
-					conn[sender_endpoint] = incoming;
-					incoming->ProcessRawPacket(data);
-				}
-			}
-			else {
-				LOG_L(L_WARNING, "Dropping packet from unknown IP: [%s]:%i",
-						sender_endpoint.address().to_string().c_str(),
-						sender_endpoint.port());
-			#ifdef DEBUG
-				std::string conns;
-				for (ConnMap::iterator it = conn.begin(); it != conn.end(); ++it) {
-					conns += str(boost::format(" [%s]:%i;") %it->first.address().to_string().c_str() %it->first.port());
-				}
-				LOG_L(L_DEBUG, "Open connections: %s", conns.c_str());
-			#endif
-			}
+			ProcessDatagram(sender_endpoint, &buffer[0], bytesReceived);
 		}
 	}
 
@@ -170,9 +156,158 @@ void UDPListener::Update() {
 	}
 }
 
+void UDPListener::ProcessDatagram(const ip::udp::endpoint& sender_endpoint, const boost::uint8_t* buffer, size_t bytesReceived)
+{
+	ConnMap::iterator ci = conn.find(sender_endpoint);
+	bool knownConnection = (ci != conn.end());
+
+	if (knownConnection && ci->second.expired())
+		return;
+
+	if (bytesReceived < Packet::headerSize)
+		return;
+
+	Packet data(buffer, bytesReceived);
+
+	if (knownConnection) {
+		ci->second.lock()->ProcessRawPacket(data);
+	}
+	else { // still have the packet (means no connection with the sender's address found)
+		if (acceptNewConnections && data.lastContinuous == -1 && data.nakType == 0)	{
+			if (!data.chunks.empty() && (*data.chunks.begin())->chunkNumber == 0) {
+				// new client wants to connect
+				boost::shared_ptr<UDPConnection> incoming(new UDPConnection(mySocket, sender_endpoint));
+				incoming->SetSendQueue(outgoing);
+				waiting.push(incoming);
+				conn[sender_endpoint] = incoming;
+				incoming->ProcessRawPacket(data);
+			}
+		}
+		else {
+			LOG_L(L_WARNING, "Dropping packet from unknown IP: [%s]:%i",
+					sender_endpoint.address().to_string().c_str(),
+					sender_endpoint.port());
+		#ifdef DEBUG
+			std::string conns;
+			for (ConnMap::iterator it = conn.begin(); it != conn.end(); ++it) {
+				conns += str(boost::format(" [%s]:%i;") %it->first.address().to_string().c_str() %it->first.port());
+			}
+			LOG_L(L_DEBUG, "Open connections: %s", conns.c_str());
+		#endif
+		}
+	}
+}
+
+
+void UDPListener::StartIOThreads()
+{
+	if (HasIOThreads())
+		return;
+
+	stopIOThreads = false;
+	outgoing.reset(new DatagramQueue());
+
+	for (ConnMap::iterator i = conn.begin(); i != conn.end(); ++i) {
+		if (!i->second.expired())
+			i->second.lock()->SetSendQueue(outgoing);
+	}
+
+	recvThread = new boost::thread(boost::bind(&UDPListener::ReceiveLoop, this));
+	sendThread = new boost::thread(boost::bind(&UDPListener::SendLoop, this));
+}
+
+void UDPListener::StopIOThreads()
+{
+	if (!HasIOThreads())
+		return;
+
+	stopIOThreads = true;
+	outgoing->Notify();
+	recvThread->join();
+	sendThread->join();
+	delete recvThread;
+	delete sendThread;
+	recvThread = NULL;
+	sendThread = NULL;
+
+	// connections fall back to writing to the socket themselves
+	for (ConnMap::iterator i = conn.begin(); i != conn.end(); ++i) {
+		if (!i->second.expired())
+			i->second.lock()->SetSendQueue(boost::shared_ptr<DatagramQueue>());
+	}
+
+	// flush what was queued but not yet sent
+	Datagram dgram;
+	boost::system::error_code err;
+	while (outgoing->Pop(dgram)) {
+		mySocket->send_to(boost::asio::buffer(dgram.data), dgram.endpoint, 0, err);
+	}
+	outgoing.reset();
+
+	if (droppedDatagrams > 0)
+		LOG_L(L_WARNING, "[UDPListener] dropped %u incoming datagrams (queue full)", droppedDatagrams.load());
+}
+
+bool UDPListener::WaitForData(spring_time timeout)
+{
+	if (!HasIOThreads()) {
+		spring_sleep(timeout);
+		return true;
+	}
+
+	return incoming.WaitForData(timeout);
+}
+
+void UDPListener::ReceiveLoop()
+{
+	std::vector<boost::uint8_t> buffer(udpMaxPacketSize);
+
+	while (!stopIOThreads) {
+		if (!WaitForReadable(*mySocket, 10))
+			continue;
+
+		size_t bytes_avail = 0;
+
+		while ((bytes_avail = mySocket->available()) > 0) {
+			if (bytes_avail > buffer.size())
+				buffer.resize(bytes_avail);
+
+			ip::udp::endpoint sender_endpoint;
+			boost::asio::ip::udp::socket::message_flags flags = 0;
+			boost::system::error_code err;
+			const size_t bytesReceived = mySocket->receive_from(boost::asio::buffer(buffer), sender_endpoint, flags, err);
+
+			if (CheckErrorCode(err))
+				break;
+
+			if (!incoming.Push(sender_endpoint, &buffer[0], bytesReceived))
+				++droppedDatagrams;
+		}
+	}
+}
+
+void UDPListener::SendLoop()
+{
+	Datagram dgram;
+
+	while (!stopIOThreads) {
+		if (!outgoing->WaitForData(spring_msecs(10)))
+			continue;
+
+		while (outgoing->Pop(dgram)) {
+			ip::udp::socket::message_flags flags = 0;
+			boost::system::error_code err;
+			mySocket->send_to(boost::asio::buffer(dgram.data), dgram.endpoint, flags, err);
+			CheckErrorCode(err);
+		}
+	}
+}
+
+
 boost::shared_ptr<UDPConnection> UDPListener::SpawnConnection(const std::string& ip, const unsigned port)
 {
 	boost::shared_ptr<UDPConnection> newConn(new UDPConnection(mySocket, ip::udp::endpoint(WrapIP(ip), port)));
+	newConn->SetSendQueue(outgoing);
 	conn[newConn->GetEndpoint()] = newConn;
 	return newConn;
 }
@@ -7,11 +7,18 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
 #include <boost/asio/ip/udp.hpp>
+#include <atomic>
 #include <list>
 #include <map>
 #include <queue>
 #include <string>
 
+#include "DatagramQueue.h"
+
+namespace boost {
+	class thread;
+}
+
 namespace netcode
 {
 class UDPConnection;
@@ -37,7 +44,7 @@ public:
 	/**
 	 * @brief close the socket and DELETE all connections
 	 */
-	~UDPListener() {}
+	~UDPListener();
 
 	/**
 	 * Try to bind a socket to a local address and port.
@@ -59,6 +66,23 @@ public:
 	 */
 	void Update();
 
+	/**
+	 * @brief Move socket I/O onto dedicated threads
+	 * A receiver thread drains the socket into a queue which Update() then
+	 * dispatches to the connections, and a sender thread writes out the
+	 * datagrams our connections queue up, so neither a slow client nor a
+	 * burst of incoming packets stalls the thread calling Update().
+	 */
+	void StartIOThreads();
+	void StopIOThreads();
+	bool HasIOThreads() const { return (recvThread != NULL); }
+
+	/**
+	 * @brief Block until received datagrams are waiting for Update()
+	 * Without I/O threads this simply sleeps for <timeout>.
+	 */
+	bool WaitForData(spring_time timeout);
+
 	/**
 	 * @brief Initiate a connection
 	 * Make a new connection to ip:port. It will be pushed back in conn.
@@ -81,6 +105,12 @@ public:
 	void UpdateConnections(); // Updates connections when the endpoint has been reconnected
 
 private:
+	void ReceiveLoop();
+	void SendLoop();
+
+	/// hand a received datagram to its connection or open a new one
+	void ProcessDatagram(const boost::asio::ip::udp::endpoint& sender, const boost::uint8_t* data, size_t length);
+
 	/**
 	 * @brief Do we accept packets from unknown sources?
 	 * If true, we will create a new connection, if false, they get dropped.
@@ -96,6 +126,16 @@ private:
 	ConnMap conn;
 
 	std::queue< boost::shared_ptr<UDPConnection> > waiting;
+
+	/// datagrams read by recvThread, consumed by Update()
+	DatagramQueue incoming;
+	/// datagrams queued by our connections, consumed by sendThread
+	boost::shared_ptr<DatagramQueue> outgoing;
+
+	boost::thread* recvThread;
+	boost::thread* sendThread;
+	std::atomic<bool> stopIOThreads;
+	std::atomic<unsigned int> droppedDatagrams;
 };
 
 }
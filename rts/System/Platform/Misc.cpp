@@ -42,6 +42,7 @@
 #include <fstream>
 #endif
 
+#include <cstdio>
 #include <cstring>
 #include <cerrno>
 
@@ -427,6 +428,25 @@ bool IsRunningInGDB() {
 	#endif
 }
 
+size_t GetProcessMemoryUsage() {
+	#if defined(__linux__) || defined(__FreeBSD__)
+	// second field is the resident set size, in pages
+	FILE* f = fopen("/proc/self/statm", "r");
+	unsigned long numPages = 0;
+
+	if (f == NULL)
+		return 0;
+
+	if (fscanf(f, "%*u %lu", &numPages) != 1)
+		numPages = 0;
+
+	fclose(f);
+	return (numPages * sysconf(_SC_PAGESIZE));
+	#else
+	return 0;
+	#endif
+}
+
 std::string GetShortFileName(const std::string& file) {
 #ifdef WIN32
 	std::vector<TCHAR> shortPathC(file.size() + 1, 0);
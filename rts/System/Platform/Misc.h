@@ -85,6 +85,12 @@ bool Is64Bit();
 bool Is32BitEmulation();
 bool IsRunningInGDB();
 
+/**
+ * Returns the resident memory of this process in bytes,
+ * or 0 on platforms where this is not implemented (Windows).
+ */
+size_t GetProcessMemoryUsage();
+
 /**
  * Executes a native binary, file and args have to be not escaped!
  * http://linux.die.net/man/3/execvp
@@ -622,6 +622,7 @@ void SpringApp::ParseCmdLine(const std::string& binaryName)
 	cmdline->AddSwitch('t', "textureatlas",       "Dump each finalized textureatlas in textureatlasN.tga");
 	cmdline->AddInt(   0,   "benchmark",          "Enable benchmark mode (writes a benchmark.data file). The given number specifies the timespan to test.");
 	cmdline->AddInt(   0,   "benchmarkstart",     "Benchmark start time in minutes.");
+	cmdline->AddString(0,   "benchmark-scenario", "Built-in load to spawn during the benchmark (masspathing, artillery, losstress or factories); also writes benchmark.json");
 
 	cmdline->AddSwitch(0,   "list-ai-interfaces", "Dump a list of available AI Interfaces to stdout");
 	cmdline->AddSwitch(0,   "list-skirmish-ais",  "Dump a list of available Skirmish AIs to stdout");
@@ -741,6 +742,9 @@ void SpringApp::ParseCmdLine(const std::string& binaryName)
 			CBenchmark::startFrame = cmdline->GetInt("benchmarkstart") * 60 * GAME_SPEED;
 		}
 		CBenchmark::endFrame = CBenchmark::startFrame + cmdline->GetInt("benchmark") * 60 * GAME_SPEED;
+		if (cmdline->IsSet("benchmark-scenario")) {
+			CBenchmark::scenarioName = cmdline->GetString("benchmark-scenario");
+		}
 	}
 }
 
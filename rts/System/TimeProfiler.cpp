@@ -2,10 +2,12 @@
 
 #include "System/TimeProfiler.h"
 
+#include <cstdio>
 #include <cstring>
 #include <boost/unordered_map.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/locks.hpp>
+#include <boost/thread/thread.hpp>
 
 #include "System/Log/ILog.h"
 #include "System/UnsyncedRNG.h"
@@ -17,6 +19,16 @@ static boost::mutex m;
 static std::map<int, std::string> hashToName;
 static std::map<int, int> refs;
 
+// interned trace scope names; a deque keeps references stable
+static boost::mutex scopeMutex;
+static boost::unordered_map<std::string, unsigned> scopeIDs;
+static std::deque<std::string> scopeNames;
+
+// buffers outlive their threads so a trace can still be exported
+static boost::mutex traceMutex;
+static std::vector<CTimeProfiler::TraceBuffer*> traceBuffers;
+static __thread CTimeProfiler::TraceBuffer* threadTraceBuffer = NULL;
+
 
 
 static unsigned hash_(const std::string& s)
@@ -44,9 +56,39 @@ static unsigned hash_(const char* s)
 }
 
 
+ScopedTraceEvent::ScopedTraceEvent(unsigned id)
+	: scopeID(id)
+	, traced(profiler.IsTracing())
+{
+	if (!traced)
+		return;
+
+	starttime = spring_gettime();
+	CTimeProfiler::GetThreadTraceBuffer()->depth++;
+}
+
+ScopedTraceEvent::~ScopedTraceEvent()
+{
+	if (!traced)
+		return;
+
+	CTimeProfiler::TraceBuffer* buffer = CTimeProfiler::GetThreadTraceBuffer();
+	CTimeProfiler::TraceEvent event;
+
+	event.begin = starttime;
+	event.end = spring_gettime();
+	event.scopeID = scopeID;
+	event.depth = --(buffer->depth);
+
+	profiler.AddTraceEvent(buffer, event);
+}
+
+
+
 BasicTimer::BasicTimer(const std::string& myname)
 : hash(hash_(myname))
 , starttime(spring_gettime())
+, traceEvent(CTimeProfiler::GetScopeID(myname))
 
 {
 	nameIterator = hashToName.find(hash);
@@ -59,6 +101,20 @@ BasicTimer::BasicTimer(const std::string& myname)
 BasicTimer::BasicTimer(const char* myname)
 : hash(hash_(myname))
 , starttime(spring_gettime())
+, traceEvent(CTimeProfiler::GetScopeID(myname))
+
+{
+	nameIterator = hashToName.find(hash);
+	if (nameIterator == hashToName.end()) {
+		nameIterator = hashToName.insert(std::pair<int,std::string>(hash, myname)).first;
+	}
+}
+
+
+BasicTimer::BasicTimer(const char* myname, unsigned id)
+: hash(hash_(myname))
+, starttime(spring_gettime())
+, traceEvent(id)
 
 {
 	nameIterator = hashToName.find(hash);
@@ -100,6 +156,19 @@ ScopedTimer::ScopedTimer(const char* name, bool autoShow)
 }
 
 
+ScopedTimer::ScopedTimer(const char* name, unsigned id, bool autoShow)
+	: BasicTimer(name, id)
+	, autoShowGraph(autoShow)
+
+{
+	it = refs.find(hash);
+	if (it == refs.end()) {
+		it = refs.insert(std::pair<int,int>(hash, 0)).first;
+	}
+	++(it->second);
+}
+
+
 ScopedTimer::~ScopedTimer()
 {
 	int& ref = it->second;
@@ -128,6 +197,13 @@ ScopedMtTimer::ScopedMtTimer(const char* name, bool autoShow)
 }
 
 
+ScopedMtTimer::ScopedMtTimer(const char* name, unsigned id, bool autoShow)
+	: BasicTimer(name, id)
+	, autoShowGraph(autoShow)
+{
+}
+
+
 ScopedMtTimer::~ScopedMtTimer()
 {
 	profiler.AddTime(GetName(), spring_difftime(spring_gettime(), starttime), autoShowGraph);
@@ -144,6 +220,7 @@ ScopedMtTimer::~ScopedMtTimer()
 //////////////////////////////////////////////////////////////////////
 
 CTimeProfiler::CTimeProfiler():
+	tracing(false),
 	lastBigUpdate(spring_gettime()),
 	currentPosition(0)
 {
@@ -210,6 +287,32 @@ float CTimeProfiler::GetPercent(const char* name)
 	return profile[name].percent;
 }
 
+spring_time CTimeProfiler::GetTimeRecordTotal(const std::string& name) const
+{
+	// AddTime inserts new records from other threads under <m>
+	boost::unique_lock<boost::mutex> ulk(m, boost::defer_lock);
+	while (!ulk.try_lock()) {}
+
+	const auto pi = profile.find(name);
+
+	if (pi == profile.end())
+		return spring_notime;
+
+	return pi->second.total;
+}
+
+void CTimeProfiler::GetTimeRecordTotals(std::map<std::string, spring_time>& totals) const
+{
+	boost::unique_lock<boost::mutex> ulk(m, boost::defer_lock);
+	while (!ulk.try_lock()) {}
+
+	totals.clear();
+
+	for (auto pi = profile.begin(); pi != profile.end(); ++pi) {
+		totals[pi->first] = pi->second.total;
+	}
+}
+
 void CTimeProfiler::AddTime(const std::string& name, const spring_time time, const bool showGraph)
 {
 	auto pi = profile.find(name);
@@ -255,3 +358,117 @@ void CTimeProfiler::PrintProfilingInfo() const
 		LOG("%35s %16.2fms %5.2f%%", name.c_str(), tr.total.toMilliSecsf(), tr.percent * 100);
 	}
 }
+
+
+
+unsigned CTimeProfiler::GetScopeID(const std::string& name)
+{
+	boost::mutex::scoped_lock lock(scopeMutex);
+
+	const boost::unordered_map<std::string, unsigned>::const_iterator it = scopeIDs.find(name);
+
+	if (it != scopeIDs.end())
+		return it->second;
+
+	scopeNames.push_back(name);
+	return (scopeIDs[name] = scopeNames.size() - 1);
+}
+
+const std::string& CTimeProfiler::GetScopeName(unsigned id)
+{
+	boost::mutex::scoped_lock lock(scopeMutex);
+	return scopeNames[id];
+}
+
+
+CTimeProfiler::TraceBuffer* CTimeProfiler::GetThreadTraceBuffer()
+{
+	if (threadTraceBuffer != NULL)
+		return threadTraceBuffer;
+
+	boost::mutex::scoped_lock lock(traceMutex);
+
+	// allocated on first traced scope, threads that never
+	// run one while tracing is enabled do not pay for it
+	threadTraceBuffer = new TraceBuffer(traceBuffers.size());
+	traceBuffers.push_back(threadTraceBuffer);
+	return threadTraceBuffer;
+}
+
+
+void CTimeProfiler::AddTraceEvent(TraceBuffer* buffer, const TraceEvent& e)
+{
+	// scopes opened before tracing was stopped end while WriteTrace may
+	// already be reading the ring; announcing the write before checking
+	// <tracing> again (both seq_cst, as in SetTracing and WriteTrace)
+	// means either this thread sees tracing stopped and drops the event,
+	// or WriteTrace sees <writing> and waits for the event to be added
+	buffer->writing.store(true);
+
+	if (tracing.load())
+		buffer->AddEvent(e);
+
+	buffer->writing.store(false, std::memory_order_release);
+}
+
+void CTimeProfiler::SetTracing(bool enable)
+{
+	tracing.store(enable);
+}
+
+
+static void WriteEscaped(FILE* file, const std::string& str)
+{
+	for (std::string::const_iterator it = str.begin(); it != str.end(); ++it) {
+		if (*it == '"' || *it == '\\')
+			fputc('\\', file);
+		if (*it >= ' ')
+			fputc(*it, file);
+	}
+}
+
+bool CTimeProfiler::WriteTrace(const std::string& fileName) const
+{
+	if (tracing.load())
+		return false;
+
+	FILE* file = fopen(fileName.c_str(), "w");
+
+	if (file == NULL)
+		return false;
+
+	boost::mutex::scoped_lock lock(traceMutex);
+
+	// wait out events that were being added when tracing stopped, no
+	// thread adds any more after that (see AddTraceEvent)
+	for (unsigned int i = 0; i < traceBuffers.size(); i++) {
+		while (traceBuffers[i]->writing.load())
+			boost::this_thread::yield();
+	}
+
+	const char* sep = "";
+	fprintf(file, "{\"traceEvents\":[");
+
+	for (unsigned int i = 0; i < traceBuffers.size(); i++) {
+		const TraceBuffer* buffer = traceBuffers[i];
+
+		const unsigned numEvents = buffer->numEvents.load(std::memory_order_acquire);
+		const unsigned numKept = (numEvents < TraceBuffer::NUM_EVENTS)? numEvents: TraceBuffer::NUM_EVENTS;
+
+		// oldest event still in the ring first
+		for (unsigned int n = numEvents - numKept; n != numEvents; n++) {
+			const TraceEvent& e = buffer->events[n & (TraceBuffer::NUM_EVENTS - 1)];
+
+			fprintf(file, "%s\n{\"name\":\"", sep);
+			WriteEscaped(file, GetScopeName(e.scopeID));
+			fprintf(file, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"depth\":%u}}",
+				buffer->threadIdx, e.begin.toMicroSecs<double>(), (e.end - e.begin).toMicroSecs<double>(), e.depth);
+
+			sep = ",";
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+	return true;
+}
@@ -7,6 +7,7 @@
 #include "System/float3.h"
 
 #include <boost/noncopyable.hpp>
+#include <atomic>
 #include <cstring>
 #include <string>
 #include <map>
@@ -15,8 +16,29 @@
 
 // disable this if you want minimal profiling
 // (sim time is still measured because of game slowdown)
-#define SCOPED_TIMER(name) ScopedTimer myScopedTimerFromMakro(name);
-#define SCOPED_MT_TIMER(name) ScopedMtTimer myScopedTimerFromMakro(name);
+// NOTE: the scope-ID is interned once per call-site, so <name> must not vary
+#define SCOPED_TIMER(name) static const unsigned myScopeIdFromMakro = CTimeProfiler::GetScopeID(name); ScopedTimer myScopedTimerFromMakro(name, myScopeIdFromMakro);
+#define SCOPED_MT_TIMER(name) static const unsigned myScopeIdFromMakro = CTimeProfiler::GetScopeID(name); ScopedMtTimer myScopedTimerFromMakro(name, myScopeIdFromMakro);
+// only shows up in traces, has no TimeRecord (i.e. no "/debuginfo profiling" entry)
+#define SCOPED_TRACE(name) static const unsigned myScopeIdFromMakro = CTimeProfiler::GetScopeID(name); ScopedTraceEvent myScopedTraceFromMakro(myScopeIdFromMakro);
+
+
+/**
+ * @brief Records a begin/end event into the calling thread's trace buffer
+ *
+ * Costs a single relaxed atomic load while tracing is disabled.
+ */
+class ScopedTraceEvent : public boost::noncopyable
+{
+public:
+	ScopedTraceEvent(unsigned id);
+	~ScopedTraceEvent();
+
+private:
+	const unsigned scopeID;
+	spring_time starttime;
+	bool traced;
+};
 
 
 class BasicTimer : public boost::noncopyable
@@ -24,6 +46,7 @@ class BasicTimer : public boost::noncopyable
 public:
 	BasicTimer(const std::string& myname);
 	BasicTimer(const char* myname);
+	BasicTimer(const char* myname, unsigned id);
 
 	const std::string& GetName() const;
 
@@ -31,6 +54,8 @@ protected:
 	const unsigned hash;
 	const spring_time starttime;
 	std::map<int, std::string>::iterator nameIterator;
+
+	ScopedTraceEvent traceEvent;
 };
 
 
@@ -45,6 +70,7 @@ class ScopedTimer : public BasicTimer
 public:
 	ScopedTimer(const std::string& name, bool autoShow = false);
 	ScopedTimer(const char* name, bool autoShow = false);
+	ScopedTimer(const char* name, unsigned id, bool autoShow = false);
 	~ScopedTimer();
 
 private:
@@ -58,6 +84,7 @@ class ScopedMtTimer : public BasicTimer
 public:
 	ScopedMtTimer(const std::string& name, bool autoShow = false);
 	ScopedMtTimer(const char* name, bool autoShow = false);
+	ScopedMtTimer(const char* name, unsigned id, bool autoShow = false);
 	~ScopedMtTimer();
 
 private:
@@ -89,12 +116,66 @@ public:
 	static CTimeProfiler& GetInstance();
 
 	float GetPercent(const char *name);
+	/// total time of record <name> (spring_notime if there is none), safe from any thread
+	spring_time GetTimeRecordTotal(const std::string& name) const;
+	/// same for all records at once
+	void GetTimeRecordTotals(std::map<std::string, spring_time>& totals) const;
 	void Update();
 
 	void PrintProfilingInfo() const;
 
 	void AddTime(const std::string& name, const spring_time time, const bool showGraph = false);
 
+	/// returns the (process-wide) ID for a trace scope name, interning it if new
+	static unsigned GetScopeID(const std::string& name);
+	static const std::string& GetScopeName(unsigned id);
+
+	/// start or stop recording trace events on all threads
+	void SetTracing(bool enable);
+	bool IsTracing() const { return tracing.load(std::memory_order_relaxed); }
+
+	/**
+	 * Writes the events still held by the per-thread ring buffers in
+	 * Chrome trace-event format (chrome://tracing, ui.perfetto.dev).
+	 * Tracing must be stopped first; scopes that were still open at
+	 * that point are not part of the trace.
+	 */
+	bool WriteTrace(const std::string& fileName) const;
+
+public:
+	struct TraceEvent {
+		spring_time begin;
+		spring_time end;
+		unsigned scopeID;
+		unsigned depth;
+	};
+
+	/// single-writer ring of the most recent events of one thread
+	struct TraceBuffer {
+		static const unsigned NUM_EVENTS = 1 << 16;
+
+		TraceBuffer(unsigned idx): threadIdx(idx), depth(0), writing(false), numEvents(0), events(NUM_EVENTS) {}
+
+		void AddEvent(const TraceEvent& e) {
+			const unsigned n = numEvents.load(std::memory_order_relaxed);
+			events[n & (NUM_EVENTS - 1)] = e;
+			numEvents.store(n + 1, std::memory_order_release);
+		}
+
+		const unsigned threadIdx;
+		/// nesting level of the currently open scopes
+		unsigned depth;
+		/// set while the owning thread may be adding an event, see AddTraceEvent
+		std::atomic<bool> writing;
+
+		std::atomic<unsigned> numEvents;
+		std::vector<TraceEvent> events;
+	};
+
+	static TraceBuffer* GetThreadTraceBuffer();
+	/// adds <e> to <buffer> unless tracing was stopped meanwhile
+	void AddTraceEvent(TraceBuffer* buffer, const TraceEvent& e);
+
 public:
 	struct TimeRecord {
 		TimeRecord()
@@ -128,6 +209,8 @@ public:
 	std::vector<std::deque<std::pair<spring_time,spring_time>>> profileCore;
 
 private:
+	std::atomic<bool> tracing;
+
 	spring_time lastBigUpdate;
 	/// increases each update, from 0 to (frames_size-1)
 	unsigned currentPosition;
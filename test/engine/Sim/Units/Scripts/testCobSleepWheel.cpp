@@ -0,0 +1,201 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Units/Scripts/CobSleepWheel.h"
+
+#include <algorithm>
+#include <vector>
+
+#define BOOST_TEST_MODULE CobSleepWheel
+#include <boost/test/unit_test.hpp>
+
+
+// the wheel never dereferences its threads, so ids stand in for them
+static CCobThread* ToThread(size_t id) { return reinterpret_cast<CCobThread*>((id + 1) * 16); }
+static size_t ToID(CCobThread* thread) { return (reinterpret_cast<size_t>(thread) / 16 - 1); }
+
+struct Sleeper {
+	size_t id;
+	int wakeTime;
+
+	// threads with the same wake time wake in the order they were added
+	bool operator < (const Sleeper& s) const {
+		if (wakeTime != s.wakeTime)
+			return (wakeTime < s.wakeTime);
+		return (id < s.id);
+	}
+};
+
+
+/// adds <sleepers> in id order, pops everything and checks when and in which order they woke
+static void CheckWakeOrder(CCobSleepWheel& wheel, std::vector<Sleeper> sleepers, int endTime)
+{
+	for (size_t n = 0; n < sleepers.size(); n++) {
+		wheel.Add(ToThread(sleepers[n].id), sleepers[n].wakeTime);
+	}
+
+	std::stable_sort(sleepers.begin(), sleepers.end());
+
+	size_t numWoken = 0;
+	CCobThread* thread = NULL;
+
+	while ((thread = wheel.Pop(endTime)) != NULL) {
+		BOOST_REQUIRE(numWoken < sleepers.size());
+		BOOST_CHECK_EQUAL(ToID(thread), sleepers[numWoken].id);
+		BOOST_CHECK_EQUAL(wheel.GetTime(), std::max(sleepers[numWoken].wakeTime, 0));
+		numWoken++;
+	}
+
+	BOOST_CHECK_EQUAL(numWoken, sleepers.size());
+	BOOST_CHECK(wheel.Empty());
+	BOOST_CHECK_EQUAL(wheel.GetTime(), endTime);
+}
+
+static Sleeper MakeSleeper(size_t id, int wakeTime)
+{
+	Sleeper s;
+	s.id = id;
+	s.wakeTime = wakeTime;
+	return s;
+}
+
+
+BOOST_AUTO_TEST_CASE( EqualWakeTimes )
+{
+	CCobSleepWheel wheel;
+	std::vector<Sleeper> sleepers;
+
+	for (size_t n = 0; n < 10; n++) {
+		sleepers.push_back(MakeSleeper(n, 5));
+	}
+	// in the past, woken at the current time
+	sleepers.push_back(MakeSleeper(10, -3));
+
+	CheckWakeOrder(wheel, sleepers, 10);
+}
+
+BOOST_AUTO_TEST_CASE( FarFutureWakeTimes )
+{
+	CCobSleepWheel wheel;
+	std::vector<Sleeper> sleepers;
+
+	// beyond the range of the coarsest level (1 << 26): parked
+	// and re-inserted with their real wake times on cascade
+	const int farTime = (1 << 26) + 1000;
+
+	sleepers.push_back(MakeSleeper(0, farTime + 1));
+	sleepers.push_back(MakeSleeper(1, farTime));
+	sleepers.push_back(MakeSleeper(2, 7));
+	sleepers.push_back(MakeSleeper(3, farTime));
+	sleepers.push_back(MakeSleeper(4, (1 << 26) - 1));
+	sleepers.push_back(MakeSleeper(5, farTime + (1 << 20)));
+
+	CheckWakeOrder(wheel, sleepers, farTime + (1 << 21));
+}
+
+BOOST_AUTO_TEST_CASE( CascadeBoundaries )
+{
+	const int LEVEL0_SIZE = 1 << 8;
+	const int LEVELN_SIZE = 1 << 6;
+
+	const int boundaries[] = {
+		LEVEL0_SIZE,
+		LEVEL0_SIZE * 2,
+		LEVEL0_SIZE * LEVELN_SIZE,
+		LEVEL0_SIZE * LEVELN_SIZE * 3,
+		LEVEL0_SIZE * LEVELN_SIZE * LEVELN_SIZE,
+		LEVEL0_SIZE * LEVELN_SIZE * LEVELN_SIZE * 2,
+	};
+
+	// start from 0 and from just before and after a boundary,
+	// so the same wake times land on different levels
+	const int startTimes[] = {0, LEVEL0_SIZE - 1, LEVEL0_SIZE + 1, LEVEL0_SIZE * LEVELN_SIZE - 1};
+
+	for (size_t s = 0; s < (sizeof(startTimes) / sizeof(startTimes[0])); s++) {
+		CCobSleepWheel wheel;
+		std::vector<Sleeper> sleepers;
+
+		BOOST_CHECK(wheel.Pop(startTimes[s]) == NULL);
+		BOOST_CHECK_EQUAL(wheel.GetTime(), startTimes[s]);
+
+		for (size_t b = 0; b < (sizeof(boundaries) / sizeof(boundaries[0])); b++) {
+			for (int d = -1; d <= 1; d++) {
+				sleepers.push_back(MakeSleeper(sleepers.size(), boundaries[b] + d));
+				sleepers.push_back(MakeSleeper(sleepers.size(), boundaries[b] + d));
+			}
+		}
+
+		std::vector<Sleeper> current;
+
+		for (size_t n = 0; n < sleepers.size(); n++) {
+			if (sleepers[n].wakeTime >= startTimes[s])
+				current.push_back(sleepers[n]);
+		}
+
+		CheckWakeOrder(wheel, current, boundaries[5] + LEVEL0_SIZE);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( SleepAgainWhilePopping )
+{
+	CCobSleepWheel wheel;
+
+	wheel.Add(ToThread(0), 10);
+	wheel.Add(ToThread(1), 10);
+
+	// a thread woken at 10 goes back to sleep for a full level-0 turn
+	BOOST_CHECK_EQUAL(ToID(wheel.Pop(1000)), 0u);
+	wheel.Add(ToThread(0), 10 + (1 << 8));
+	// and one that sleeps for 0ms runs again in the same slot
+	BOOST_CHECK_EQUAL(ToID(wheel.Pop(1000)), 1u);
+	wheel.Add(ToThread(1), 10);
+
+	BOOST_CHECK_EQUAL(ToID(wheel.Pop(1000)), 1u);
+	BOOST_CHECK_EQUAL(wheel.GetTime(), 10);
+	BOOST_CHECK_EQUAL(ToID(wheel.Pop(1000)), 0u);
+	BOOST_CHECK_EQUAL(wheel.GetTime(), 10 + (1 << 8));
+	BOOST_CHECK(wheel.Pop(1000) == NULL);
+	BOOST_CHECK(wheel.Empty());
+}
+
+BOOST_AUTO_TEST_CASE( RemoveWhileSleeping )
+{
+	CCobSleepWheel wheel;
+
+	// one sleeper per level, plus three sharing a slot
+	const int wakeTimes[] = {3, 3, 3, 300, 20000, 2000000, 100000000};
+	const size_t numSleepers = sizeof(wakeTimes) / sizeof(wakeTimes[0]);
+
+	for (size_t n = 0; n < numSleepers; n++) {
+		wheel.Add(ToThread(n), wakeTimes[n]);
+	}
+
+	// stop in the middle of the shared slot
+	BOOST_CHECK_EQUAL(ToID(wheel.Pop(1000)), 0u);
+
+	std::vector<CCobThread*> removed;
+	wheel.Clear(removed);
+
+	// every thread not yet woken is handed back exactly once
+	std::vector<size_t> ids;
+
+	for (size_t n = 0; n < removed.size(); n++) {
+		ids.push_back(ToID(removed[n]));
+	}
+
+	std::sort(ids.begin(), ids.end());
+
+	BOOST_REQUIRE_EQUAL(ids.size(), numSleepers - 1);
+	for (size_t n = 0; n < ids.size(); n++) {
+		BOOST_CHECK_EQUAL(ids[n], n + 1);
+	}
+
+	BOOST_CHECK(wheel.Empty());
+	BOOST_CHECK(wheel.Pop(1000) == NULL);
+	BOOST_CHECK_EQUAL(wheel.GetTime(), 1000);
+
+	// and nothing of them is left behind
+	wheel.Add(ToThread(42), 20000);
+	BOOST_CHECK_EQUAL(ToID(wheel.Pop(30000)), 42u);
+	BOOST_CHECK_EQUAL(wheel.GetTime(), 20000);
+	BOOST_CHECK(wheel.Pop(3000000) == NULL);
+}
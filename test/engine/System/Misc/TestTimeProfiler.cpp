@@ -0,0 +1,140 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#define BOOST_TEST_MODULE TimeProfiler
+#include <boost/test/unit_test.hpp>
+
+#include "System/TimeProfiler.h"
+#include "System/Misc/SpringTime.h"
+
+#include <boost/thread.hpp>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+
+struct InitSpringTime {
+	InitSpringTime() { spring_clock::PushTickRate(); spring_time::setstarttime(spring_time::gettime(true)); }
+	~InitSpringTime() { spring_clock::PopTickRate(); }
+};
+
+BOOST_GLOBAL_FIXTURE(InitSpringTime);
+
+
+static unsigned CountOccurrences(const std::string& str, const std::string& sub)
+{
+	unsigned count = 0;
+
+	for (size_t pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + sub.size())) {
+		count++;
+	}
+
+	return count;
+}
+
+static std::string ReadFile(const std::string& fileName)
+{
+	std::ifstream file(fileName.c_str());
+	std::stringstream buf;
+	buf << file.rdbuf();
+	return buf.str();
+}
+
+static void TracedWork()
+{
+	SCOPED_TRACE("TestOuter");
+
+	for (int n = 0; n < 3; n++) {
+		SCOPED_TRACE("TestInner");
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(ScopeIDs)
+{
+	const unsigned id = CTimeProfiler::GetScopeID("TestScope");
+
+	BOOST_CHECK(CTimeProfiler::GetScopeID("TestScope") == id);
+	BOOST_CHECK(CTimeProfiler::GetScopeID("OtherTestScope") != id);
+	BOOST_CHECK(CTimeProfiler::GetScopeName(id) == "TestScope");
+}
+
+
+BOOST_AUTO_TEST_CASE(Trace)
+{
+	// not recorded, tracing is off
+	TracedWork();
+
+	profiler.SetTracing(true);
+	TracedWork();
+	boost::thread worker(TracedWork);
+	worker.join();
+	profiler.SetTracing(false);
+
+	// not recorded either
+	TracedWork();
+
+	const std::string fileName = "testTimeProfiler.json";
+	BOOST_REQUIRE(profiler.WriteTrace(fileName));
+
+	const std::string trace = ReadFile(fileName);
+	std::remove(fileName.c_str());
+
+	BOOST_CHECK(trace.find("{\"traceEvents\":[") == 0);
+	BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"ph\":\"X\""), 8u);
+	BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"name\":\"TestOuter\""), 2u);
+	BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"name\":\"TestInner\""), 6u);
+	BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"depth\":0"), 2u);
+	BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"depth\":1"), 6u);
+	BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"tid\":0"), 4u);
+	BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"tid\":1"), 4u);
+}
+
+
+static void BusyWork(const std::atomic<bool>* quit)
+{
+	SCOPED_TRACE("TestBusyOuter");
+
+	while (!quit->load()) {
+		SCOPED_TRACE("TestBusyInner");
+	}
+}
+
+BOOST_AUTO_TEST_CASE(TraceWhileBusy)
+{
+	std::atomic<bool> quit(false);
+
+	profiler.SetTracing(true);
+	boost::thread worker(BusyWork, &quit);
+	boost::this_thread::sleep_for(boost::chrono::milliseconds(20));
+
+	{
+		SCOPED_TRACE("TestStillOpen");
+
+		// the worker keeps closing scopes it opened while tracing was on
+		profiler.SetTracing(false);
+
+		const std::string fileName = "testTimeProfilerBusy.json";
+		BOOST_REQUIRE(profiler.WriteTrace(fileName));
+
+		const std::string trace = ReadFile(fileName);
+		std::remove(fileName.c_str());
+
+		// scopes that were still open when tracing stopped are left out
+		BOOST_CHECK(CountOccurrences(trace, "\"name\":\"TestBusyInner\"") > 0);
+		BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"name\":\"TestBusyOuter\""), 0u);
+		BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"name\":\"TestStillOpen\""), 0u);
+	}
+
+	quit.store(true);
+	worker.join();
+
+	// and are not added afterwards either
+	const std::string fileName = "testTimeProfilerBusy.json";
+	BOOST_REQUIRE(profiler.WriteTrace(fileName));
+
+	const std::string trace = ReadFile(fileName);
+	std::remove(fileName.c_str());
+
+	BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"name\":\"TestBusyOuter\""), 0u);
+	BOOST_CHECK_EQUAL(CountOccurrences(trace, "\"name\":\"TestStillOpen\""), 0u);
+}
@@ -0,0 +1,76 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/Net/DatagramQueue.h"
+
+#include <boost/thread/thread.hpp>
+#include <cstring>
+
+#define BOOST_TEST_MODULE DatagramQueue
+#include <boost/test/unit_test.hpp>
+
+using netcode::Datagram;
+using netcode::DatagramQueue;
+
+BOOST_AUTO_TEST_CASE(PushPop)
+{
+	DatagramQueue queue(4);
+	Datagram dgram;
+	const boost::asio::ip::udp::endpoint ep(boost::asio::ip::address_v4::loopback(), 8452);
+
+	BOOST_CHECK(queue.Empty());
+	BOOST_CHECK(!queue.Pop(dgram));
+
+	for (boost::uint8_t i = 0; i < 4; ++i) {
+		BOOST_CHECK(queue.Push(ep, &i, 1));
+	}
+
+	// full
+	boost::uint8_t x = 42;
+	BOOST_CHECK(!queue.Push(ep, &x, 1));
+
+	for (boost::uint8_t i = 0; i < 4; ++i) {
+		BOOST_CHECK(queue.Pop(dgram));
+		BOOST_CHECK(dgram.endpoint == ep);
+		BOOST_CHECK(dgram.data.size() == 1 && dgram.data[0] == i);
+	}
+
+	BOOST_CHECK(queue.Empty());
+	BOOST_CHECK(!queue.WaitForData(spring_msecs(1)));
+}
+
+static void Produce(DatagramQueue* queue, unsigned count)
+{
+	const boost::asio::ip::udp::endpoint ep(boost::asio::ip::address_v4::loopback(), 8452);
+
+	for (unsigned i = 0; i < count; ) {
+		if (queue->Push(ep, reinterpret_cast<const boost::uint8_t*>(&i), sizeof(i)))
+			++i;
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ProducerConsumer)
+{
+	static const unsigned count = 100000;
+
+	DatagramQueue queue(64);
+	boost::thread producer(boost::bind(&Produce, &queue, count));
+
+	Datagram dgram;
+	unsigned expected = 0;
+
+	while (expected < count) {
+		if (!queue.WaitForData(spring_msecs(100)))
+			continue;
+
+		while (queue.Pop(dgram)) {
+			unsigned value;
+			BOOST_REQUIRE(dgram.data.size() == sizeof(value));
+			memcpy(&value, &dgram.data[0], sizeof(value));
+			BOOST_REQUIRE(value == expected);
+			++expected;
+		}
+	}
+
+	producer.join();
+	BOOST_CHECK(queue.Empty());
+}
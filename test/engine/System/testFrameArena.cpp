@@ -0,0 +1,137 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/FrameArena.h"
+
+#include <boost/thread.hpp>
+#include <cstring>
+#include <vector>
+
+#define BOOST_TEST_MODULE FrameArena
+#include <boost/test/unit_test.hpp>
+
+
+static bool IsAligned(const void* p) { return ((reinterpret_cast<size_t>(p) & 15) == 0); }
+
+
+BOOST_AUTO_TEST_CASE( Alignment )
+{
+	CFrameArena arena(1024);
+
+	for (size_t numBytes = 1; numBytes <= 100; numBytes++) {
+		void* p = arena.Alloc(numBytes);
+		BOOST_CHECK(IsAligned(p));
+		memset(p, 0xAB, numBytes);
+	}
+
+	// sizes are rounded up to the alignment
+	BOOST_CHECK(arena.GetNumBytesUsed() % 16 == 0);
+}
+
+BOOST_AUTO_TEST_CASE( ChunkOverflow )
+{
+	CFrameArena arena(256);
+
+	char* a = static_cast<char*>(arena.Alloc(200));
+	BOOST_CHECK(arena.GetNumChunks() == 1);
+
+	// does not fit the remaining 56 bytes, so starts a second chunk
+	char* b = static_cast<char*>(arena.Alloc(100));
+	BOOST_CHECK(arena.GetNumChunks() == 2);
+	BOOST_CHECK(b < a || b >= a + 256);
+
+	memset(a, 1, 200);
+	memset(b, 2, 100);
+	BOOST_CHECK(a[199] == 1);
+	BOOST_CHECK(b[0] == 2);
+}
+
+BOOST_AUTO_TEST_CASE( OversizedRequest )
+{
+	CFrameArena arena(256);
+
+	arena.Alloc(16);
+
+	// larger than a chunk: gets a chunk of its own
+	char* big = static_cast<char*>(arena.Alloc(4096));
+	BOOST_CHECK(IsAligned(big));
+	BOOST_CHECK(arena.GetNumChunks() == 2);
+	memset(big, 3, 4096);
+
+	// and the next small request does not fit behind it
+	arena.Alloc(16);
+	BOOST_CHECK(arena.GetNumChunks() == 3);
+	BOOST_CHECK(arena.GetNumBytesUsed() == (16 + 4096 + 16));
+}
+
+BOOST_AUTO_TEST_CASE( ReuseAfterReset )
+{
+	CFrameArena arena(256);
+	std::vector<void*> ptrs;
+
+	for (int n = 0; n < 10; n++)
+		ptrs.push_back(arena.Alloc(100));
+
+	const size_t numChunks = arena.GetNumChunks();
+
+	arena.Reset();
+	BOOST_CHECK(arena.GetNumBytesUsed() == 0);
+
+	// the same sequence of requests hands out the same memory
+	for (int n = 0; n < 10; n++)
+		BOOST_CHECK(arena.Alloc(100) == ptrs[n]);
+
+	BOOST_CHECK(arena.GetNumChunks() == numChunks);
+}
+
+BOOST_AUTO_TEST_CASE( ResetTrimsChunks )
+{
+	CFrameArena arena(256, 2);
+
+	for (int n = 0; n < 10; n++)
+		arena.Alloc(200);
+
+	BOOST_CHECK(arena.GetNumChunks() == 10);
+
+	// a one-off peak does not stay resident
+	arena.Reset();
+	BOOST_CHECK(arena.GetNumChunks() == 2);
+
+	arena.Alloc(200);
+	arena.Alloc(200);
+	arena.Alloc(200);
+	BOOST_CHECK(arena.GetNumChunks() == 3);
+}
+
+
+static void HeapFallback(bool* ok)
+{
+	// no arena installed on this thread
+	FrameAllocator<int> alloc;
+	std::vector<int, FrameAllocator<int> > v;
+
+	for (int n = 0; n < 1000; n++)
+		v.push_back(n);
+
+	*ok = (alloc.arena == NULL && v.get_allocator().arena == NULL && v[999] == 999);
+}
+
+BOOST_AUTO_TEST_CASE( ThreadArena )
+{
+	CFrameArena arena;
+	CFrameArena::SetThreadArena(&arena);
+
+	{
+		std::vector<int, FrameAllocator<int> > v;
+		v.push_back(1);
+
+		BOOST_CHECK(v.get_allocator().arena == &arena);
+		BOOST_CHECK(arena.GetNumBytesUsed() > 0);
+	}
+
+	bool ok = false;
+	boost::thread t(HeapFallback, &ok);
+	t.join();
+	BOOST_CHECK(ok);
+
+	CFrameArena::SetThreadArena(NULL);
+}
@@ -0,0 +1,175 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/MemPool.h"
+
+#include <boost/thread.hpp>
+#include <cstring>
+#include <vector>
+
+#define BOOST_TEST_MODULE MemPool
+#include <boost/test/unit_test.hpp>
+
+
+BOOST_AUTO_TEST_CASE( SizeClasses )
+{
+	CMemPool pool;
+	CMemPool::Stats stats;
+
+	// every request must fit its block, and blocks must not overlap
+	std::vector<char*> blocks;
+
+	for (size_t numBytes = 1; numBytes <= MAX_MEM_SIZE; numBytes += 7) {
+		char* blk = static_cast<char*>(pool.Alloc(numBytes));
+		memset(blk, int(numBytes & 0xFF), numBytes);
+		blocks.push_back(blk);
+	}
+
+	for (size_t n = 0, numBytes = 1; numBytes <= MAX_MEM_SIZE; numBytes += 7, n++) {
+		BOOST_CHECK(blocks[n][0] == char(numBytes & 0xFF));
+		BOOST_CHECK(blocks[n][numBytes - 1] == char(numBytes & 0xFF));
+		pool.Free(blocks[n], numBytes);
+	}
+
+	pool.GetStats(&stats);
+
+	BOOST_CHECK(stats.liveBytes == 0);
+	BOOST_CHECK(stats.peakBytes >= MAX_MEM_SIZE);
+	BOOST_CHECK(stats.numExternalAllocs == 0);
+	BOOST_CHECK(stats.classes.size() == CMemPool::NUM_SIZE_CLASSES);
+	BOOST_CHECK(stats.classes.back().blockSize == MAX_MEM_SIZE);
+
+	// oversized requests bypass the pool
+	pool.Free(pool.Alloc(MAX_MEM_SIZE + 1), MAX_MEM_SIZE + 1);
+	pool.GetStats(&stats);
+	BOOST_CHECK(stats.numExternalAllocs == 1);
+}
+
+BOOST_AUTO_TEST_CASE( Trim )
+{
+	CMemPool pool;
+	CMemPool::Stats stats;
+
+	std::vector<void*> blocks;
+
+	for (size_t n = 0; n < 10000; n++) {
+		blocks.push_back(pool.Alloc(64));
+	}
+
+	pool.GetStats(&stats);
+	BOOST_CHECK(stats.liveBytes == (10000 * 64));
+	BOOST_CHECK(stats.slabBytes >= stats.liveBytes);
+
+	// keep one block alive, its slab must survive trimming
+	for (size_t n = 1; n < blocks.size(); n++) {
+		pool.Free(blocks[n], 64);
+	}
+
+	const size_t slabBytes = stats.slabBytes;
+	const size_t freedBytes = pool.Trim();
+
+	pool.GetStats(&stats);
+	BOOST_CHECK(freedBytes > 0);
+	BOOST_CHECK(stats.slabBytes == (slabBytes - freedBytes));
+	BOOST_CHECK(stats.slabBytes == CMemPool::SLAB_SIZE);
+	BOOST_CHECK(stats.liveBytes == 64);
+
+	pool.Free(blocks[0], 64);
+	BOOST_CHECK(pool.Trim() == CMemPool::SLAB_SIZE);
+
+	// the pool must still be usable after trimming everything
+	void* blk = pool.Alloc(64);
+	BOOST_CHECK(blk != NULL);
+	pool.Free(blk, 64);
+}
+
+
+// Boost.Test is not threadsafe, workers only count errors
+static std::atomic<int> numCorruptBlocks(0);
+
+static void AllocFreeLoop(unsigned int seed)
+{
+	std::vector< std::pair<unsigned char*, size_t> > blocks;
+
+	for (unsigned int n = 0; n < 20000; n++) {
+		seed = seed * 1103515245 + 12345;
+
+		if (blocks.empty() || (seed & 0x100) != 0) {
+			const size_t numBytes = 1 + ((seed >> 16) % 512);
+			unsigned char* blk = static_cast<unsigned char*>(mempool.Alloc(numBytes));
+
+			memset(blk, numBytes & 0xFF, numBytes);
+			blocks.push_back(std::make_pair(blk, numBytes));
+		} else {
+			const size_t idx = (seed >> 16) % blocks.size();
+			const std::pair<unsigned char*, size_t> b = blocks[idx];
+
+			// corruption would show if two threads got the same block
+			if (b.first[0] != (b.second & 0xFF) || b.first[b.second - 1] != (b.second & 0xFF))
+				numCorruptBlocks++;
+
+			mempool.Free(b.first, b.second);
+			blocks[idx] = blocks.back();
+			blocks.pop_back();
+		}
+	}
+
+	for (size_t n = 0; n < blocks.size(); n++) {
+		mempool.Free(blocks[n].first, blocks[n].second);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( Threads )
+{
+	CMemPool::Stats stats;
+	mempool.GetStats(&stats);
+
+	const size_t liveBytes = stats.liveBytes;
+
+	boost::thread_group threads;
+
+	for (unsigned int n = 0; n < 4; n++) {
+		threads.create_thread(boost::bind(&AllocFreeLoop, n + 1));
+	}
+
+	threads.join_all();
+	mempool.GetStats(&stats);
+
+	size_t numCacheHits = 0;
+
+	for (size_t n = 0; n < stats.classes.size(); n++) {
+		numCacheHits += stats.classes[n].numCacheHits;
+	}
+
+	BOOST_CHECK(numCorruptBlocks == 0);
+	BOOST_CHECK(stats.liveBytes == liveBytes);
+	BOOST_CHECK(numCacheHits > 0);
+}
+
+BOOST_AUTO_TEST_CASE( ThreadExit )
+{
+	CMemPool::Stats stats;
+
+	// release whatever earlier cases left, then measure what is still live
+	mempool.Trim();
+	mempool.GetStats(&stats);
+
+	const size_t liveBytes = stats.liveBytes;
+	const size_t slabBytes = stats.slabBytes;
+
+	boost::thread_group threads;
+
+	for (unsigned int n = 0; n < 4; n++) {
+		threads.create_thread(boost::bind(&AllocFreeLoop, n + 10));
+	}
+
+	threads.join_all();
+
+	// the workers' caches were drained when they exited, so none
+	// of the slabs they allocated can still be pinned by them
+	mempool.Trim();
+	mempool.GetStats(&stats);
+
+	BOOST_CHECK(stats.liveBytes == liveBytes);
+	BOOST_CHECK(stats.slabBytes == slabBytes);
+}
+
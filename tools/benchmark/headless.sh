@@ -0,0 +1,25 @@
+#!/bin/bash
+
+# Runs the built-in benchmark scenarios with spring-headless and collects
+# their benchmark.json files, no GPU or demo needed.
+# Usage: ./headless.sh [path/to/spring-headless] [minutes]
+
+set -e
+
+SPRING=${1:-./spring-headless}
+MINUTES=${2:-2}
+
+SCRIPT="script_benchmark_headless.txt"
+SCENARIOS="masspathing artillery losstress factories"
+
+PREFIX=$PWD/bench_headless_$(date +"%Y-%m-%d_%H-%M-%S")
+
+mkdir "$PREFIX"
+
+for SCENARIO in $SCENARIOS; do
+	echo Running $SCENARIO
+	rm -f benchmark.json
+	"$SPRING" --benchmark $MINUTES --benchmark-scenario $SCENARIO "$SCRIPT" >"$PREFIX/$SCENARIO.log" 2>&1
+	mv benchmark.json "$PREFIX/$SCENARIO.json"
+	mv benchmark.data "$PREFIX/$SCENARIO.data"
+done
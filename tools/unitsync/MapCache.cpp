@@ -0,0 +1,285 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "MapCache.h"
+#include "unitsync.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+#include "System/FileSystem/ArchiveScanner.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/Log/ILog.h"
+#include "System/Util.h"
+
+
+// bump this whenever the layout of an entry changes
+static const boost::uint32_t CACHE_MAGIC   = 0x434D5355; // "USMC"
+static const boost::uint32_t CACHE_VERSION = 1;
+
+namespace {
+	struct EntryHeader {
+		boost::uint32_t magic;
+		boost::uint32_t version;
+		boost::uint32_t checksum;
+		boost::uint32_t size;
+	};
+
+	class CEntryWriter {
+	public:
+		CEntryWriter(std::vector<boost::uint8_t>& buf): buffer(buf) {}
+
+		template<typename T> void Write(const T& value) {
+			const boost::uint8_t* p = reinterpret_cast<const boost::uint8_t*>(&value);
+			buffer.insert(buffer.end(), p, p + sizeof(T));
+		}
+		void Write(const std::string& s) {
+			Write(boost::uint32_t(s.size()));
+			buffer.insert(buffer.end(), s.begin(), s.end());
+		}
+		void Write(const std::vector<float>& v) {
+			Write(boost::uint32_t(v.size()));
+			for (size_t n = 0; n < v.size(); n++) {
+				Write(v[n]);
+			}
+		}
+
+	private:
+		std::vector<boost::uint8_t>& buffer;
+	};
+
+	class CEntryReader {
+	public:
+		CEntryReader(const std::vector<boost::uint8_t>& buf): buffer(buf), pos(0), ok(true) {}
+
+		bool IsOk() const { return ok; }
+
+		template<typename T> void Read(T& value) {
+			if (!(ok = ok && (pos + sizeof(T) <= buffer.size())))
+				return;
+
+			memcpy(&value, &buffer[pos], sizeof(T));
+			pos += sizeof(T);
+		}
+		void Read(std::string& s) {
+			boost::uint32_t size = 0;
+			Read(size);
+
+			if (!(ok = ok && (pos + size <= buffer.size())))
+				return;
+
+			s.assign(buffer.begin() + pos, buffer.begin() + pos + size);
+			pos += size;
+		}
+		void Read(std::vector<float>& v) {
+			boost::uint32_t size = 0;
+			Read(size);
+
+			if (!(ok = ok && (pos + size * sizeof(float) <= buffer.size())))
+				return;
+
+			v.resize(size);
+			for (size_t n = 0; n < v.size(); n++) {
+				Read(v[n]);
+			}
+		}
+
+	private:
+		const std::vector<boost::uint8_t>& buffer;
+		size_t pos;
+		bool ok;
+	};
+}
+
+
+
+CMapCache::CMapCache(const std::string& mapName)
+	: checksum(archiveScanner->GetArchiveCompleteChecksum(mapName))
+{
+	static const std::string baseDir = dataDirsAccess.LocateDir(FileSystem::GetCacheDir() + "/unitsync/maps/", FileQueryFlags::WRITE | FileQueryFlags::CREATE_DIRS);
+
+	// without a checksum entries could not be told apart from stale ones
+	if (checksum != 0)
+		cacheDir = baseDir;
+}
+
+
+bool CMapCache::ReadInfo(InternalMapInfo* info) const
+{
+	std::vector<boost::uint8_t> buffer;
+
+	if (!ReadEntry("info", buffer))
+		return false;
+
+	CEntryReader reader(buffer);
+	InternalMapInfo cached;
+
+	reader.Read(cached.description);
+	reader.Read(cached.author);
+	reader.Read(cached.tidalStrength);
+	reader.Read(cached.gravity);
+	reader.Read(cached.maxMetal);
+	reader.Read(cached.extractorRadius);
+	reader.Read(cached.minWind);
+	reader.Read(cached.maxWind);
+	reader.Read(cached.width);
+	reader.Read(cached.height);
+	reader.Read(cached.xPos);
+	reader.Read(cached.zPos);
+
+	if (!reader.IsOk() || cached.xPos.size() != cached.zPos.size())
+		return false;
+
+	*info = cached;
+	return true;
+}
+
+void CMapCache::WriteInfo(const InternalMapInfo& info) const
+{
+	std::vector<boost::uint8_t> buffer;
+	CEntryWriter writer(buffer);
+
+	writer.Write(info.description);
+	writer.Write(info.author);
+	writer.Write(info.tidalStrength);
+	writer.Write(info.gravity);
+	writer.Write(info.maxMetal);
+	writer.Write(info.extractorRadius);
+	writer.Write(info.minWind);
+	writer.Write(info.maxWind);
+	writer.Write(info.width);
+	writer.Write(info.height);
+	writer.Write(info.xPos);
+	writer.Write(info.zPos);
+
+	WriteEntry("info", buffer);
+}
+
+
+bool CMapCache::ReadMinimap(int mipLevel, unsigned short* colors) const
+{
+	const size_t mipSize = 1024 >> mipLevel;
+	std::vector<boost::uint8_t> buffer;
+
+	if (!ReadEntry("minimap" + IntToString(mipLevel), buffer))
+		return false;
+	if (buffer.size() != (mipSize * mipSize * sizeof(unsigned short)))
+		return false;
+
+	memcpy(colors, &buffer[0], buffer.size());
+	return true;
+}
+
+void CMapCache::WriteMinimap(int mipLevel, const unsigned short* colors) const
+{
+	const size_t mipSize = 1024 >> mipLevel;
+	const boost::uint8_t* data = reinterpret_cast<const boost::uint8_t*>(colors);
+
+	WriteEntry("minimap" + IntToString(mipLevel), std::vector<boost::uint8_t>(data, data + mipSize * mipSize * sizeof(unsigned short)));
+}
+
+
+bool CMapCache::ReadInfoMap(const std::string& name, int* width, int* height, std::vector<boost::uint8_t>* data) const
+{
+	std::vector<boost::uint8_t> buffer;
+	boost::int32_t size[2] = {0, 0};
+
+	// the size is stored in front of the pixels
+	if (!ReadEntry("infomap_" + name, buffer, (data == NULL)? sizeof(size): size_t(-1)))
+		return false;
+	if (buffer.size() < sizeof(size))
+		return false;
+
+	memcpy(size, &buffer[0], sizeof(size));
+
+	if (data != NULL)
+		data->assign(buffer.begin() + sizeof(size), buffer.end());
+
+	*width = size[0];
+	*height = size[1];
+	return true;
+}
+
+void CMapCache::WriteInfoMap(const std::string& name, int width, int height, const std::vector<boost::uint8_t>& data) const
+{
+	std::vector<boost::uint8_t> buffer;
+	CEntryWriter writer(buffer);
+
+	writer.Write(boost::int32_t(width));
+	writer.Write(boost::int32_t(height));
+	buffer.insert(buffer.end(), data.begin(), data.end());
+
+	WriteEntry("infomap_" + name, buffer);
+}
+
+
+std::string CMapCache::GetFileName(const std::string& key) const
+{
+	char checksumHex[16];
+	SNPRINTF(checksumHex, sizeof(checksumHex), "%08x", checksum);
+
+	return (cacheDir + checksumHex + "_" + key + ".bin");
+}
+
+
+bool CMapCache::ReadEntry(const std::string& key, std::vector<boost::uint8_t>& data, size_t maxSize) const
+{
+	if (cacheDir.empty())
+		return false;
+
+	FILE* file = fopen(GetFileName(key).c_str(), "rb");
+
+	if (file == NULL)
+		return false;
+
+	EntryHeader header;
+	bool ok = (fread(&header, sizeof(header), 1, file) == 1);
+
+	ok = ok && (header.magic == CACHE_MAGIC);
+	ok = ok && (header.version == CACHE_VERSION);
+	ok = ok && (header.checksum == checksum);
+
+	// reject entries that were cut short while being written
+	ok = ok && (fseek(file, 0, SEEK_END) == 0);
+	ok = ok && (ftell(file) == long(sizeof(header) + header.size));
+	ok = ok && (fseek(file, sizeof(header), SEEK_SET) == 0);
+
+	if (ok) {
+		data.resize(std::min(size_t(header.size), maxSize));
+		ok = data.empty() || (fread(&data[0], data.size(), 1, file) == 1);
+	}
+
+	fclose(file);
+	return ok;
+}
+
+void CMapCache::WriteEntry(const std::string& key, const std::vector<boost::uint8_t>& data) const
+{
+	if (cacheDir.empty())
+		return;
+
+	const std::string fileName = GetFileName(key);
+	FILE* file = fopen(fileName.c_str(), "wb");
+
+	if (file == NULL) {
+		LOG_L(L_WARNING, "[MapCache::%s] failed to open \"%s\" for writing", __FUNCTION__, fileName.c_str());
+		return;
+	}
+
+	EntryHeader header;
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	header.checksum = checksum;
+	header.size = data.size();
+
+	bool ok = (fwrite(&header, sizeof(header), 1, file) == 1);
+	ok = ok && (data.empty() || fwrite(&data[0], data.size(), 1, file) == 1);
+	ok = (fclose(file) == 0) && ok;
+
+	if (!ok) {
+		LOG_L(L_WARNING, "[MapCache::%s] failed to write \"%s\"", __FUNCTION__, fileName.c_str());
+		FileSystem::Remove(fileName);
+	}
+}
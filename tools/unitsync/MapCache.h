@@ -0,0 +1,47 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _MAP_CACHE_H
+#define _MAP_CACHE_H
+
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+struct InternalMapInfo;
+
+/**
+ * On-disk cache of the data lobbies query per map: the meta-data,
+ * the decoded minimap mip levels and the info maps (height, metal, ...).
+ * Entries are keyed by the complete checksum of the map archive, so an
+ * updated map gets new entries instead of stale ones.
+ * Every function fails silently (returns false) when the cache is not
+ * usable, callers then read the map itself.
+ */
+class CMapCache
+{
+public:
+	CMapCache(const std::string& mapName);
+
+	bool ReadInfo(InternalMapInfo* info) const;
+	void WriteInfo(const InternalMapInfo& info) const;
+
+	/// <colors> receives (1024 >> mipLevel)^2 RGB565 pixels
+	bool ReadMinimap(int mipLevel, unsigned short* colors) const;
+	void WriteMinimap(int mipLevel, const unsigned short* colors) const;
+
+	/// <data> may be NULL if only the size is wanted
+	bool ReadInfoMap(const std::string& name, int* width, int* height, std::vector<boost::uint8_t>* data) const;
+	void WriteInfoMap(const std::string& name, int width, int height, const std::vector<boost::uint8_t>& data) const;
+
+private:
+	std::string GetFileName(const std::string& key) const;
+
+	bool ReadEntry(const std::string& key, std::vector<boost::uint8_t>& data, size_t maxSize = size_t(-1)) const;
+	void WriteEntry(const std::string& key, const std::vector<boost::uint8_t>& data) const;
+
+private:
+	std::string cacheDir;
+	unsigned int checksum;
+};
+
+#endif // _MAP_CACHE_H
@@ -2,6 +2,7 @@
 
 #include "unitsync.h"
 #include "unitsync_api.h"
+#include "MapCache.h"
 
 #include <algorithm>
 #include <string>
@@ -562,25 +563,6 @@ static void safe_strzcpy(char* dst, std::string src, size_t max)
 }
 
 
-/**
- * @brief map related meta-data
- */
-struct InternalMapInfo
-{
-	std::string description;  ///< Description (max 255 chars)
-	std::string author;       ///< Creator of the map (max 200 chars)
-	int tidalStrength;        ///< Tidal strength
-	int gravity;              ///< Gravity
-	float maxMetal;           ///< Metal scale factor
-	int extractorRadius;      ///< Extractor radius (of metal extractors)
-	int minWind;              ///< Minimum wind speed
-	int maxWind;              ///< Maximum wind speed
-	int width;                ///< Width of the map
-	int height;               ///< Height of the map
-	std::vector<float> xPos;  ///< Start positions X coordinates defined by the map
-	std::vector<float> zPos;  ///< Start positions Z coordinates defined by the map
-};
-
 static bool internal_GetMapInfo(const char* mapName, InternalMapInfo* outInfo)
 {
 	CheckInit();
@@ -589,6 +571,11 @@ static bool internal_GetMapInfo(const char* mapName, InternalMapInfo* outInfo)
 
 	LOG_L(L_DEBUG, "get map info: %s", mapName);
 
+	const CMapCache mapCache(mapName);
+
+	if (mapCache.ReadInfo(outInfo))
+		return true;
+
 	const std::string mapFile = GetMapFile(mapName);
 
 	ScopedMapLoader mapLoader(mapName, mapFile);
@@ -662,6 +649,7 @@ static bool internal_GetMapInfo(const char* mapName, InternalMapInfo* outInfo)
 		LOG_L(L_DEBUG, "startpos: %.0f, %.0f", pos.x, pos.z);
 	}
 
+	mapCache.WriteInfo(*outInfo);
 	return true;
 }
 
@@ -796,24 +784,27 @@ EXPORT(const char*) GetMapFileName(int index)
 }
 
 
-static std::map<int, InternalMapInfo> mapInfos;
+// keyed by name, the indices change when GetMapCount finds new maps
+static std::map<std::string, InternalMapInfo> mapInfos;
 
 static InternalMapInfo* internal_getMapInfo(int index) {
 
 	if (index >= mapNames.size()) {
 		SetLastError("invalid map index");
 	} else {
-		if (mapInfos.find(index) == mapInfos.end()) {
+		const std::string& mapName = mapNames[index];
+
+		if (mapInfos.find(mapName) == mapInfos.end()) {
 			try {
 				InternalMapInfo imi;
-				if (internal_GetMapInfo(mapNames[index].c_str(), &imi)) {
-					mapInfos[index] = imi;
-					return &(mapInfos[index]);
+				if (internal_GetMapInfo(mapName.c_str(), &imi)) {
+					mapInfos[mapName] = imi;
+					return &(mapInfos[mapName]);
 				}
 			}
 			UNITSYNC_CATCH_BLOCKS;
 		} else {
-			return &(mapInfos[index]);
+			return &(mapInfos[mapName]);
 		}
 	}
 
@@ -822,10 +813,19 @@ static InternalMapInfo* internal_getMapInfo(int index) {
 
 static void internal_deleteMapInfos() {
 
-	while (!mapInfos.empty()) {
-		std::map<int, InternalMapInfo>::iterator mi = mapInfos.begin();
-		mapInfos.erase(mi);
+	mapInfos.clear();
+}
+
+EXPORT(int) GetMapCountWithInfo()
+{
+	const int count = GetMapCount();
+
+	// maps that fail to load just have no entry, like with the single calls
+	for (int index = 0; index < count; ++index) {
+		internal_getMapInfo(index);
 	}
+
+	return count;
 }
 
 EXPORT(const char*) GetMapDescription(int index) {
@@ -1215,12 +1215,18 @@ EXPORT(unsigned short*) GetMinimap(const char* mapName, int mipLevel)
 			throw std::out_of_range("Miplevel must be between 0 and 8 (inclusive) in GetMinimap.");
 
 		const std::string mapFile = GetMapFile(mapName);
+		const std::string extension = FileSystem::GetExtension(mapFile);
+		const CMapCache mapCache(mapName);
+
+		if (extension == "smf" && mapCache.ReadMinimap(mipLevel, imgbuf))
+			return imgbuf;
+
 		ScopedMapLoader mapLoader(mapName, mapFile);
 
 		unsigned short* ret = NULL;
-		const std::string extension = FileSystem::GetExtension(mapFile);
 		if (extension == "smf") {
 			ret = GetMinimapSMF(mapFile, mipLevel);
+			mapCache.WriteMinimap(mipLevel, ret);
 		} else if (extension == "sm3") {
 			ret = GetMinimapSM3(mapFile, mipLevel);
 		}
@@ -1232,6 +1238,37 @@ EXPORT(unsigned short*) GetMinimap(const char* mapName, int mipLevel)
 }
 
 
+/// reads an info map in its native format, from the map cache if possible
+static bool internal_GetInfoMap(const char* mapName, const std::string& name, int* width, int* height, std::vector<uint8_t>& data)
+{
+	const CMapCache mapCache(mapName);
+
+	if (mapCache.ReadInfoMap(name, width, height, &data))
+		return true;
+
+	const std::string mapFile = GetMapFile(mapName);
+	ScopedMapLoader mapLoader(mapName, mapFile);
+	CSMFMapFile file(mapFile);
+	MapBitmapInfo bmInfo;
+
+	file.GetInfoMapSize(name, &bmInfo);
+
+	*width = bmInfo.width;
+	*height = bmInfo.height;
+
+	const int pixelSize = (name == "height")? sizeof(unsigned short): sizeof(unsigned char);
+
+	data.clear();
+	data.resize(bmInfo.width * bmInfo.height * pixelSize, 0);
+
+	// unknown names have no size and fail here
+	if (!file.ReadInfoMap(name, data.empty()? NULL: &data[0]))
+		return false;
+
+	mapCache.WriteInfoMap(name, bmInfo.width, bmInfo.height, data);
+	return true;
+}
+
 EXPORT(int) GetInfoMapSize(const char* mapName, const char* name, int* width, int* height)
 {
 	try {
@@ -1241,17 +1278,15 @@ EXPORT(int) GetInfoMapSize(const char* mapName, const char* name, int* width, in
 		CheckNull(width);
 		CheckNull(height);
 
-		const std::string mapFile = GetMapFile(mapName);
-		ScopedMapLoader mapLoader(mapName, mapFile);
-		CSMFMapFile file(mapFile);
-		MapBitmapInfo bmInfo;
-
-		file.GetInfoMapSize(name, &bmInfo);
+		const CMapCache mapCache(mapName);
 
-		*width = bmInfo.width;
-		*height = bmInfo.height;
+		if (!mapCache.ReadInfoMap(name, width, height, NULL)) {
+			// read (and cache) the whole map, it is usually wanted next
+			std::vector<uint8_t> data;
+			internal_GetInfoMap(mapName, name, width, height, data);
+		}
 
-		return bmInfo.width * bmInfo.height;
+		return (*width) * (*height);
 	}
 	UNITSYNC_CATCH_BLOCKS;
 
@@ -1272,33 +1307,28 @@ EXPORT(int) GetInfoMap(const char* mapName, const char* name, unsigned char* dat
 		CheckNullOrEmpty(name);
 		CheckNull(data);
 
-		const std::string mapFile = GetMapFile(mapName);
-		ScopedMapLoader mapLoader(mapName, mapFile);
-		CSMFMapFile file(mapFile);
-
 		const std::string n = name;
 		int actualType = (n == "height" ? bm_grayscale_16 : bm_grayscale_8);
 
+		int width = 0;
+		int height = 0;
+		std::vector<uint8_t> infoMap;
+
 		if (actualType == typeHint) {
-			ret = file.ReadInfoMap(n, data);
+			ret = internal_GetInfoMap(mapName, n, &width, &height, infoMap);
+
+			if (ret && !infoMap.empty())
+				std::memcpy(data, &infoMap[0], infoMap.size());
 		} else if (actualType == bm_grayscale_16 && typeHint == bm_grayscale_8) {
 			// convert from 16 bits per pixel to 8 bits per pixel
-			MapBitmapInfo bmInfo;
-			file.GetInfoMapSize(name, &bmInfo);
-
-			const int size = bmInfo.width * bmInfo.height;
-			if (size > 0) {
-				unsigned short* temp = new unsigned short[size];
-				if (file.ReadInfoMap(n, temp)) {
-					const unsigned short* inp = temp;
-					const unsigned short* inp_end = temp + size;
-					unsigned char* outp = data;
-					for (; inp < inp_end; ++inp, ++outp) {
-						*outp = *inp >> 8;
-					}
-					ret = 1;
+			if (internal_GetInfoMap(mapName, n, &width, &height, infoMap) && !infoMap.empty()) {
+				const unsigned short* inp = reinterpret_cast<const unsigned short*>(&infoMap[0]);
+				const unsigned short* inp_end = inp + width * height;
+				unsigned char* outp = data;
+				for (; inp < inp_end; ++inp, ++outp) {
+					*outp = *inp >> 8;
 				}
-				delete[] temp;
+				ret = 1;
 			}
 		} else if (actualType == bm_grayscale_8 && typeHint == bm_grayscale_16) {
 			throw content_error("converting from 8 bits per pixel to 16 bits per pixel is unsupported");
@@ -262,6 +262,19 @@ EXPORT(const char* ) GetArchivePath(const char* archiveName);
  *		@endcode
  */
 EXPORT(int         ) GetMapCount();
+/**
+ * @brief Get the number of maps available, and read the meta-data of all of them
+ * @return negative integer (< 0) on error;
+ *   the number of maps available (>= 0) on success
+ * @see GetMapCount
+ *
+ * Like GetMapCount, but additionally reads description, author, size, wind,
+ * start positions etc. of every map in one go, so the GetMap*(index) functions
+ * afterwards only return what was already read.
+ * Map meta-data, minimaps and infomaps are cached on disk (keyed by the map
+ * checksum), so after the first run this needs not open the map files.
+ */
+EXPORT(int         ) GetMapCountWithInfo();
 /**
  * @brief Get the name of a map
  * @return NULL on error; the name of the map (e.g. "SmallDivide") on success